@@ -0,0 +1,46 @@
+#.rst:
+# FindLibUring
+# ------------
+# Finds the liburing library
+#
+# This will define the following variables::
+#
+# LIBURING_FOUND - system has liburing
+# LIBURING_INCLUDE_DIRS - the liburing include directory
+# LIBURING_LIBRARIES - the liburing libraries
+# LIBURING_DEFINITIONS - the liburing definitions
+#
+# and the following imported targets::
+#
+#   LIBURING::LIBURING   - The liburing library
+
+if(PKG_CONFIG_FOUND)
+  pkg_check_modules(PC_LIBURING liburing>=0.6 QUIET)
+endif()
+
+find_path(LIBURING_INCLUDE_DIR NAMES liburing.h
+                               PATHS ${PC_LIBURING_INCLUDEDIR})
+find_library(LIBURING_LIBRARY NAMES uring
+                              PATHS ${PC_LIBURING_LIBDIR})
+
+set(LIBURING_VERSION ${PC_LIBURING_VERSION})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LibUring
+                                  REQUIRED_VARS LIBURING_LIBRARY LIBURING_INCLUDE_DIR
+                                  VERSION_VAR LIBURING_VERSION)
+
+if(LIBURING_FOUND)
+  set(LIBURING_LIBRARIES ${LIBURING_LIBRARY})
+  set(LIBURING_INCLUDE_DIRS ${LIBURING_INCLUDE_DIR})
+  set(LIBURING_DEFINITIONS -DHAS_IO_URING=1)
+
+  if(NOT TARGET LIBURING::LIBURING)
+    add_library(LIBURING::LIBURING UNKNOWN IMPORTED)
+    set_target_properties(LIBURING::LIBURING PROPERTIES
+                                   IMPORTED_LOCATION "${LIBURING_LIBRARY}"
+                                   INTERFACE_INCLUDE_DIRECTORIES "${LIBURING_INCLUDE_DIR}")
+  endif()
+endif()
+
+mark_as_advanced(LIBURING_INCLUDE_DIR LIBURING_LIBRARY)
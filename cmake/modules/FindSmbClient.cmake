@@ -38,12 +38,23 @@ if(SMBCLIENT_FOUND)
   set(SMBCLIENT_INCLUDE_DIRS ${SMBCLIENT_INCLUDE_DIR})
   set(SMBCLIENT_DEFINITIONS -DHAS_FILESYSTEM_SMB=1)
 
+  # listing with stat info in one call, samba 4.12 and later
+  include(CheckSymbolExists)
+  set(CMAKE_REQUIRED_INCLUDES ${SMBCLIENT_INCLUDE_DIR})
+  set(CMAKE_REQUIRED_LIBRARIES ${SMBCLIENT_LIBRARIES})
+  check_symbol_exists(smbc_readdirplus2 libsmbclient.h HAVE_SMBC_READDIRPLUS2)
+  unset(CMAKE_REQUIRED_INCLUDES)
+  unset(CMAKE_REQUIRED_LIBRARIES)
+  if(HAVE_SMBC_READDIRPLUS2)
+    list(APPEND SMBCLIENT_DEFINITIONS -DHAS_SMBC_READDIRPLUS2=1)
+  endif()
+
   if(NOT TARGET SmbClient::SmbClient)
     add_library(SmbClient::SmbClient UNKNOWN IMPORTED)
     set_target_properties(SmbClient::SmbClient PROPERTIES
                                    IMPORTED_LOCATION "${SMBCLIENT_LIBRARY}"
                                    INTERFACE_INCLUDE_DIRECTORIES "${SMBCLIENT_INCLUDE_DIR}"
-                                   INTERFACE_COMPILE_DEFINITIONS HAS_FILESYSTEM_SMB=1)
+                                   INTERFACE_COMPILE_DEFINITIONS "${SMBCLIENT_DEFINITIONS}")
   endif()
 endif()
 
@@ -1,5 +1,5 @@
 list(APPEND PLATFORM_REQUIRED_DEPS WaylandProtocols>=1.7 Waylandpp>=0.2.2 LibDRM Xkbcommon>=0.4.1)
-list(APPEND PLATFORM_OPTIONAL_DEPS VAAPI)
+list(APPEND PLATFORM_OPTIONAL_DEPS VAAPI LibUring)
 
 if(APP_RENDER_SYSTEM STREQUAL "gl")
   list(APPEND PLATFORM_REQUIRED_DEPS OpenGl EGL)
@@ -1,5 +1,5 @@
 list(APPEND PLATFORM_REQUIRED_DEPS EGL X XRandR LibDRM)
-list(APPEND PLATFORM_OPTIONAL_DEPS VAAPI)
+list(APPEND PLATFORM_OPTIONAL_DEPS VAAPI LibUring)
 
 if(APP_RENDER_SYSTEM STREQUAL "gl")
   list(APPEND PLATFORM_REQUIRED_DEPS OpenGl)
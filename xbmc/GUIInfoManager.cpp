@@ -924,6 +924,15 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 ///     @skinning_v17 **[New Infolabel]** \link Player_Process_videodecoder `Player.Process(videodecoder)`\endlink
 ///     <p>
 ///   }
+///   \table_row3{   <b>`Player.Process(videodecoderthreading)`</b>,
+///                  \anchor Player_Process_videodecoderthreading
+///                  _string_,
+///     @return The threading the software videodecoder of the currently playing video
+///     runs with, e.g. frame threads and their number, or none.
+///     <p><hr>
+///     @skinning_v20 **[New Infolabel]** \link Player_Process_videodecoderthreading `Player.Process(videodecoderthreading)`\endlink
+///     <p>
+///   }
 ///   \table_row3{   <b>`Player.Process(deintmethod)`</b>,
 ///                  \anchor Player_Process_deintmethod
 ///                  _string_,
@@ -1004,6 +1013,24 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 ///     @skinning_v17 **[New Infolabel]** \link Player_Process_audiobitspersample `Player.Process(audiobitspersample)`\endlink
 ///     <p>
 ///   }
+///   \table_row3{   <b>`Player.Process(videoqueue)`</b>,
+///                  \anchor Player_Process_videoqueue
+///                  _string_,
+///     @return The size and duration the video queue of the player holds, and the
+///     bitrate of the stream it was sized for.
+///     <p><hr>
+///     @skinning_v20 **[New Infolabel]** \link Player_Process_videoqueue `Player.Process(videoqueue)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(audioqueue)`</b>,
+///                  \anchor Player_Process_audioqueue
+///                  _string_,
+///     @return The size and duration the audio queue of the player holds, and the
+///     bitrate of the stream it was sized for.
+///     <p><hr>
+///     @skinning_v20 **[New Infolabel]** \link Player_Process_audioqueue `Player.Process(audioqueue)`\endlink
+///     <p>
+///   }
 /// \table_end
 ///
 /// -----------------------------------------------------------------------------
@@ -1011,6 +1038,7 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 const infomap player_process[] =
 {
   { "videodecoder", PLAYER_PROCESS_VIDEODECODER },
+  { "videodecoderthreading", PLAYER_PROCESS_VIDEODECODERTHREADING },
   { "deintmethod", PLAYER_PROCESS_DEINTMETHOD },
   { "pixformat", PLAYER_PROCESS_PIXELFORMAT },
   { "videowidth", PLAYER_PROCESS_VIDEOWIDTH },
@@ -1021,7 +1049,9 @@ const infomap player_process[] =
   { "audiodecoder", PLAYER_PROCESS_AUDIODECODER },
   { "audiochannels", PLAYER_PROCESS_AUDIOCHANNELS },
   { "audiosamplerate", PLAYER_PROCESS_AUDIOSAMPLERATE },
-  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE }
+  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE },
+  { "videoqueue", PLAYER_PROCESS_VIDEOQUEUE },
+  { "audioqueue", PLAYER_PROCESS_AUDIOQUEUE }
 };
 
 /// \page modules__infolabels_boolean_conditions
@@ -8,12 +8,21 @@
 
 #include "InfoScanner.h"
 
+#include "ServiceBroker.h"
 #include "URL.h"
 #include "Util.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryWalker.h"
 #include "filesystem/File.h"
+#include "filesystem/IDirectory.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+CInfoScanner::~CInfoScanner() = default;
+
 bool CInfoScanner::HasNoMedia(const std::string &strDirectory) const
 {
   std::string noMediaFile = URIUtils::AddFileToFolder(strDirectory, ".nomedia");
@@ -29,3 +38,51 @@ bool CInfoScanner::HasNoMedia(const std::string &strDirectory) const
 
   return false;
 }
+
+int CInfoScanner::GetDirectoryFlags()
+{
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bPersistentDirectoryCache)
+    return XFILE::DIR_FLAG_PERSISTENT_CACHE;
+
+  return XFILE::DIR_FLAG_DEFAULTS;
+}
+
+void CInfoScanner::StartWalker(const std::string& mask,
+                               const std::vector<std::string>& excludes,
+                               bool recursive)
+{
+  const auto& advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  if (advancedSettings->m_libraryScanThreads > 0)
+    m_walker.reset(new XFILE::CDirectoryWalker(mask, GetDirectoryFlags(), excludes, recursive,
+                                               advancedSettings->m_libraryScanThreads,
+                                               advancedSettings->m_libraryScanHostConnections));
+  else
+    m_walker.reset();
+}
+
+void CInfoScanner::StopWalker()
+{
+  m_walker.reset();
+}
+
+void CInfoScanner::WalkDirectory(const std::string& strDirectory)
+{
+  if (m_walker)
+    m_walker->Walk(strDirectory);
+}
+
+void CInfoScanner::FinishDirectory(const std::string& strDirectory)
+{
+  if (m_walker)
+    m_walker->Finished(strDirectory);
+}
+
+bool CInfoScanner::GetScanDirectory(const std::string& strDirectory,
+                                    CFileItemList& items,
+                                    const std::string& mask)
+{
+  if (m_walker)
+    return m_walker->GetDirectory(strDirectory, items);
+
+  return XFILE::CDirectory::GetDirectory(strDirectory, items, mask, GetDirectoryFlags());
+}
@@ -8,12 +8,19 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+class CFileItemList;
 class CGUIDialogProgressBarHandle;
 
+namespace XFILE
+{
+class CDirectoryWalker;
+}
+
 class CInfoScanner
 {
 public:
@@ -45,8 +52,7 @@ public:
     TITLE_NFO    = 6  //!< At least Title was read (and optionally the Year)
   };
 
-  //! \brief Empty destructor.
-  virtual ~CInfoScanner() = default;
+  virtual ~CInfoScanner();
 
   virtual bool DoScan(const std::string& strDirectory) = 0;
 
@@ -66,10 +72,43 @@ protected:
   //! \brief Protected constructor to only allow subclass instances.
   CInfoScanner() = default;
 
+  /*! \brief Directory flags for listing the folders being scanned
+   Folders that didn't change since the last scan are listed from the
+   persistent directory cache, unless disabled in advancedsettings.
+   */
+  static int GetDirectoryFlags();
+
+  /*! \brief Prepare listing folders ahead of the scan on several threads
+   Without <libraryscanthreads> folders are listed when they're scanned.
+   \param mask file mask the folders are listed with
+   \param excludes regular expressions of folders that are never scanned
+   \param recursive list the tree below the walked paths too, only for
+   scanners that list every folder they descend into
+   */
+  void StartWalker(const std::string& mask,
+                   const std::vector<std::string>& excludes,
+                   bool recursive);
+  void StopWalker();
+  bool IsWalking() const { return m_walker != nullptr; }
+
+  /*! \brief Start listing the path ahead of the scan, and the folders below it if recursive */
+  void WalkDirectory(const std::string& strDirectory);
+
+  /*! \brief The scan of the folders below the path is done */
+  void FinishDirectory(const std::string& strDirectory);
+
+  /*! \brief List a folder that is being scanned
+   \param mask must be the mask given to StartWalker()
+   */
+  bool GetScanDirectory(const std::string& strDirectory,
+                        CFileItemList& items,
+                        const std::string& mask);
+
   std::set<std::string> m_pathsToScan; //!< Set of paths to scan
   bool m_showDialog = false; //!< Whether or not to show progress bar dialog
   CGUIDialogProgressBarHandle* m_handle = nullptr; //!< Progress bar handle
   bool m_bRunning = false; //!< Whether or not scanner is running
   bool m_bCanInterrupt = false; //!< Whether or not scanner is currently interruptable
   bool m_bClean = false; //!< Whether or not to perform cleaning during scanning
+  std::unique_ptr<XFILE::CDirectoryWalker> m_walker; //!< Lists folders ahead of the scan
 };
@@ -225,7 +225,7 @@ std::string CTextureCacheJob::GetImageHash(const std::string &url)
     return "";
 
   struct __stat64 st;
-  if (XFILE::CFile::Stat(url, &st) == 0)
+  if (XFILE::CFile::Stat(url, &st, true) == 0)
   {
     int64_t time = st.st_mtime;
     if (!time)
@@ -397,6 +397,8 @@ int CVFSEntry::IoControl(void* ctx, XFILE::EIoControl request, void* param)
         kodiData->maxrate = status.maxrate;
         kodiData->currate = status.currate;
         kodiData->lowspeed = status.lowspeed;
+        kodiData->connections = 1;
+        kodiData->conrate[0] = status.currate;
       }
       return ret;
     }
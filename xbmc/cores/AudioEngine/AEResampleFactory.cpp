@@ -8,12 +8,15 @@
 
 #include "AEResampleFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePolyphase.h"
 
 namespace ActiveAE
 {
 
 IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */)
 {
+  if (flags & AERESAMPLEFACTORY_POLYPHASE)
+    return new CActiveAEResamplePolyphase();
   return new CActiveAEResampleFFMPEG();
 }
 
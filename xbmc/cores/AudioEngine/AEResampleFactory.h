@@ -21,7 +21,18 @@ namespace ActiveAE
 enum AEResampleFactoryOptions
 {
   /* This is a quick resample job (e.g. resample a single noise packet) and may not be worth using GPU acceleration */
-  AERESAMPLEFACTORY_QUICK_RESAMPLE = 0x01
+  AERESAMPLEFACTORY_QUICK_RESAMPLE = 0x01,
+  /* Use the polyphase resampler of ActiveAE instead of swresample */
+  AERESAMPLEFACTORY_POLYPHASE = 0x02
+};
+
+/**
+ * Resamplers to choose from in the settings
+ */
+enum AEResampler
+{
+  AE_RESAMPLER_FFMPEG = 0,
+  AE_RESAMPLER_POLYPHASE = 1
 };
 
 class CAEResampleFactory
@@ -26,36 +26,53 @@ using namespace ActiveAE;
 #include "windowing/WinSystem.h"
 #include "utils/log.h"
 
+#include <chrono>
+
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
 
+// low latency streams, e.g. of games, stay that close to the sink
+#define LOW_LATENCY_CACHE_LEVEL 0.05
+#define LOW_LATENCY_WATER_LEVEL 0.03
+#define LOW_LATENCY_BUFFER_TIME 0.01
+
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
   CSingleLock lock(m_lock);
+  m_delaySection.enter();
   m_sinkDelay.SetDelay(0.0);
   m_sinkSampleRate = sampleRate;
   m_bufferedSamples = 0;
-  m_suspended = false;
   m_pcmOutput = pcm;
+  m_delaySection.leave();
+  m_suspended = false;
 }
 
 void CEngineStats::UpdateSinkDelay(const AEDelayStatus& status, int samples)
 {
   CSingleLock lock(m_lock);
+  m_delaySection.enter();
   m_sinkDelay = status;
-  if (samples > m_bufferedSamples)
+  bool inconsistent = samples > m_bufferedSamples;
+  if (!inconsistent)
+    m_bufferedSamples -= samples;
+  m_delaySection.leave();
+
+  if (inconsistent)
   {
     CLog::Log(LOGERROR, "CEngineStats::UpdateSinkDelay - inconsistency in buffer time");
   }
-  else
-    m_bufferedSamples -= samples;
 }
 
 void CEngineStats::AddSamples(int samples, std::list<CActiveAEStream*> &streams)
 {
-  CSingleLock lock(m_lock);
-  m_bufferedSamples += samples;
+  {
+    CSingleLock lock(m_lock);
+    m_delaySection.enter();
+    m_bufferedSamples += samples;
+    m_delaySection.leave();
+  }
 
   for (auto stream : streams)
   {
@@ -63,164 +80,151 @@ void CEngineStats::AddSamples(int samples, std::list<CActiveAEStream*> &streams)
   }
 }
 
-void CEngineStats::GetDelay(AEDelayStatus& status)
+double CEngineStats::GetBufferedTime() const
 {
-  CSingleLock lock(m_lock);
-  status = m_sinkDelay;
   if (m_pcmOutput)
-    status.delay += (double)m_bufferedSamples / m_sinkSampleRate;
+    return static_cast<double>(m_bufferedSamples) / m_sinkSampleRate;
   else
-    status.delay += (double)m_bufferedSamples * m_sinkFormat.m_streamInfo.GetDuration() / 1000;
+    return m_bufferedSamples * m_sinkFrameDuration / 1000;
 }
 
-void CEngineStats::AddStream(unsigned int streamid)
+void CEngineStats::GetDelay(AEDelayStatus& status)
 {
-  StreamStats stream;
-  stream.m_streamId = streamid;
-  stream.m_bufferedTime = 0;
-  stream.m_resampleRatio = 1.0;
-  stream.m_syncError = 0;
-  stream.m_syncState = CAESyncInfo::AESyncState::SYNC_OFF;
-  m_streamStats.push_back(stream);
+  CAESpinLock lock(m_delaySection);
+  do
+  {
+    status = m_sinkDelay;
+    status.delay += GetBufferedTime();
+  } while (lock.retry());
 }
 
-void CEngineStats::RemoveStream(unsigned int streamid)
+// only called by the engine thread, the one writer of the stats of a stream
+void CEngineStats::UpdateStream(CActiveAEStream *stream)
 {
-  for (auto it = m_streamStats.begin(); it != m_streamStats.end(); ++it)
+  StreamStats stats;
+  stats.m_syncState = stream->m_syncState;
+  stats.m_syncError = stream->m_syncError.GetLastError(stats.m_errorTime);
+
+  float delay = 0;
+  if (stream->m_processingBuffers)
   {
-    if (it->m_streamId == streamid)
-    {
-      m_streamStats.erase(it);
-      return;
-    }
+    stats.m_resampleRatio = stream->m_processingBuffers->GetRR();
+    delay += stream->m_processingBuffers->GetDelay();
+  }
+
+  std::deque<CSampleBuffer*>::iterator itBuf;
+  for(itBuf=stream->m_processingSamples.begin(); itBuf!=stream->m_processingSamples.end(); ++itBuf)
+  {
+    if (m_pcmOutput)
+      delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
+    else
+      delay += static_cast<float>(m_sinkFrameDuration / 1000.0);
   }
+  stats.m_bufferedTime = static_cast<double>(delay);
+  // samples added from now on are still on their way to the engine
+  stats.m_addedTime = stream->m_addedTime.load(std::memory_order_acquire);
+
+  stream->m_statsSection.enter();
+  stream->m_stats = stats;
+  stream->m_statsSection.leave();
 }
 
-void CEngineStats::UpdateStream(CActiveAEStream *stream)
+CEngineStats::StreamStats CEngineStats::GetStreamStats(CActiveAEStream* stream, double& addedTime)
 {
-  CSingleLock lock(m_lock);
-  for (auto &str : m_streamStats)
+  StreamStats stats;
+  CAESpinLock lock(stream->m_statsSection);
+  do
   {
-    if (str.m_streamId == stream->m_id)
-    {
-      float delay = 0;
-      str.m_syncState = stream->m_syncState;
-      str.m_syncError = stream->m_syncError.GetLastError(str.m_errorTime);
-      if (stream->m_processingBuffers)
-      {
-        str.m_resampleRatio = stream->m_processingBuffers->GetRR();
-        delay += stream->m_processingBuffers->GetDelay();
-      }
-      else
-      {
-        str.m_resampleRatio = 1.0;
-      }
+    stats = stream->m_stats;
+  } while (lock.retry());
 
-      CSingleLock lock(stream->m_statsLock);
-      std::deque<CSampleBuffer*>::iterator itBuf;
-      for(itBuf=stream->m_processingSamples.begin(); itBuf!=stream->m_processingSamples.end(); ++itBuf)
-      {
-        if (m_pcmOutput)
-          delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
-        else
-          delay += static_cast<float>(m_sinkFormat.m_streamInfo.GetDuration() / 1000.0);
-      }
-      str.m_bufferedTime = static_cast<double>(delay);
-      stream->m_bufferedTime = 0;
-      break;
-    }
-  }
+  addedTime = stream->m_addedTime.load(std::memory_order_acquire) - stats.m_addedTime;
+  return stats;
 }
 
 // this is used to sync a/v so we need to add sink latency here
 void CEngineStats::GetDelay(AEDelayStatus& status, CActiveAEStream *stream)
 {
-  CSingleLock lock(m_lock);
-  status = m_sinkDelay;
-  status.delay += static_cast<double>(m_sinkLatency);
-  if (m_pcmOutput)
-    status.delay += (double)m_bufferedSamples / m_sinkSampleRate;
-  else
-    status.delay += (double)m_bufferedSamples * m_sinkFormat.m_streamInfo.GetDuration() / 1000;
-
-  for (auto &str : m_streamStats)
   {
-    if (str.m_streamId == stream->m_id)
+    CAESpinLock lock(m_delaySection);
+    do
     {
-      CSingleLock lock(stream->m_statsLock);
-      float buffertime = static_cast<float>(str.m_bufferedTime) + stream->m_bufferedTime;
-      status.delay += static_cast<double>(buffertime) / str.m_resampleRatio;
-      return;
-    }
+      status = m_sinkDelay;
+      status.delay += static_cast<double>(m_sinkLatency);
+      status.delay += GetBufferedTime();
+    } while (lock.retry());
   }
+
+  double addedTime;
+  StreamStats stats = GetStreamStats(stream, addedTime);
+  status.delay += (stats.m_bufferedTime + addedTime) / stats.m_resampleRatio;
 }
 
 // this is used to sync a/v so we need to add sink latency here
 void CEngineStats::GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream)
 {
-  CSingleLock lock(m_lock);
   AEDelayStatus status;
-  status = m_sinkDelay;
-  if (m_pcmOutput)
-    status.delay += (double)m_bufferedSamples / m_sinkSampleRate;
-  else
-    status.delay += (double)m_bufferedSamples * m_sinkFormat.m_streamInfo.GetDuration() / 1000;
-
-  status.delay += static_cast<double>(m_sinkLatency);
-
-  for (auto &str : m_streamStats)
   {
-    if (str.m_streamId == stream->m_id)
+    CAESpinLock lock(m_delaySection);
+    do
     {
-      CSingleLock lock(stream->m_statsLock);
-      float buffertime = static_cast<float>(str.m_bufferedTime) + stream->m_bufferedTime;
-      status.delay += static_cast<double>(buffertime) / str.m_resampleRatio;
-      info.delay = status.GetDelay();
-      info.error = str.m_syncError;
-      info.errortime = str.m_errorTime;
-      info.state = str.m_syncState;
-      info.rr = str.m_resampleRatio;
-      return;
-    }
+      status = m_sinkDelay;
+      status.delay += GetBufferedTime();
+      status.delay += static_cast<double>(m_sinkLatency);
+    } while (lock.retry());
   }
+
+  double addedTime;
+  StreamStats stats = GetStreamStats(stream, addedTime);
+  status.delay += (stats.m_bufferedTime + addedTime) / stats.m_resampleRatio;
+  info.delay = status.GetDelay();
+  info.error = stats.m_syncError;
+  info.errortime = stats.m_errorTime;
+  info.state = stats.m_syncState;
+  info.rr = stats.m_resampleRatio;
 }
 
 float CEngineStats::GetCacheTime(CActiveAEStream *stream)
 {
-  CSingleLock lock(m_lock);
-  float delay = 0;
-
-  for (auto &str : m_streamStats)
-  {
-    if (str.m_streamId == stream->m_id)
-    {
-      CSingleLock lock(stream->m_statsLock);
-      float buffertime = static_cast<float>(str.m_bufferedTime) + stream->m_bufferedTime;
-      delay += buffertime / static_cast<float>(str.m_resampleRatio);
-      break;
-    }
-  }
-  return delay;
+  double addedTime;
+  StreamStats stats = GetStreamStats(stream, addedTime);
+  return static_cast<float>((stats.m_bufferedTime + addedTime) / stats.m_resampleRatio);
 }
 
 float CEngineStats::GetCacheTotal()
 {
-  return MAX_CACHE_LEVEL;
+  return static_cast<float>(m_lowLatency ? LOW_LATENCY_CACHE_LEVEL : MAX_CACHE_LEVEL);
 }
 
 float CEngineStats::GetMaxDelay() const
 {
+  if (m_lowLatency)
+    return static_cast<float>(LOW_LATENCY_CACHE_LEVEL) +
+           static_cast<float>(LOW_LATENCY_WATER_LEVEL) + m_sinkCacheTotal;
+
   return static_cast<float>(MAX_CACHE_LEVEL) + static_cast<float>(MAX_WATER_LEVEL) +
          m_sinkCacheTotal;
 }
 
 float CEngineStats::GetWaterLevel()
 {
-  CSingleLock lock(m_lock);
-  if (m_pcmOutput)
-    return static_cast<float>(m_bufferedSamples) / m_sinkSampleRate;
-  else
-    return static_cast<float>(m_bufferedSamples * m_sinkFormat.m_streamInfo.GetDuration()) / 1000;
+  float level;
+  CAESpinLock lock(m_delaySection);
+  do
+  {
+    level = static_cast<float>(GetBufferedTime());
+  } while (lock.retry());
+  return level;
+}
+
+float CEngineStats::GetMaxWaterLevel()
+{
+  return static_cast<float>(m_lowLatency ? LOW_LATENCY_WATER_LEVEL : MAX_WATER_LEVEL);
+}
+
+void CEngineStats::SetLowLatency(bool lowLatency)
+{
+  m_lowLatency = lowLatency;
 }
 
 void CEngineStats::SetSuspended(bool state)
@@ -235,10 +239,21 @@ bool CEngineStats::IsSuspended()
   return m_suspended;
 }
 
+void CEngineStats::SetSinkLatency(float time)
+{
+  CSingleLock lock(m_lock);
+  m_delaySection.enter();
+  m_sinkLatency = time;
+  m_delaySection.leave();
+}
+
 void CEngineStats::SetCurrentSinkFormat(const AEAudioFormat& SinkFormat)
 {
   CSingleLock lock(m_lock);
   m_sinkFormat = SinkFormat;
+  m_delaySection.enter();
+  m_sinkFrameDuration = m_sinkFormat.m_streamInfo.GetDuration();
+  m_delaySection.leave();
 }
 
 AEAudioFormat CEngineStats::GetCurrentSinkFormat()
@@ -1158,6 +1173,8 @@ AEAudioFormat CActiveAE::GetInputFormat(AEAudioFormat *desiredFmt)
 void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 {
   bool initSink = false;
+  auto start = std::chrono::steady_clock::now();
+  m_bufferCache.ResetStats();
 
   AEAudioFormat sinkInputFormat, inputFormat;
   AEAudioFormat oldInternalFormat = m_internalFormat;
@@ -1169,34 +1186,47 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   ApplySettingsToFormat(m_sinkRequestFormat, m_settings, (int*)&m_mode);
   m_extKeepConfig = 0;
 
+  // ask the sink for short periods if a stream wants low latency, leave it to the sink otherwise
+  bool lowLatency = IsLowLatency(m_sinkRequestFormat);
+  m_sinkRequestFormat.m_frames =
+      lowLatency ? LOW_LATENCY_BUFFER_TIME * m_sinkRequestFormat.m_sampleRate : 0;
+
   std::string device = (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW) ? m_settings.passthroughdevice : m_settings.device;
   std::string driver;
   CAESinkFactory::ParseDevice(device, driver);
   if ((!CompareFormat(m_sinkRequestFormat, m_sinkFormat) && !CompareFormat(m_sinkRequestFormat, oldSinkRequestFormat)) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0)
+      m_settings.driver.compare(driver) != 0 ||
+      lowLatency != m_lowLatency)
   {
     FlushEngine();
     if (!InitSink())
       return;
     m_settings.driver = driver;
     m_currDevice = device;
+    m_lowLatency = lowLatency;
     initSink = true;
     m_stats.Reset(m_sinkFormat.m_sampleRate, m_mode == MODE_PCM);
+    m_stats.SetLowLatency(lowLatency);
     m_sink.m_controlPort.SendOutMessage(CSinkControlProtocol::VOLUME, &m_volume, sizeof(float));
 
     if (m_sinkRequestFormat.m_dataFormat != AE_FMT_RAW)
     {
       // limit buffer size in case of sink returns large buffer
+      double maxtime = lowLatency ? LOW_LATENCY_BUFFER_TIME : MAX_BUFFER_TIME;
       double buffertime = (double)m_sinkFormat.m_frames / m_sinkFormat.m_sampleRate;
-      if (buffertime > MAX_BUFFER_TIME)
+      if (buffertime > maxtime)
       {
         CLog::Log(LOGWARNING,
                   "ActiveAE::{} - sink returned large buffer of {} ms, reducing to {} ms",
-                  __FUNCTION__, (int)(buffertime * 1000), (int)(MAX_BUFFER_TIME * 1000));
-        m_sinkFormat.m_frames = MAX_BUFFER_TIME * m_sinkFormat.m_sampleRate;
+                  __FUNCTION__, (int)(buffertime * 1000), (int)(maxtime * 1000));
+        m_sinkFormat.m_frames = maxtime * m_sinkFormat.m_sampleRate;
       }
     }
+
+    if (lowLatency)
+      CLog::Log(LOGINFO, "ActiveAE::{} - low latency, max delay {} ms", __FUNCTION__,
+                (int)(m_stats.GetMaxDelay() * 1000));
   }
 
   if (m_silenceBuffers)
@@ -1204,6 +1234,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     m_discardBufferPools.push_back(m_silenceBuffers);
     m_silenceBuffers = NULL;
   }
+  // hand the buffers of pools no longer in use to the cache before creating new ones
+  ClearDiscardedBuffers();
 
   // buffers for driving gui sounds if no streams are active
   if (m_streams.empty())
@@ -1218,6 +1250,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     inputFormat.m_frameSize = inputFormat.m_channelLayout.Count() *
                               (CAEUtil::DataFormatToBits(inputFormat.m_dataFormat) >> 3);
     m_silenceBuffers = new CActiveAEBufferPool(inputFormat);
+    m_silenceBuffers->SetCache(&m_bufferCache);
     m_silenceBuffers->Create(MAX_WATER_LEVEL*1000);
     sinkInputFormat = inputFormat;
     m_internalFormat = inputFormat;
@@ -1298,6 +1331,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         if (!m_encoderBuffers)
         {
           m_encoderBuffers = new CActiveAEBufferPool(format);
+          m_encoderBuffers->SetCache(&m_bufferCache);
           m_encoderBuffers->Create(MAX_WATER_LEVEL*1000);
         }
       }
@@ -1340,7 +1374,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         // create buffer pool
         (*it)->m_inputBuffers = new CActiveAEBufferPool((*it)->m_format);
-        (*it)->m_inputBuffers->Create(MAX_CACHE_LEVEL*1000);
+        (*it)->m_inputBuffers->SetCache(&m_bufferCache);
+        (*it)->m_inputBuffers->Create(m_stats.GetCacheTotal() * 1000);
         (*it)->m_streamSpace = (*it)->m_format.m_frameSize * (*it)->m_format.m_frames;
 
         // if input format does not follow ffmpeg channel mask, we may need to remap channels
@@ -1353,13 +1388,17 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         m_discardBufferPools.push_back((*it)->m_processingBuffers->GetAtempoBuffers());
         delete (*it)->m_processingBuffers;
         (*it)->m_processingBuffers = nullptr;
+        ClearDiscardedBuffers();
       }
       if (!(*it)->m_processingBuffers)
       {
         (*it)->m_processingBuffers = new CActiveAEStreamBuffers((*it)->m_inputBuffers->m_format, outputFormat, m_settings.resampleQuality);
         (*it)->m_processingBuffers->ForceResampler((*it)->m_forceResampler);
+        (*it)->m_processingBuffers->SetCache(&m_bufferCache);
+        (*it)->m_processingBuffers->SetFactoryFlags(GetResampleFactoryFlags());
 
-        (*it)->m_processingBuffers->Create(MAX_CACHE_LEVEL*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
+        (*it)->m_processingBuffers->Create(m_stats.GetCacheTotal() * 1000, false,
+                                           m_settings.stereoupmix, m_settings.normalizelevels);
       }
       if (m_mode == MODE_TRANSCODE || m_streams.size() > 1)
         (*it)->m_processingBuffers->FillBuffer();
@@ -1393,10 +1432,13 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         // input buffers
         m_vizBuffersInput = new CActiveAEBufferPool(m_internalFormat);
+        m_vizBuffersInput->SetCache(&m_bufferCache);
         m_vizBuffersInput->Create(2000 + m_stats.GetMaxDelay() * 1000);
 
         // resample buffers
         m_vizBuffers = new CActiveAEBufferPoolResample(m_internalFormat, vizFormat, m_settings.resampleQuality);
+        m_vizBuffers->SetCache(&m_bufferCache);
+        m_vizBuffers->SetFactoryFlags(GetResampleFactoryFlags());
         //! @todo use cache of sync + water level
         m_vizBuffers->Create(2000 + m_stats.GetMaxDelay() * 1000, false, false);
         m_vizInitialized = false;
@@ -1405,6 +1447,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
     // buffers need to sync
     m_silenceBuffers = new CActiveAEBufferPool(outputFormat);
+    m_silenceBuffers->SetCache(&m_bufferCache);
     m_silenceBuffers->Create(500);
   }
 
@@ -1416,10 +1459,13 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   {
     m_discardBufferPools.push_back(m_sinkBuffers);
     m_sinkBuffers = NULL;
+    ClearDiscardedBuffers();
   }
   if (!m_sinkBuffers)
   {
     m_sinkBuffers = new CActiveAEBufferPoolResample(sinkInputFormat, m_sinkFormat, m_settings.resampleQuality);
+    m_sinkBuffers->SetCache(&m_bufferCache);
+    m_sinkBuffers->SetFactoryFlags(GetResampleFactoryFlags());
     m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
   }
 
@@ -1441,6 +1487,15 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
   ClearDiscardedBuffers();
   m_extDrain = false;
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  CLog::Log(LOGDEBUG,
+            "ActiveAE::{} - took {} us, buffers reused: {} allocated: {}, "
+            "resamplers reused: {} created: {}",
+            __FUNCTION__, elapsed.count(), m_bufferCache.m_buffersReused,
+            m_bufferCache.m_buffersAllocated, m_bufferCache.m_resamplersReused,
+            m_bufferCache.m_resamplersCreated);
 }
 
 CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
@@ -1485,10 +1540,12 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
   if (streamMsg->options & AESTREAM_FORCE_RESAMPLE)
     stream->m_forceResampler = true;
 
+  if (streamMsg->options & AESTREAM_LOW_LATENCY)
+    stream->m_lowLatency = true;
+
   stream->m_pClock = streamMsg->clock;
 
   m_streams.push_back(stream);
-  m_stats.AddStream(stream->m_id);
 
   return stream;
 }
@@ -1515,7 +1572,6 @@ void CActiveAE::DiscardStream(CActiveAEStream *stream)
       }
       delete (*it)->m_processingBuffers;
       CLog::Log(LOGDEBUG, "CActiveAE::DiscardStream - audio stream deleted");
-      m_stats.RemoveStream((*it)->m_id);
       delete (*it)->m_streamPort;
       delete (*it);
       it = m_streams.erase(it);
@@ -1536,7 +1592,6 @@ void CActiveAE::SFlushStream(CActiveAEStream *stream)
   }
   stream->m_processingBuffers->Flush();
   stream->m_streamPort->Purge();
-  stream->m_bufferedTime = 0.0;
   stream->m_paused = false;
   stream->m_syncState = CAESyncInfo::AESyncState::SYNC_START;
   stream->m_syncError.Flush();
@@ -1589,7 +1644,8 @@ void CActiveAE::ClearDiscardedBuffers()
     {
       rbuf->Flush();
     }
-    // if all buffers have returned, we can delete the buffer pool
+    // if all buffers have returned, we can delete the buffer pool,
+    // its buffers and resampler go to the cache
     if ((*it)->m_allSamples.size() == (*it)->m_freeSamples.size())
     {
       delete (*it);
@@ -1599,6 +1655,7 @@ void CActiveAE::ClearDiscardedBuffers()
     else
       ++it;
   }
+  m_bufferCache.Trim();
 }
 
 void CActiveAE::SStopSound(CActiveAESound *sound)
@@ -1638,9 +1695,17 @@ void CActiveAE::ChangeResamplers()
   for(it=m_streams.begin(); it!=m_streams.end(); ++it)
   {
     (*it)->m_processingBuffers->ConfigureResampler(m_settings.normalizelevels, m_settings.stereoupmix, m_settings.resampleQuality);
+    (*it)->m_processingBuffers->SetFactoryFlags(GetResampleFactoryFlags());
   }
 }
 
+uint32_t CActiveAE::GetResampleFactoryFlags() const
+{
+  if (m_settings.resampler == AE_RESAMPLER_POLYPHASE)
+    return AERESAMPLEFACTORY_POLYPHASE;
+  return 0;
+}
+
 void CActiveAE::ApplySettingsToFormat(AEAudioFormat &format, AudioSettings &settings, int *mode)
 {
   int oldMode = m_mode;
@@ -1772,7 +1837,22 @@ bool CActiveAE::NeedReconfigureSink()
 
   return !CompareFormat(newFormat, m_sinkFormat) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0;
+      m_settings.driver.compare(driver) != 0 ||
+      IsLowLatency(newFormat) != m_lowLatency;
+}
+
+bool CActiveAE::IsLowLatency(const AEAudioFormat& format)
+{
+  // passthrough can't be cut into short periods
+  if (format.m_dataFormat == AE_FMT_RAW)
+    return false;
+
+  for (auto stream : m_streams)
+  {
+    if (stream->m_lowLatency && !stream->IsDrained())
+      return true;
+  }
+  return false;
 }
 
 bool CActiveAE::InitSink()
@@ -1911,7 +1991,7 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < static_cast<float>(MAX_CACHE_LEVEL) || (*it)->m_streamIsBuffering) &&
+      while ((time < m_stats.GetCacheTotal() || (*it)->m_streamIsBuffering) &&
              !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
@@ -1951,7 +2031,7 @@ bool CActiveAE::RunStages()
     }
   }
 
-  if (m_stats.GetWaterLevel() < static_cast<float>(MAX_WATER_LEVEL) &&
+  if (m_stats.GetWaterLevel() < m_stats.GetMaxWaterLevel() &&
       (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
     // calculate sync error
@@ -2102,15 +2182,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEUtil::MulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2171,24 +2243,12 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
+                CAEUtil::MulAddArray(dst, src, volume, nb_floats);
+                for (int k = 0; k < nb_floats && !needClamp; ++k)
                 {
-                  dst[k] += src[k] * volume;
                   if (fabs(dst[k]) > 1.0f)
                     needClamp = true;
                 }
-#endif
               }
             }
             mix->Return();
@@ -2575,12 +2635,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEUtil::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2605,13 +2660,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEUtil::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2648,6 +2697,7 @@ void CActiveAE::LoadSettings()
       settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_DTSHDCOREFALLBACK);
 
   m_settings.resampleQuality = static_cast<AEQuality>(settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_PROCESSQUALITY));
+  m_settings.resampler = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_RESAMPLER);
   m_settings.atempoThreshold = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD) / 100.0;
   m_settings.streamNoise = settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE);
   m_settings.silenceTimeout = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE) * 60000;
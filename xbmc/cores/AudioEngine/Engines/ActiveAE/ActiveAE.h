@@ -12,9 +12,11 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
 #include "guilib/DispResource.h"
 #include "threads/Thread.h"
 
+#include <atomic>
 #include <list>
 #include <queue>
 #include <string>
@@ -58,6 +60,7 @@ struct AudioSettings
   int guisoundmode;
   unsigned int samplerate;
   AEQuality resampleQuality;
+  int resampler;
   double atempoThreshold;
   bool streamNoise;
   int silenceTimeout;
@@ -173,15 +176,32 @@ struct MsgStreamFFmpegInfo
   enum AVAudioServiceType audio_service_type;
 };
 
+/*!
+ \brief Buffer levels and delay of the engine
+
+ The sink thread and the engine update the delay, the players read it for a/v
+ sync. Readers don't lock, they copy the figures through a sequence lock and
+ retry if they were updated meanwhile, so a busy player or GUI thread never
+ holds up the audio threads. The writers are serialized by m_lock.
+ */
 class CEngineStats
 {
 public:
+  // what the engine knows of a stream, published to the stream by UpdateStream
+  struct StreamStats
+  {
+    double m_bufferedTime = 0; // time of the samples in the engine
+    double m_addedTime = 0; // m_addedTime of the stream at that point
+    double m_resampleRatio = 1.0;
+    double m_syncError = 0;
+    unsigned int m_errorTime = 0;
+    CAESyncInfo::AESyncState m_syncState = CAESyncInfo::AESyncState::SYNC_OFF;
+  };
+
   void Reset(unsigned int sampleRate, bool pcm);
   void UpdateSinkDelay(const AEDelayStatus& status, int samples);
   void AddSamples(int samples, std::list<CActiveAEStream*> &streams);
   void GetDelay(AEDelayStatus& status);
-  void AddStream(unsigned int streamid);
-  void RemoveStream(unsigned int streamid);
   void UpdateStream(CActiveAEStream *stream);
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream);
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream);
@@ -189,32 +209,32 @@ public:
   float GetCacheTotal();
   float GetMaxDelay() const;
   float GetWaterLevel();
+  float GetMaxWaterLevel();
+  void SetLowLatency(bool lowLatency);
   void SetSuspended(bool state);
   void SetCurrentSinkFormat(const AEAudioFormat& SinkFormat);
   void SetSinkCacheTotal(float time) { m_sinkCacheTotal = time; }
-  void SetSinkLatency(float time) { m_sinkLatency = time; }
+  void SetSinkLatency(float time);
   bool IsSuspended();
   AEAudioFormat GetCurrentSinkFormat();
 protected:
+  double GetBufferedTime() const;
+  StreamStats GetStreamStats(CActiveAEStream* stream, double& addedTime);
+
   float m_sinkCacheTotal;
-  float m_sinkLatency;
+  bool m_suspended;
+  AEAudioFormat m_sinkFormat;
+  std::atomic<bool> m_lowLatency{false}; // read by the players without locking
+  CCriticalSection m_lock;
+
+  // read through m_delaySection
+  CAESpinSection m_delaySection;
+  float m_sinkLatency = 0;
   int m_bufferedSamples;
   unsigned int m_sinkSampleRate;
   AEDelayStatus m_sinkDelay;
-  bool m_suspended;
-  AEAudioFormat m_sinkFormat;
   bool m_pcmOutput;
-  CCriticalSection m_lock;
-  struct StreamStats
-  {
-    unsigned int m_streamId;
-    double m_bufferedTime;
-    double m_resampleRatio;
-    double m_syncError;
-    unsigned int m_errorTime;
-    CAESyncInfo::AESyncState m_syncState;
-  };
-  std::vector<StreamStats> m_streamStats;
+  double m_sinkFrameDuration = 0; // ms, of the packets passed through
 };
 
 class CActiveAE : public IAE, public IDispResource, private CThread
@@ -298,6 +318,7 @@ protected:
   void LoadSettings();
   bool NeedReconfigureBuffers();
   bool NeedReconfigureSink();
+  bool IsLowLatency(const AEAudioFormat& format);
   void ApplySettingsToFormat(AEAudioFormat &format, AudioSettings &settings, int *mode = NULL);
   void Configure(AEAudioFormat *desiredFmt = NULL);
   AEAudioFormat GetInputFormat(AEAudioFormat *desiredFmt = NULL);
@@ -309,6 +330,7 @@ protected:
   void SStopSound(CActiveAESound *sound);
   void DiscardSound(CActiveAESound *sound);
   void ChangeResamplers();
+  uint32_t GetResampleFactoryFlags() const;
 
   bool RunStages();
   bool HasWork();
@@ -347,6 +369,7 @@ protected:
   CActiveAESink m_sink;
   AEAudioFormat m_sinkFormat;
   AEAudioFormat m_sinkRequestFormat;
+  bool m_lowLatency = false;
   AEAudioFormat m_encoderFormat;
   AEAudioFormat m_internalFormat;
   AEAudioFormat m_inputFormat;
@@ -357,6 +380,7 @@ protected:
   std::unique_ptr<CActiveAESettings> m_settingsHandler;
 
   // buffers
+  CActiveAEBufferCache m_bufferCache; // buffers and resamplers of discarded pools
   CActiveAEBufferPoolResample *m_sinkBuffers;
   CActiveAEBufferPoolResample *m_vizBuffers;
   CActiveAEBufferPool *m_vizBuffersInput;
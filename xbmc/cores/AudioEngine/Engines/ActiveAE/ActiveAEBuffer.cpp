@@ -13,8 +13,28 @@
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 
+#include <algorithm>
+
 using namespace ActiveAE;
 
+namespace
+{
+constexpr size_t MAX_CACHED_BYTES = 8 * 1024 * 1024;
+constexpr size_t MAX_CACHED_RESAMPLERS = 8;
+
+size_t GetBytes(const CSampleBuffer* buffer)
+{
+  return static_cast<size_t>(buffer->pkt->linesize) * buffer->pkt->planes;
+}
+
+bool SameConfig(const SampleConfig& a, const SampleConfig& b)
+{
+  return a.fmt == b.fmt && a.channel_layout == b.channel_layout && a.channels == b.channels &&
+         a.sample_rate == b.sample_rate && a.bits_per_sample == b.bits_per_sample &&
+         a.dither_bits == b.dither_bits;
+}
+} // namespace
+
 CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 {
   data = CActiveAE::AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
@@ -66,7 +86,10 @@ CActiveAEBufferPool::~CActiveAEBufferPool()
   {
     buffer = m_allSamples.front();
     m_allSamples.pop_front();
-    delete buffer;
+    if (m_cache)
+      m_cache->KeepBuffer(buffer);
+    else
+      delete buffer;
   }
 }
 
@@ -111,9 +134,13 @@ bool CActiveAEBufferPool::Create(unsigned int totaltime)
   unsigned int n = 0;
   while (time < totaltime || n < 5)
   {
-    buffer = new CSampleBuffer();
+    buffer = m_cache ? m_cache->GetBuffer(config, m_format.m_frames) : nullptr;
+    if (!buffer)
+    {
+      buffer = new CSampleBuffer();
+      buffer->pkt = new CSoundPacket(config, m_format.m_frames);
+    }
     buffer->pool = this;
-    buffer->pkt = new CSoundPacket(config, m_format.m_frames);
 
     m_allSamples.push_back(buffer);
     m_freeSamples.push_back(buffer);
@@ -124,6 +151,132 @@ bool CActiveAEBufferPool::Create(unsigned int totaltime)
   return true;
 }
 
+// ----------------------------------------------------------------------------------
+// Cache
+// ----------------------------------------------------------------------------------
+
+bool ResampleConfig::operator==(const ResampleConfig& other) const
+{
+  return SameConfig(dstConfig, other.dstConfig) && SameConfig(srcConfig, other.srcConfig) &&
+         upmix == other.upmix && normalize == other.normalize && centerMix == other.centerMix &&
+         remap == other.remap && (!remap || remapLayout == other.remapLayout) &&
+         quality == other.quality && force == other.force && factoryFlags == other.factoryFlags;
+}
+
+CActiveAEBufferCache::~CActiveAEBufferCache()
+{
+  Clear();
+}
+
+CSampleBuffer* CActiveAEBufferCache::GetBuffer(const SampleConfig &config, int samples)
+{
+  auto it = m_buffers.find(BufferKey(config.fmt, config.channels, samples));
+  if (it == m_buffers.end() || it->second.buffers.empty())
+  {
+    m_buffersAllocated++;
+    return nullptr;
+  }
+
+  CSampleBuffer *buffer = it->second.buffers.back();
+  it->second.buffers.pop_back();
+  it->second.lastUse = ++m_useCount;
+  m_bufferBytes -= GetBytes(buffer);
+  m_buffersReused++;
+
+  // layout, rate and bits don't change the memory of a packet, only how it's read
+  buffer->pkt->config = config;
+  buffer->pkt->nb_samples = 0;
+  buffer->pkt->pause_burst_ms = 0;
+  buffer->timestamp = 0;
+  buffer->pkt_start_offset = 0;
+  buffer->refCount = 0;
+  return buffer;
+}
+
+void CActiveAEBufferCache::KeepBuffer(CSampleBuffer *buffer)
+{
+  buffer->pool = nullptr;
+  CachedBuffers &cached = m_buffers[BufferKey(buffer->pkt->config.fmt,
+                                              buffer->pkt->config.channels,
+                                              buffer->pkt->max_nb_samples)];
+  cached.buffers.push_back(buffer);
+  cached.lastUse = ++m_useCount;
+  m_bufferBytes += GetBytes(buffer);
+}
+
+ActiveAE::IAEResample* CActiveAEBufferCache::GetResampler(const ResampleConfig &config)
+{
+  for (auto it = m_resamplers.begin(); it != m_resamplers.end(); ++it)
+  {
+    if (it->first == config)
+    {
+      IAEResample *resampler = it->second;
+      m_resamplers.erase(it);
+      if (!resampler->Flush())
+      {
+        delete resampler;
+        break;
+      }
+      m_resamplersReused++;
+      return resampler;
+    }
+  }
+  m_resamplersCreated++;
+  return nullptr;
+}
+
+void CActiveAEBufferCache::KeepResampler(const ResampleConfig &config, IAEResample *resampler)
+{
+  m_resamplers.emplace_front(config, resampler);
+}
+
+void CActiveAEBufferCache::Trim()
+{
+  // drop the formats that were not used for the longest time
+  while (m_bufferBytes > MAX_CACHED_BYTES)
+  {
+    auto oldest = std::min_element(m_buffers.begin(), m_buffers.end(),
+                                   [](const auto& a, const auto& b) {
+                                     return a.second.lastUse < b.second.lastUse;
+                                   });
+    for (auto buffer : oldest->second.buffers)
+    {
+      m_bufferBytes -= GetBytes(buffer);
+      delete buffer;
+    }
+    m_buffers.erase(oldest);
+  }
+
+  while (m_resamplers.size() > MAX_CACHED_RESAMPLERS)
+  {
+    delete m_resamplers.back().second;
+    m_resamplers.pop_back();
+  }
+}
+
+void CActiveAEBufferCache::Clear()
+{
+  for (auto &cached : m_buffers)
+  {
+    for (auto buffer : cached.second.buffers)
+      delete buffer;
+  }
+  m_buffers.clear();
+  m_bufferBytes = 0;
+
+  for (auto &resampler : m_resamplers)
+    delete resampler.second;
+  m_resamplers.clear();
+}
+
+void CActiveAEBufferCache::ResetStats()
+{
+  m_buffersReused = 0;
+  m_buffersAllocated = 0;
+  m_resamplersReused = 0;
+  m_resamplersCreated = 0;
+}
+
 // ----------------------------------------------------------------------------------
 // Resample
 // ----------------------------------------------------------------------------------
@@ -146,7 +299,10 @@ CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 {
   Flush();
 
-  delete m_resampler;
+  if (m_cache && m_resamplerValid)
+    m_cache->KeepResampler(m_resamplerConfig, m_resampler);
+  else
+    delete m_resampler;
 }
 
 bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, bool upmix, bool normalize)
@@ -170,38 +326,66 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
   return true;
 }
 
+ResampleConfig CActiveAEBufferPoolResample::GetResampleConfig()
+{
+  ResampleConfig config;
+  config.dstConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
+  config.dstConfig.channels = m_format.m_channelLayout.Count();
+  config.dstConfig.sample_rate = m_format.m_sampleRate;
+  config.dstConfig.fmt = CAEUtil::GetAVSampleFormat(m_format.m_dataFormat);
+  config.dstConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat);
+  config.dstConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat);
+
+  config.srcConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout);
+  config.srcConfig.channels = m_inputFormat.m_channelLayout.Count();
+  config.srcConfig.sample_rate = m_inputFormat.m_sampleRate;
+  config.srcConfig.fmt = CAEUtil::GetAVSampleFormat(m_inputFormat.m_dataFormat);
+  config.srcConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat);
+  config.srcConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat);
+
+  config.upmix = m_stereoUpmix;
+  config.normalize = m_normalize;
+  config.centerMix = m_centerMixLevel;
+  config.remap = m_remap;
+  if (m_remap)
+    config.remapLayout = m_format.m_channelLayout;
+  config.quality = m_resampleQuality;
+  config.force = m_forceResampler;
+  config.factoryFlags = m_factoryFlags;
+  return config;
+}
+
 void CActiveAEBufferPoolResample::ChangeResampler()
 {
+  ResampleConfig config = GetResampleConfig();
+
   if (m_resampler)
   {
-    delete m_resampler;
+    // a resampler that failed can't be handed out again
+    if (m_cache && m_resamplerValid)
+      m_cache->KeepResampler(m_resamplerConfig, m_resampler);
+    else
+      delete m_resampler;
     m_resampler = NULL;
   }
 
-  m_resampler = CAEResampleFactory::Create();
-
-  SampleConfig dstConfig, srcConfig;
-  dstConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
-  dstConfig.channels = m_format.m_channelLayout.Count();
-  dstConfig.sample_rate = m_format.m_sampleRate;
-  dstConfig.fmt = CAEUtil::GetAVSampleFormat(m_format.m_dataFormat);
-  dstConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat);
-  dstConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat);
-
-  srcConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout);
-  srcConfig.channels = m_inputFormat.m_channelLayout.Count();
-  srcConfig.sample_rate = m_inputFormat.m_sampleRate;
-  srcConfig.fmt = CAEUtil::GetAVSampleFormat(m_inputFormat.m_dataFormat);
-  srcConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat);
-  srcConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat);
-
-  m_resampler->Init(dstConfig, srcConfig,
-                    m_stereoUpmix,
-                    m_normalize,
-                    m_centerMixLevel,
-                    m_remap ? &m_format.m_channelLayout : nullptr,
-                    m_resampleQuality,
-                    m_forceResampler);
+  m_resampler = m_cache ? m_cache->GetResampler(config) : nullptr;
+  if (m_resampler)
+  {
+    m_resamplerValid = true;
+  }
+  else
+  {
+    m_resampler = CAEResampleFactory::Create(m_factoryFlags);
+    m_resamplerValid = m_resampler->Init(config.dstConfig, config.srcConfig,
+                                         config.upmix,
+                                         config.normalize,
+                                         config.centerMix,
+                                         config.remap ? &config.remapLayout : nullptr,
+                                         config.quality,
+                                         config.force);
+  }
+  m_resamplerConfig = config;
 
   m_changeResampler = false;
 }
@@ -288,6 +472,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
       {
         out_samples = 0;
         m_changeResampler = true;
+        m_resamplerValid = false;
       }
 
       m_procSample->pkt->nb_samples += out_samples;
@@ -378,6 +563,14 @@ void CActiveAEBufferPoolResample::ConfigureResampler(bool normalizelevels, bool
   m_normalize = normalize;
 }
 
+void CActiveAEBufferPoolResample::SetFactoryFlags(uint32_t flags)
+{
+  if (m_resampler && m_factoryFlags != flags)
+    m_changeResampler = true;
+
+  m_factoryFlags = flags;
+}
+
 float CActiveAEBufferPoolResample::GetDelay()
 {
   float delay = 0;
@@ -422,8 +615,14 @@ void CActiveAEBufferPoolResample::Flush()
     m_outputSamples.front()->Return();
     m_outputSamples.pop_front();
   }
+  // a seek only needs the resampler emptied, no need to create a new one
   if (m_resampler)
-    ChangeResampler();
+  {
+    if (!m_changeResampler && m_resamplerValid && !m_resampler->Flush())
+      m_resamplerValid = false;
+    if (m_changeResampler || !m_resamplerValid)
+      ChangeResampler();
+  }
 }
 
 void CActiveAEBufferPoolResample::SetDrain(bool drain)
@@ -12,7 +12,11 @@
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include <cmath>
 #include <deque>
+#include <list>
+#include <map>
 #include <memory>
+#include <tuple>
+#include <vector>
 
 extern "C" {
 #include <libavutil/avutil.h>
@@ -41,6 +45,7 @@ public:
 };
 
 class CActiveAEBufferPool;
+class CActiveAEBufferCache;
 
 class CSampleBuffer
 {
@@ -65,13 +70,76 @@ public:
   virtual bool Create(unsigned int totaltime);
   CSampleBuffer *GetFreeBuffer();
   void ReturnBuffer(CSampleBuffer *buffer);
+  void SetCache(CActiveAEBufferCache *cache) { m_cache = cache; }
   AEAudioFormat m_format;
   std::deque<CSampleBuffer*> m_allSamples;
   std::deque<CSampleBuffer*> m_freeSamples;
+
+protected:
+  CActiveAEBufferCache *m_cache = nullptr;
 };
 
 class IAEResample;
 
+/**
+ * the parameters a resampler was initialized with
+ */
+struct ResampleConfig
+{
+  SampleConfig dstConfig;
+  SampleConfig srcConfig;
+  bool upmix;
+  bool normalize;
+  double centerMix;
+  bool remap;
+  CAEChannelInfo remapLayout;
+  AEQuality quality;
+  bool force;
+  uint32_t factoryFlags;
+
+  bool operator==(const ResampleConfig& other) const;
+};
+
+/**
+ * Keeps the sample buffers and resamplers of discarded pools, the pools
+ * created on the next configuration take them instead of allocating new ones.
+ * Buffers are matched by sample format, channels and size, resamplers by
+ * their complete configuration. Only used by the engine thread.
+ */
+class CActiveAEBufferCache
+{
+public:
+  CActiveAEBufferCache() = default;
+  ~CActiveAEBufferCache();
+  CSampleBuffer *GetBuffer(const SampleConfig &config, int samples);
+  void KeepBuffer(CSampleBuffer *buffer);
+  IAEResample *GetResampler(const ResampleConfig &config);
+  void KeepResampler(const ResampleConfig &config, IAEResample *resampler);
+  void Trim();
+  void Clear();
+  void ResetStats();
+  int m_buffersReused = 0;
+  int m_buffersAllocated = 0;
+  int m_resamplersReused = 0;
+  int m_resamplersCreated = 0;
+
+protected:
+  using BufferKey = std::tuple<int, int, int>;
+  struct CachedBuffers
+  {
+    std::vector<CSampleBuffer*> buffers;
+    unsigned int lastUse = 0;
+  };
+  std::map<BufferKey, CachedBuffers> m_buffers;
+  std::list<std::pair<ResampleConfig, IAEResample*>> m_resamplers;
+  unsigned int m_useCount = 0;
+  size_t m_bufferBytes = 0;
+
+private:
+  CActiveAEBufferCache(const CActiveAEBufferCache&) = delete;
+  CActiveAEBufferCache& operator=(const CActiveAEBufferCache&) = delete;
+};
+
 class CActiveAEBufferPoolResample : public CActiveAEBufferPool
 {
 public:
@@ -81,6 +149,7 @@ public:
   bool Create(unsigned int totaltime, bool remap, bool upmix, bool normalize = true);
   bool ResampleBuffers(int64_t timestamp = 0);
   void ConfigureResampler(bool normalizelevels, bool stereoupmix, AEQuality quality);
+  void SetFactoryFlags(uint32_t flags);
   float GetDelay();
   void Flush();
   void SetDrain(bool drain);
@@ -95,6 +164,7 @@ public:
 
 protected:
   void ChangeResampler();
+  ResampleConfig GetResampleConfig();
 
   uint8_t *m_planes[16];
   bool m_empty = true;
@@ -103,6 +173,8 @@ protected:
   bool m_remap = false;
   CSampleBuffer *m_procSample = nullptr;
   IAEResample *m_resampler = nullptr;
+  ResampleConfig m_resamplerConfig;
+  bool m_resamplerValid = false;
   double m_resampleRatio = 1.0;
   double m_centerMixLevel = M_SQRT1_2;
   bool m_fillPackets = false;
@@ -110,6 +182,7 @@ protected:
   bool m_changeResampler = false;
   bool m_forceResampler = false;
   AEQuality m_resampleQuality;
+  uint32_t m_factoryFlags = 0; // picks the resampler, see CAEResampleFactory
   bool m_stereoUpmix = false;
 };
 
@@ -250,6 +250,21 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
   return ret;
 }
 
+bool CActiveAEResampleFFMPEG::Flush()
+{
+  if (!m_pContext)
+    return false;
+
+  // swr_init drops the internal buffers, options and custom matrix are kept
+  m_doesResample = m_src_rate != m_dst_rate;
+  if (swr_init(m_pContext) < 0)
+  {
+    CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Flush - init resampler failed");
+    return false;
+  }
+  return true;
+}
+
 int64_t CActiveAEResampleFFMPEG::GetDelay(int64_t base)
 {
   return swr_get_delay(m_pContext, base);
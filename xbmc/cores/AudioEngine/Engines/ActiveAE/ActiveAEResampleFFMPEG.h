@@ -30,6 +30,7 @@ public:
   bool Init(SampleConfig dstConfig, SampleConfig srcConfig, bool upmix, bool normalize, double centerMix,
             CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample) override;
   int Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio) override;
+  bool Flush() override;
   int64_t GetDelay(int64_t base) override;
   int GetBufferedSamples() override;
   bool WantsNewSamples(int samples) override { return GetBufferedSamples() <= samples * 2; }
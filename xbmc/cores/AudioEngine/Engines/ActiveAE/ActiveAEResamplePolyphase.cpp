@@ -0,0 +1,383 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ActiveAEResamplePolyphase.h"
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+using namespace ActiveAE;
+
+namespace
+{
+
+struct FilterPreset
+{
+  int taps;
+  int phases;
+  bool interpolate;
+  double cutoff; // of the nyquist frequency of the lower rate
+  double beta; // of the kaiser window, sets the stopband attenuation
+};
+
+// low is meant for weak arm boxes, it skips the interpolation between the phases
+FilterPreset GetPreset(AEQuality quality)
+{
+  switch (quality)
+  {
+    case AE_QUALITY_LOW:
+      return {16, 32, false, 0.85, 5.0};
+    case AE_QUALITY_HIGH:
+      return {64, 128, true, 0.95, 9.0};
+    case AE_QUALITY_REALLYHIGH:
+    case AE_QUALITY_GPU:
+      return {128, 256, true, 0.97, 12.0};
+    default:
+      return {32, 64, true, 0.91, 7.0};
+  }
+}
+
+constexpr int MAX_TAPS = 512;
+
+// modified bessel function of the first kind, order 0
+double BesselI0(double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 64; k++)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+CCriticalSection bankLock;
+std::map<std::tuple<int, int, int>, std::weak_ptr<const CActiveAEResamplePolyphase::FilterBank>> banks;
+
+} // namespace
+
+std::shared_ptr<const CActiveAEResamplePolyphase::FilterBank> CActiveAEResamplePolyphase::
+    GetFilterBank(AEQuality quality, int srcRate, int dstRate)
+{
+  CSingleLock lock(bankLock);
+  auto key = std::make_tuple(static_cast<int>(quality), srcRate, dstRate);
+  auto it = banks.find(key);
+  if (it != banks.end())
+  {
+    if (auto bank = it->second.lock())
+      return bank;
+  }
+
+  const FilterPreset preset = GetPreset(quality);
+  auto bank = std::make_shared<FilterBank>();
+
+  // when going down in rate, the filter cuts lower and gets longer by the same factor
+  double scale = std::min(1.0, static_cast<double>(dstRate) / srcRate);
+  bank->taps = static_cast<int>(std::ceil(preset.taps / scale / 8)) * 8;
+  bank->taps = std::min(bank->taps, MAX_TAPS);
+  bank->phases = preset.phases;
+  bank->interpolate = preset.interpolate;
+
+  const int taps = bank->taps;
+  const int half = taps / 2;
+  const double cutoff = preset.cutoff * scale;
+  const double i0beta = BesselI0(preset.beta);
+
+  bank->coefs.resize((bank->phases + 1) * taps);
+  for (int p = 0; p <= bank->phases; p++)
+  {
+    float *row = &bank->coefs[p * taps];
+    double sum = 0;
+    for (int k = 0; k < taps; k++)
+    {
+      // distance of the tap to the point in time of the output sample
+      const double t = static_cast<double>(p) / bank->phases + half - 1 - k;
+      const double x = M_PI * cutoff * t;
+      const double sinc = (t == 0) ? 1.0 : std::sin(x) / x;
+      const double r = t / half;
+      const double window = (r <= -1.0 || r >= 1.0)
+                                ? 0.0
+                                : BesselI0(preset.beta * std::sqrt(1.0 - r * r)) / i0beta;
+      row[k] = static_cast<float>(cutoff * sinc * window);
+      sum += row[k];
+    }
+    // no gain and no ripple at dc, whatever the phase
+    for (int k = 0; k < taps; k++)
+      row[k] = static_cast<float>(row[k] / sum);
+  }
+
+  if (bank->interpolate)
+  {
+    bank->deltas.resize(bank->phases * taps);
+    for (int i = 0; i < bank->phases * taps; i++)
+      bank->deltas[i] = bank->coefs[i + taps] - bank->coefs[i];
+  }
+
+  CLog::Log(LOGDEBUG,
+            "CActiveAEResamplePolyphase::{} - {} to {} Hz, {} taps, {} phases, cutoff {:.3f}",
+            __FUNCTION__, srcRate, dstRate, taps, bank->phases, cutoff);
+
+  banks[key] = bank;
+  return bank;
+}
+
+CActiveAEResamplePolyphase::CActiveAEResamplePolyphase()
+{
+  m_simd = CAEUtil::GetSIMD();
+}
+
+CActiveAEResamplePolyphase::~CActiveAEResamplePolyphase() = default;
+
+bool CActiveAEResamplePolyphase::Init(SampleConfig dstConfig, SampleConfig srcConfig, bool upmix, bool normalize, double centerMix,
+                                      CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
+{
+  m_src_rate = srcConfig.sample_rate;
+  m_dst_rate = dstConfig.sample_rate;
+  m_channels = dstConfig.channels;
+
+  m_direct.reset(new CActiveAEResampleFFMPEG());
+  if (!m_direct->Init(dstConfig, srcConfig, upmix, normalize, centerMix, remapLayout, quality,
+                      force_resample))
+    return false;
+
+  // the filters only write float, leave anything else to swresample
+  if (dstConfig.fmt != AV_SAMPLE_FMT_FLT && dstConfig.fmt != AV_SAMPLE_FMT_FLTP)
+  {
+    CLog::Log(LOGDEBUG, "CActiveAEResamplePolyphase::Init - output isn't float, using swresample");
+    return true;
+  }
+  m_planar = dstConfig.fmt == AV_SAMPLE_FMT_FLTP;
+
+  SampleConfig convertConfig = dstConfig;
+  convertConfig.fmt = AV_SAMPLE_FMT_FLTP;
+  convertConfig.sample_rate = srcConfig.sample_rate;
+  m_convert.reset(new CActiveAEResampleFFMPEG());
+  if (!m_convert->Init(convertConfig, srcConfig, upmix, normalize, centerMix, remapLayout, quality,
+                       force_resample))
+    return false;
+
+  m_bank = GetFilterBank(quality, m_src_rate, m_dst_rate);
+  m_coefs.resize(m_bank->taps);
+  m_history.resize(m_channels);
+  m_historyPlanes.resize(m_channels);
+  m_doesResample = m_src_rate != m_dst_rate;
+  ResetHistory();
+  return true;
+}
+
+void CActiveAEResamplePolyphase::ResetHistory()
+{
+  // start with the taps before the first sample silent
+  const int half = m_bank->taps / 2;
+  for (auto &plane : m_history)
+  {
+    if (plane.size() < static_cast<size_t>(half))
+      plane.resize(half);
+    std::fill(plane.begin(), plane.begin() + half - 1, 0.0f);
+  }
+  m_historyLen = half - 1;
+  m_position = half - 1;
+  m_padding = 0;
+}
+
+void CActiveAEResamplePolyphase::KeepHistory(uint8_t **buffer, int samples)
+{
+  // swresample output at the same rate is the converted input, the taps before the next sample
+  const int keep = std::min(samples, m_historyLen);
+  for (int ch = 0; ch < m_channels; ch++)
+  {
+    float *plane = m_history[ch].data();
+    memmove(plane, plane + keep, (m_historyLen - keep) * sizeof(float));
+    float *last = plane + m_historyLen - keep;
+    for (int i = samples - keep; i < samples; i++)
+    {
+      if (m_planar)
+        *last++ = reinterpret_cast<float*>(buffer[ch])[i];
+      else
+        *last++ = reinterpret_cast<float*>(buffer[0])[i * m_channels + ch];
+    }
+  }
+}
+
+bool CActiveAEResamplePolyphase::AppendInput(uint8_t **src_buffer, int src_samples)
+{
+  for (int ch = 0; ch < m_channels; ch++)
+  {
+    // only grows while the packets get larger, so this doesn't allocate in the long run
+    if (m_history[ch].size() < static_cast<size_t>(m_historyLen + src_samples))
+      m_history[ch].resize(m_historyLen + src_samples);
+    m_historyPlanes[ch] = reinterpret_cast<uint8_t*>(m_history[ch].data() + m_historyLen);
+  }
+
+  int converted =
+      m_convert->Resample(m_historyPlanes.data(), src_samples, src_buffer, src_samples, 1.0);
+  if (converted < 0)
+    return false;
+
+  m_historyLen += converted;
+  m_padding = 0;
+  return true;
+}
+
+int CActiveAEResamplePolyphase::Filter(uint8_t **dst_buffer, int dst_samples, double step)
+{
+  const FilterBank &bank = *m_bank;
+  const int taps = bank.taps;
+  const int half = taps / 2;
+  int out = 0;
+
+  while (out < dst_samples)
+  {
+    const int pos = static_cast<int>(m_position);
+    if (pos + half >= m_historyLen)
+      break;
+
+    const double phase = (m_position - pos) * bank.phases;
+    const float *coefs;
+    if (bank.interpolate)
+    {
+      const int p = static_cast<int>(phase);
+      memcpy(m_coefs.data(), &bank.coefs[p * taps], taps * sizeof(float));
+      CAEUtil::MulAddArray(m_simd, m_coefs.data(), &bank.deltas[p * taps],
+                           static_cast<float>(phase - p), taps);
+      coefs = m_coefs.data();
+    }
+    else
+      coefs = &bank.coefs[static_cast<int>(phase + 0.5) * taps];
+
+    const int first = pos - half + 1;
+    for (int ch = 0; ch < m_channels; ch++)
+    {
+      const float sample = CAEUtil::DotProduct(m_simd, coefs, m_history[ch].data() + first, taps);
+      if (m_planar)
+        reinterpret_cast<float*>(dst_buffer[ch])[out] = sample;
+      else
+        reinterpret_cast<float*>(dst_buffer[0])[out * m_channels + ch] = sample;
+    }
+
+    out++;
+    m_position += step;
+  }
+
+  // drop the samples no filter will reach again
+  int consumed = std::min(static_cast<int>(m_position) - (half - 1), m_historyLen);
+  if (consumed > 0)
+  {
+    for (auto &plane : m_history)
+      memmove(plane.data(), plane.data() + consumed, (m_historyLen - consumed) * sizeof(float));
+    m_historyLen -= consumed;
+    m_position -= consumed;
+  }
+
+  return out;
+}
+
+int CActiveAEResamplePolyphase::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
+{
+  if (!m_convert)
+    return m_direct->Resample(dst_buffer, dst_samples, src_buffer, src_samples, ratio);
+
+  // same rate, nothing to do for the filters until the ratio moves, they continue from
+  // the last samples then
+  if (ratio != 1.0)
+    m_doesResample = true;
+  if (!m_doesResample)
+  {
+    int out = m_direct->Resample(dst_buffer, dst_samples, src_buffer, src_samples, 1.0);
+    if (out > 0)
+      KeepHistory(dst_buffer, out);
+    return out;
+  }
+
+  bool hasInput = src_buffer && src_samples > 0;
+  if (hasInput && !AppendInput(src_buffer, src_samples))
+  {
+    CLog::Log(LOGERROR, "CActiveAEResamplePolyphase::Resample - convert failed");
+    return -1;
+  }
+
+  const double step = static_cast<double>(m_src_rate) / m_dst_rate / ratio;
+  int out = Filter(dst_buffer, dst_samples, step);
+
+  // without input the remaining samples are flushed, the filters need silence after them
+  if (out == 0 && !hasInput && m_padding == 0 && GetPending() > 0)
+  {
+    m_padding = m_bank->taps / 2;
+    for (int ch = 0; ch < m_channels; ch++)
+    {
+      if (m_history[ch].size() < static_cast<size_t>(m_historyLen + m_padding))
+        m_history[ch].resize(m_historyLen + m_padding);
+      std::fill(m_history[ch].begin() + m_historyLen,
+                m_history[ch].begin() + m_historyLen + m_padding, 0.0f);
+    }
+    m_historyLen += m_padding;
+    out = Filter(dst_buffer, dst_samples, step);
+  }
+
+  return out;
+}
+
+bool CActiveAEResamplePolyphase::Flush()
+{
+  if (!m_direct || !m_direct->Flush())
+    return false;
+  if (!m_convert)
+    return true;
+
+  if (!m_convert->Flush())
+    return false;
+  m_doesResample = m_src_rate != m_dst_rate;
+  ResetHistory();
+  return true;
+}
+
+double CActiveAEResamplePolyphase::GetPending() const
+{
+  return std::max(0.0, m_historyLen - m_padding - m_position);
+}
+
+int64_t CActiveAEResamplePolyphase::GetDelay(int64_t base)
+{
+  if (!m_convert || !m_doesResample)
+    return m_direct->GetDelay(base);
+
+  return static_cast<int64_t>(GetPending() * base / m_src_rate);
+}
+
+int CActiveAEResamplePolyphase::GetBufferedSamples()
+{
+  if (!m_convert || !m_doesResample)
+    return m_direct->GetBufferedSamples();
+
+  return static_cast<int>(std::ceil(GetPending() * m_dst_rate / m_src_rate));
+}
+
+int CActiveAEResamplePolyphase::CalcDstSampleCount(int src_samples, int dst_rate, int src_rate)
+{
+  return m_direct->CalcDstSampleCount(src_samples, dst_rate, src_rate);
+}
+
+int CActiveAEResamplePolyphase::GetSrcBufferSize(int samples)
+{
+  return m_direct->GetSrcBufferSize(samples);
+}
+
+int CActiveAEResamplePolyphase::GetDstBufferSize(int samples)
+{
+  return m_direct->GetDstBufferSize(samples);
+}
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (C) 2010-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <memory>
+#include <vector>
+
+namespace ActiveAE
+{
+
+/**
+ * Rate conversion with a windowed sinc split into a bank of polyphase filters.
+ * The quality level picks the length of the filters and the number of phases,
+ * the inner loops run on the SIMD kernels of CAEUtil.
+ * Sample format and channel conversion are left to swresample at the source rate,
+ * the filters run on planar float. Outputs other than float go through swresample
+ * as a whole.
+ */
+class CActiveAEResamplePolyphase : public IAEResample
+{
+public:
+  const char *GetName() override { return "ActiveAEResamplePolyphase"; }
+  CActiveAEResamplePolyphase();
+  ~CActiveAEResamplePolyphase() override;
+  bool Init(SampleConfig dstConfig, SampleConfig srcConfig, bool upmix, bool normalize, double centerMix,
+            CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample) override;
+  int Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio) override;
+  bool Flush() override;
+  int64_t GetDelay(int64_t base) override;
+  int GetBufferedSamples() override;
+  bool WantsNewSamples(int samples) override { return GetBufferedSamples() <= samples * 2; }
+  int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate) override;
+  int GetSrcBufferSize(int samples) override;
+  int GetDstBufferSize(int samples) override;
+
+  struct FilterBank
+  {
+    int taps;
+    int phases;
+    bool interpolate;
+    // phases + 1 rows of taps, row p is the response at a fraction p / phases past a sample
+    std::vector<float> coefs;
+    // row p + 1 - row p, to interpolate between the phases
+    std::vector<float> deltas;
+  };
+
+  // the banks are computed once for a quality and pair of rates and shared
+  static std::shared_ptr<const FilterBank> GetFilterBank(AEQuality quality, int srcRate, int dstRate);
+
+protected:
+  void ResetHistory();
+  void KeepHistory(uint8_t **buffer, int samples);
+  bool AppendInput(uint8_t **src_buffer, int src_samples);
+  int Filter(uint8_t **dst_buffer, int dst_samples, double step);
+  double GetPending() const;
+
+  // format, layout and matrix at the source rate, to planar float
+  std::unique_ptr<CActiveAEResampleFFMPEG> m_convert;
+  // the whole conversion, as long as there is nothing to resample or the output isn't float
+  std::unique_ptr<CActiveAEResampleFFMPEG> m_direct;
+  std::shared_ptr<const FilterBank> m_bank;
+  CAEUtil::SIMD m_simd;
+
+  int m_src_rate = 0;
+  int m_dst_rate = 0;
+  int m_channels = 0;
+  bool m_planar = true;
+  bool m_doesResample = false;
+
+  // converted input, a plane per channel, and the position of the next output in it
+  std::vector<std::vector<float>> m_history;
+  std::vector<uint8_t*> m_historyPlanes;
+  std::vector<float> m_coefs;
+  int m_historyLen = 0;
+  double m_position = 0;
+  int m_padding = 0;
+};
+
+}
@@ -21,7 +21,6 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_activeAE = ae;
   m_format = *format;
   m_id = streamid;
-  m_bufferedTime = 0;
   m_currentBuffer = NULL;
   m_drain = false;
   m_paused = false;
@@ -40,6 +39,7 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_leftoverBuffer = new uint8_t[m_format.m_frameSize];
   m_leftoverBytes = 0;
   m_forceResampler = false;
+  m_lowLatency = false;
   m_remapper = NULL;
   m_remapBuffer = NULL;
   m_streamResampleRatio = 1.0;
@@ -297,21 +297,21 @@ unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int o
         m_currentBuffer->centerMixLevel = extData->centerMixLevel;
 
       bool rawPktComplete = false;
+      double addedTime;
+      if (m_format.m_dataFormat != AE_FMT_RAW)
       {
-        CSingleLock lock(m_statsLock);
-        if (m_format.m_dataFormat != AE_FMT_RAW)
-        {
-          m_currentBuffer->pkt->nb_samples += minFrames;
-          m_bufferedTime +=
-              static_cast<float>(minFrames) / m_currentBuffer->pkt->config.sample_rate;
-        }
-        else
-        {
-          m_bufferedTime += static_cast<float>(m_format.m_streamInfo.GetDuration()) / 1000;
-          m_currentBuffer->pkt->nb_samples += minFrames;
-          rawPktComplete = true;
-        }
+        m_currentBuffer->pkt->nb_samples += minFrames;
+        addedTime = static_cast<double>(minFrames) / m_currentBuffer->pkt->config.sample_rate;
+      }
+      else
+      {
+        addedTime = m_format.m_streamInfo.GetDuration() / 1000;
+        m_currentBuffer->pkt->nb_samples += minFrames;
+        rawPktComplete = true;
       }
+      // only added to here, published before the buffer is sent to the engine
+      m_addedTime.store(m_addedTime.load(std::memory_order_relaxed) + addedTime,
+                        std::memory_order_release);
 
       if (m_currentBuffer->pkt->nb_samples == m_currentBuffer->pkt->max_nb_samples || rawPktComplete)
       {
@@ -668,6 +668,11 @@ void CActiveAEStreamBuffers::ConfigureResampler(bool normalizelevels, bool stere
   m_resampleBuffers->ConfigureResampler(normalizelevels, stereoupmix, quality);
 }
 
+void CActiveAEStreamBuffers::SetFactoryFlags(uint32_t flags)
+{
+  m_resampleBuffers->SetFactoryFlags(flags);
+}
+
 float CActiveAEStreamBuffers::GetDelay()
 {
   float delay = 0;
@@ -761,6 +766,12 @@ void CActiveAEStreamBuffers::ForceResampler(bool force)
   m_resampleBuffers->ForceResampler(force);
 }
 
+void CActiveAEStreamBuffers::SetCache(CActiveAEBufferCache *cache)
+{
+  m_resampleBuffers->SetCache(cache);
+  m_atempoBuffers->SetCache(cache);
+}
+
 CActiveAEBufferPool* CActiveAEStreamBuffers::GetResampleBuffers()
 {
   CActiveAEBufferPool *ret = m_resampleBuffers;
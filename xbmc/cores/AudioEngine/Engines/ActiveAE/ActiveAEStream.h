@@ -100,6 +100,7 @@ public:
   void SetExtraData(int profile, enum AVMatrixEncoding matrix_encoding, enum AVAudioServiceType audio_service_type);
   bool ProcessBuffers();
   void ConfigureResampler(bool normalizelevels, bool stereoupmix, AEQuality quality);
+  void SetFactoryFlags(uint32_t flags);
   bool HasInputLevel(int level);
   float GetDelay();
   void Flush();
@@ -111,6 +112,7 @@ public:
   bool DoesNormalize();
   void ForceResampler(bool force);
   bool HasWork();
+  void SetCache(CActiveAEBufferCache *cache);
   CActiveAEBufferPool *GetResampleBuffers();
   CActiveAEBufferPool *GetAtempoBuffers();
 
@@ -202,7 +204,11 @@ protected:
   bool m_streamIsFlushed;
   IAEStream *m_streamSlave;
   CCriticalSection m_streamLock;
-  CCriticalSection m_statsLock;
+  // time of the samples added, summed up over the life of the stream
+  std::atomic<double> m_addedTime{0.0};
+  // written by the engine, read by GetDelay and friends without locking
+  CAESpinSection m_statsSection;
+  CEngineStats::StreamStats m_stats;
   uint8_t *m_leftoverBuffer;
   int m_leftoverBytes;
   CSampleBuffer *m_currentBuffer;
@@ -225,7 +231,6 @@ protected:
   float m_volume;
   float m_rgain;
   float m_amplify;
-  float m_bufferedTime;
   int m_fadingSamples;
   float m_fadingBase;
   float m_fadingTarget;
@@ -237,6 +242,7 @@ protected:
   enum AVMatrixEncoding m_matrixEncoding;
   enum AVAudioServiceType m_audioServiceType;
   bool m_forceResampler;
+  bool m_lowLatency;
   IAEClockCallback *m_pClock;
   CSyncError m_syncError;
   double m_lastSyncError;
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+
+#include <set>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+
+AEAudioFormat Format(AEDataFormat dataFormat, unsigned int sampleRate, unsigned int frames)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = dataFormat;
+  format.m_sampleRate = sampleRate;
+  format.m_channelLayout = AE_CH_LAYOUT_5_1;
+  format.m_frames = frames;
+  format.m_frameSize = format.m_channelLayout.Count() * 4;
+  return format;
+}
+
+} // namespace
+
+TEST(TestActiveAEBuffer, CacheReusesBuffers)
+{
+  CActiveAEBufferCache cache;
+
+  auto pool = new CActiveAEBufferPool(Format(AE_FMT_FLOAT, 48000, 1024));
+  pool->SetCache(&cache);
+  pool->Create(200);
+  std::set<CSampleBuffer*> buffers(pool->m_allSamples.begin(), pool->m_allSamples.end());
+  EXPECT_EQ(0, cache.m_buffersReused);
+  EXPECT_EQ(static_cast<int>(buffers.size()), cache.m_buffersAllocated);
+  delete pool;
+
+  // same memory layout at another rate takes the buffers of the old pool
+  cache.ResetStats();
+  pool = new CActiveAEBufferPool(Format(AE_FMT_FLOAT, 44100, 1024));
+  pool->SetCache(&cache);
+  pool->Create(200);
+  EXPECT_EQ(0, cache.m_buffersAllocated);
+  for (auto buffer : pool->m_allSamples)
+  {
+    EXPECT_EQ(1u, buffers.count(buffer));
+    EXPECT_EQ(pool, buffer->pool);
+    EXPECT_EQ(44100, buffer->pkt->config.sample_rate);
+    EXPECT_EQ(0, buffer->pkt->nb_samples);
+  }
+
+  CSampleBuffer* buffer = pool->GetFreeBuffer();
+  ASSERT_NE(nullptr, buffer);
+  buffer->pkt->nb_samples = 1024;
+  buffer->Return();
+  EXPECT_EQ(0, buffer->pkt->nb_samples);
+  delete pool;
+
+  // another sample format can't use them
+  cache.ResetStats();
+  pool = new CActiveAEBufferPool(Format(AE_FMT_FLOATP, 48000, 1024));
+  pool->SetCache(&cache);
+  pool->Create(200);
+  EXPECT_EQ(0, cache.m_buffersReused);
+  delete pool;
+}
+
+TEST(TestActiveAEBuffer, CacheStaysWithinBudget)
+{
+  CActiveAEBufferCache cache;
+
+  // five buffers of two seconds of 5.1 float are well beyond the budget
+  auto pool = new CActiveAEBufferPool(Format(AE_FMT_FLOAT, 48000, 96000));
+  pool->SetCache(&cache);
+  pool->Create(200);
+  delete pool;
+
+  pool = new CActiveAEBufferPool(Format(AE_FMT_FLOAT, 48000, 1024));
+  pool->SetCache(&cache);
+  pool->Create(200);
+  delete pool;
+
+  // the format used last is kept
+  cache.Trim();
+  cache.ResetStats();
+  pool = new CActiveAEBufferPool(Format(AE_FMT_FLOAT, 48000, 1024));
+  pool->SetCache(&cache);
+  pool->Create(200);
+  EXPECT_EQ(0, cache.m_buffersAllocated);
+  delete pool;
+
+  cache.ResetStats();
+  pool = new CActiveAEBufferPool(Format(AE_FMT_FLOAT, 48000, 96000));
+  pool->SetCache(&cache);
+  pool->Create(200);
+  EXPECT_EQ(0, cache.m_buffersReused);
+  delete pool;
+}
+
+TEST(TestActiveAEBuffer, CacheReusesResamplers)
+{
+  CActiveAEBufferCache cache;
+  AEAudioFormat input = Format(AE_FMT_FLOAT, 44100, 940);
+  AEAudioFormat output = Format(AE_FMT_FLOAT, 48000, 1024);
+
+  auto pool = new CActiveAEBufferPoolResample(input, output, AE_QUALITY_MID);
+  pool->SetCache(&cache);
+  pool->Create(200, false, false);
+  EXPECT_EQ(1, cache.m_resamplersCreated);
+  delete pool;
+
+  cache.ResetStats();
+  pool = new CActiveAEBufferPoolResample(input, output, AE_QUALITY_MID);
+  pool->SetCache(&cache);
+  pool->Create(200, false, false);
+  EXPECT_EQ(1, cache.m_resamplersReused);
+  EXPECT_EQ(0, cache.m_resamplersCreated);
+
+  // a flush keeps the resampler
+  pool->Flush();
+  EXPECT_EQ(1, cache.m_resamplersReused);
+  EXPECT_EQ(0, cache.m_resamplersCreated);
+  delete pool;
+
+  // other quality, other filter
+  cache.ResetStats();
+  pool = new CActiveAEBufferPoolResample(input, output, AE_QUALITY_HIGH);
+  pool->SetCache(&cache);
+  pool->Create(200, false, false);
+  EXPECT_EQ(0, cache.m_resamplersReused);
+  EXPECT_EQ(1, cache.m_resamplersCreated);
+  delete pool;
+}
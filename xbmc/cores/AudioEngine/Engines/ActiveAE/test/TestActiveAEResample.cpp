@@ -0,0 +1,299 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/AEResampleFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResamplePolyphase.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+
+constexpr int CHUNK = 1024;
+
+class CTestResamplePolyphase : public CActiveAEResamplePolyphase
+{
+public:
+  bool UsesFilters() const { return m_convert != nullptr; }
+};
+
+SampleConfig Config(AVSampleFormat fmt, const CAEChannelInfo& layout, int sampleRate)
+{
+  SampleConfig config;
+  config.fmt = fmt;
+  config.channel_layout = CAEUtil::GetAVChannelLayout(layout);
+  config.channels = layout.Count();
+  config.sample_rate = sampleRate;
+  config.bits_per_sample = fmt == AV_SAMPLE_FMT_S16 ? 16 : 32;
+  config.dither_bits = 0;
+  return config;
+}
+
+bool Init(ActiveAE::IAEResample& resampler,
+          AVSampleFormat dstFmt,
+          const CAEChannelInfo& layout,
+          int dstRate,
+          int srcRate,
+          AEQuality quality)
+{
+  return resampler.Init(Config(dstFmt, layout, dstRate),
+                        Config(AV_SAMPLE_FMT_FLTP, layout, srcRate), false, false, 1.0, nullptr,
+                        quality, false);
+}
+
+class CPlanes
+{
+public:
+  CPlanes(int channels, int samples) : m_data(channels, std::vector<float>(samples))
+  {
+    for (auto& plane : m_data)
+      m_planes.push_back(reinterpret_cast<uint8_t*>(plane.data()));
+  }
+  uint8_t** Get() { return m_planes.data(); }
+  float* operator[](int ch) { return m_data[ch].data(); }
+
+private:
+  std::vector<std::vector<float>> m_data;
+  std::vector<uint8_t*> m_planes;
+};
+
+// runs a sine through the resampler in packets and drains it, returns the first channel
+std::vector<float> ResampleSine(ActiveAE::IAEResample& resampler,
+                                int channels,
+                                int srcRate,
+                                int srcSamples,
+                                double ratio = 1.0)
+{
+  const double freq = 1000.0;
+  CPlanes src(channels, CHUNK);
+  CPlanes dst(channels, CHUNK * 4);
+  std::vector<float> out;
+
+  for (int done = 0; done < srcSamples; done += CHUNK)
+  {
+    int samples = std::min(CHUNK, srcSamples - done);
+    for (int ch = 0; ch < channels; ch++)
+    {
+      for (int i = 0; i < samples; i++)
+        src[ch][i] = static_cast<float>(0.5 * std::sin(2 * M_PI * freq * (done + i) / srcRate));
+    }
+    int got = resampler.Resample(dst.Get(), CHUNK * 4, src.Get(), samples, ratio);
+    EXPECT_GE(got, 0);
+    out.insert(out.end(), dst[0], dst[0] + std::max(got, 0));
+  }
+
+  int got;
+  while ((got = resampler.Resample(dst.Get(), CHUNK * 4, nullptr, 0, ratio)) > 0)
+    out.insert(out.end(), dst[0], dst[0] + got);
+
+  return out;
+}
+
+} // namespace
+
+TEST(TestActiveAEResample, FilterBank)
+{
+  auto bank = CActiveAEResamplePolyphase::GetFilterBank(AE_QUALITY_MID, 44100, 48000);
+  ASSERT_NE(nullptr, bank);
+  EXPECT_EQ(0, bank->taps % 8);
+  EXPECT_TRUE(bank->interpolate);
+  ASSERT_EQ(static_cast<size_t>((bank->phases + 1) * bank->taps), bank->coefs.size());
+  ASSERT_EQ(static_cast<size_t>(bank->phases * bank->taps), bank->deltas.size());
+
+  for (int p = 0; p <= bank->phases; p++)
+  {
+    double sum = 0;
+    for (int k = 0; k < bank->taps; k++)
+      sum += bank->coefs[p * bank->taps + k];
+    EXPECT_NEAR(1.0, sum, 1e-5) << "phase " << p;
+  }
+
+  // the same bank is handed to every resampler of that quality and rates
+  EXPECT_EQ(bank, CActiveAEResamplePolyphase::GetFilterBank(AE_QUALITY_MID, 44100, 48000));
+
+  // going down in rate needs longer filters
+  auto down = CActiveAEResamplePolyphase::GetFilterBank(AE_QUALITY_MID, 96000, 48000);
+  EXPECT_EQ(bank->taps * 2, down->taps);
+
+  auto low = CActiveAEResamplePolyphase::GetFilterBank(AE_QUALITY_LOW, 44100, 48000);
+  EXPECT_FALSE(low->interpolate);
+  EXPECT_TRUE(low->deltas.empty());
+  EXPECT_LT(low->taps, bank->taps);
+}
+
+TEST(TestActiveAEResample, Sine)
+{
+  CTestResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, AV_SAMPLE_FMT_FLTP, AE_CH_LAYOUT_2_0, 48000, 44100, AE_QUALITY_MID));
+  EXPECT_TRUE(resampler.UsesFilters());
+
+  const int srcSamples = 44100;
+  std::vector<float> out = ResampleSine(resampler, 2, 44100, srcSamples);
+  EXPECT_NEAR(48000, static_cast<int>(out.size()), 2);
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+
+  // away from the edges the level is kept and the frequency is the same at the new rate
+  float peak = 0;
+  int crossings = 0;
+  for (size_t i = 256; i < out.size() - 256; i++)
+  {
+    peak = std::max(peak, std::abs(out[i]));
+    if ((out[i - 1] < 0) != (out[i] < 0))
+      crossings++;
+  }
+  EXPECT_NEAR(0.5f, peak, 0.005f);
+  const double seconds = static_cast<double>(out.size() - 512) / 48000;
+  EXPECT_NEAR(2 * 1000 * seconds, crossings, 2);
+}
+
+TEST(TestActiveAEResample, Flush)
+{
+  CTestResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, AV_SAMPLE_FMT_FLTP, AE_CH_LAYOUT_2_0, 48000, 44100, AE_QUALITY_HIGH));
+
+  CPlanes src(2, CHUNK);
+  CPlanes dst(2, CHUNK * 2);
+  for (int ch = 0; ch < 2; ch++)
+  {
+    for (int i = 0; i < CHUNK; i++)
+      src[ch][i] = static_cast<float>(std::sin(0.1 * i));
+  }
+
+  int first = resampler.Resample(dst.Get(), CHUNK * 2, src.Get(), CHUNK, 1.0);
+  ASSERT_GT(first, 0);
+  std::vector<float> expected(dst[0], dst[0] + first);
+  EXPECT_GT(resampler.GetBufferedSamples(), 0);
+  EXPECT_GT(resampler.GetDelay(48000), 0);
+
+  // a flush forgets the pending samples, the same input gives the same output again
+  EXPECT_TRUE(resampler.Flush());
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+  int second = resampler.Resample(dst.Get(), CHUNK * 2, src.Get(), CHUNK, 1.0);
+  ASSERT_EQ(first, second);
+  for (int i = 0; i < second; i++)
+    EXPECT_EQ(expected[i], dst[0][i]) << "sample " << i;
+}
+
+TEST(TestActiveAEResample, SyncRatio)
+{
+  // same rates, the filters only kick in once the ratio moves
+  CTestResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, AV_SAMPLE_FMT_FLTP, AE_CH_LAYOUT_2_0, 48000, 48000, AE_QUALITY_MID));
+
+  std::vector<float> out = ResampleSine(resampler, 2, 48000, 48000, 1.01);
+  EXPECT_NEAR(48000 * 1.01, static_cast<double>(out.size()), 2);
+}
+
+TEST(TestActiveAEResample, SyncRatioStartsSeamless)
+{
+  // the filters take over from swresample when the ratio first moves
+  CTestResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, AV_SAMPLE_FMT_FLTP, AE_CH_LAYOUT_2_0, 48000, 48000, AE_QUALITY_MID));
+
+  const double freq = 1000.0;
+  CPlanes src(2, CHUNK);
+  CPlanes dst(2, CHUNK * 2);
+  std::vector<float> out;
+  for (int chunk = 0; chunk < 8; chunk++)
+  {
+    for (int ch = 0; ch < 2; ch++)
+    {
+      for (int i = 0; i < CHUNK; i++)
+        src[ch][i] =
+            static_cast<float>(0.5 * std::sin(2 * M_PI * freq * (chunk * CHUNK + i) / 48000));
+    }
+    int got = resampler.Resample(dst.Get(), CHUNK * 2, src.Get(), CHUNK, chunk < 4 ? 1.0 : 1.001);
+    ASSERT_GT(got, 0);
+    out.insert(out.end(), dst[0], dst[0] + got);
+  }
+
+  // no click and no jump in time, the steps stay within the slope of the sine
+  const double maxStep = 0.5 * 2 * M_PI * freq / 48000 * 1.05;
+  for (size_t i = 1; i < out.size(); i++)
+    EXPECT_LE(std::abs(out[i] - out[i - 1]), maxStep) << "sample " << i;
+}
+
+TEST(TestActiveAEResample, FallbackForIntegerOutput)
+{
+  CTestResamplePolyphase resampler;
+  ASSERT_TRUE(Init(resampler, AV_SAMPLE_FMT_S16, AE_CH_LAYOUT_2_0, 48000, 44100, AE_QUALITY_MID));
+  EXPECT_FALSE(resampler.UsesFilters());
+
+  CPlanes src(2, CHUNK);
+  std::vector<int16_t> dst(CHUNK * 2 * 2);
+  uint8_t* dstPlanes[] = {reinterpret_cast<uint8_t*>(dst.data())};
+  int samples = resampler.Resample(dstPlanes, CHUNK * 2, src.Get(), CHUNK, 1.0);
+  EXPECT_GT(samples, 0);
+}
+
+TEST(TestActiveAEResample, Factory)
+{
+  std::unique_ptr<ActiveAE::IAEResample> ffmpeg(CAEResampleFactory::Create());
+  std::unique_ptr<ActiveAE::IAEResample> polyphase(
+      CAEResampleFactory::Create(AERESAMPLEFACTORY_POLYPHASE));
+  EXPECT_STREQ("ActiveAEResampleFFMPEG", ffmpeg->GetName());
+  EXPECT_STREQ("ActiveAEResamplePolyphase", polyphase->GetName());
+}
+
+// 7.1 float with a sync ratio, as when playback is synced to the display
+TEST(TestActiveAEResample, DISABLED_Benchmark)
+{
+  const int channels = 8;
+  const int seconds = 20;
+  const int srcRate = 44100;
+  const struct
+  {
+    AEQuality quality;
+    const char* name;
+  } qualities[] = {{AE_QUALITY_LOW, "low"},
+                   {AE_QUALITY_MID, "mid"},
+                   {AE_QUALITY_HIGH, "high"},
+                   {AE_QUALITY_REALLYHIGH, "really high"}};
+  const struct
+  {
+    uint32_t flags;
+    const char* name;
+  } backends[] = {{0, "swresample"}, {AERESAMPLEFACTORY_POLYPHASE, "polyphase"}};
+
+  CPlanes src(channels, CHUNK);
+  CPlanes dst(channels, CHUNK * 2);
+  for (int ch = 0; ch < channels; ch++)
+  {
+    for (int i = 0; i < CHUNK; i++)
+      src[ch][i] = static_cast<float>(0.5 * std::sin(0.05 * (ch + 1) * i));
+  }
+
+  for (const auto& quality : qualities)
+  {
+    for (const auto& backend : backends)
+    {
+      std::unique_ptr<ActiveAE::IAEResample> resampler(CAEResampleFactory::Create(backend.flags));
+      ASSERT_TRUE(
+          Init(*resampler, AV_SAMPLE_FMT_FLTP, AE_CH_LAYOUT_7_1, 48000, srcRate, quality.quality));
+
+      auto start = std::chrono::steady_clock::now();
+      for (int done = 0; done < srcRate * seconds; done += CHUNK)
+        resampler->Resample(dst.Get(), CHUNK * 2, src.Get(), CHUNK, 1.001);
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+      std::cout << backend.name << ", " << quality.name << " quality: "
+                << us / (channels * seconds) << " us per channel second" << std::endl;
+    }
+  }
+}
@@ -28,6 +28,8 @@ public:
     The sink does NOT have to honour anything in the format struct or the device
     if however it does not honour what is requested, it MUST update device/format
     with what it does support.
+    m_frames asks for short periods of about that many frames, 0 leaves the
+    period size to the sink.
   */
   virtual bool Initialize  (AEAudioFormat &format, std::string &device) = 0;
 
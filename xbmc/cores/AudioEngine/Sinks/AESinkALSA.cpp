@@ -482,6 +482,7 @@ bool CAESinkALSA::Initialize(AEAudioFormat &format, std::string &device)
   ALSAConfig inconfig, outconfig;
   inconfig.format = format.m_dataFormat;
   inconfig.sampleRate = format.m_sampleRate;
+  inconfig.periodSize = format.m_frames;
 
   /*
    * We can't use the better GetChannelLayout() at this point as the device
@@ -726,6 +727,13 @@ bool CAESinkALSA::InitializeHW(const ALSAConfig &inconfig, ALSAConfig &outconfig
   periodSize  = std::min(periodSize, (snd_pcm_uframes_t) sampleRate / 20);
   bufferSize  = std::min(bufferSize, (snd_pcm_uframes_t) sampleRate / 5);
 
+  /* low latency was asked for, keep to 4 of the periods wanted */
+  if (inconfig.periodSize)
+  {
+    periodSize = std::min(periodSize, (snd_pcm_uframes_t) inconfig.periodSize);
+    bufferSize = std::min(bufferSize, periodSize * 4);
+  }
+
   /*
    According to upstream we should set buffer size first - so make sure it is always at least
    4x period size to not get underruns (some systems seem to have issues with only 2 periods)
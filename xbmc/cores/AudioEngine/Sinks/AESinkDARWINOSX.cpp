@@ -389,8 +389,7 @@ void CAESinkDARWINOSX::GetDelay(AEDelayStatus& status)
 {
   /* lockless way of guaranteeing consistency of tick/delay/buffer,
    * this work since render callback is short and quick and higher
-   * priority compared to this thread, unsigned int are assumed
-   * aligned and having atomic read/write */
+   * priority compared to this thread */
   unsigned int size;
   CAESpinLock lock(m_render_locker);
   do
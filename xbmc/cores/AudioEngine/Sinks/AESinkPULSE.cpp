@@ -903,6 +903,13 @@ bool CAESinkPULSE::Initialize(AEAudioFormat &format, std::string &device)
     // 50ms min packet size
     latency = m_BytesPerSecond / 5;
     process_time = latency / 4;
+
+    // low latency was asked for, keep to 4 of the periods wanted
+    if (format.m_frames && format.m_frames * frameSize < process_time)
+    {
+      process_time = format.m_frames * frameSize;
+      latency = process_time * 4;
+    }
   }
 
   pa_buffer_attr buffer_attr;
@@ -309,6 +309,9 @@ bool CAESinkPipewire::Initialize(AEAudioFormat& format, std::string& device)
   stream->AddListener(pipewire.get());
 
   m_latency = 20; // ms
+  // low latency was asked for
+  if (format.m_frames && format.m_frames * 1000.0 / format.m_sampleRate < m_latency)
+    m_latency = format.m_frames * 1000.0 / format.m_sampleRate;
   uint32_t frames = std::nearbyint((m_latency * format.m_sampleRate) / 1000.0);
   std::string fraction = StringUtils::Format("{}/{}", frames, format.m_sampleRate);
 
@@ -18,11 +18,14 @@
 #include "utils/log.h"
 #include "utils/MemUtils.h"
 
+#include <atomic>
 #include <string.h>
 
 /**
  * This buffer can be used by one read and one write thread at any one time
- * without the risk of data corruption.
+ * without the risk of data corruption. Neither side ever waits for the other,
+ * each only publishes its own counter once it's done with the data, so the
+ * render callback of a sink can read while the engine writes.
  * If you intend to call the Reset() method, please use Locks.
  * All other operations are thread-safe.
  */
@@ -72,8 +75,8 @@ public:
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
+    m_iWritten.store(0, std::memory_order_relaxed);
+    m_iRead.store(0, std::memory_order_relaxed);
     m_iReadPos = 0;
     m_iWritePos = 0;
   }
@@ -206,7 +209,8 @@ public:
       }
     }
     bufferContents[m_iSize*m_planes] = '\0';
-    CLog::Log(LOGDEBUG, "AERingBuffer::Dump()\n{}", bufferContents);
+    CLog::Log(LOGDEBUG, "AERingBuffer::Dump()\n{}",
+              reinterpret_cast<const char*>(bufferContents));
     KODI::MEMORY::AlignedFree(bufferContents);
   }
 
@@ -216,7 +220,9 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    // acquire, the reader must be done with the space before it's written again
+    return m_iSize - (m_iWritten.load(std::memory_order_relaxed) -
+                      m_iRead.load(std::memory_order_acquire));
   }
 
   /**
@@ -225,7 +231,8 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    // acquire, the data written must be visible before it's read
+    return m_iWritten.load(std::memory_order_acquire) - m_iRead.load(std::memory_order_relaxed);
   }
 
   /**
@@ -256,7 +263,7 @@ private:
       m_iWritePos = size - (m_iSize - m_iWritePos);
 
     //we can increase the write count now
-    m_iWritten+=size;
+    m_iWritten.store(m_iWritten.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
   /**
@@ -271,13 +278,14 @@ private:
       m_iReadPos = size - (m_iSize - m_iReadPos);
 
     //we can increase the read count now
-    m_iRead+=size;
+    m_iRead.store(m_iRead.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
   unsigned int m_iReadPos = 0;
   unsigned int m_iWritePos = 0;
-  unsigned int m_iRead = 0;
-  unsigned int m_iWritten = 0;
+  // only written by the reader and the writer respectively
+  std::atomic<unsigned int> m_iRead{0};
+  std::atomic<unsigned int> m_iWritten{0};
   unsigned int m_iSize = 0;
   unsigned int m_planes = 0;
   unsigned char** m_Buffer = nullptr;
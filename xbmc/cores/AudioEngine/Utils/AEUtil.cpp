@@ -10,13 +10,29 @@
 #endif
 
 #include "AEUtil.h"
+#include "ServiceBroker.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
 #include <cassert>
 
 #if defined(HAVE_SSE) && defined(__SSE__)
-#include <xmmintrin.h>
+#include <immintrin.h>
+#define HAS_AE_SSE
+// the AVX kernels are built for the cpus that have it, the rest of kodi isn't
+#if defined(__GNUC__)
+#define HAS_AE_AVX
+#define TARGET_AVX __attribute__((target("avx")))
+#elif defined(_MSC_VER)
+#define HAS_AE_AVX
+#define TARGET_AVX
+#endif
+#endif
+
+#if (defined(__arm__) && defined(HAS_NEON)) || defined(__aarch64__)
+#include <arm_neon.h>
+#define HAS_AE_NEON
 #endif
 
 extern "C" {
@@ -218,106 +234,9 @@ const char* CAEUtil::DataFormatToStr(const enum AEDataFormat dataFormat)
   return formats[dataFormat];
 }
 
-#if defined(HAVE_SSE) && defined(__SSE__)
-void CAEUtil::SSEMulArray(float *data, const float mul, uint32_t count)
-{
-  const __m128 m = _mm_set_ps1(mul);
-
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
-  {
-    data[0] *= mul;
-    ++data;
-    --count;
-  }
-
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
-  {
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_mul_ps (to, m);
-  }
-
-  if (even != count)
-  {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] *= mul;
-    else
-    {
-      __m128 to;
-      if (odd == 2)
-      {
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
-    }
-  }
-}
-
-void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t count)
+namespace
 {
-  const __m128 m = _mm_set_ps1(mul);
-
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)add & 0xF)) && count > 0)
-  {
-    data[0] += add[0] * mul;
-    ++add;
-    ++data;
-    --count;
-  }
-
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4, add+=4)
-  {
-    __m128 ad      = _mm_load_ps(add );
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_add_ps (to, _mm_mul_ps(ad, m));
-  }
-
-  if (even != count)
-  {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] += add[0] * mul;
-    else
-    {
-      __m128 ad;
-      __m128 to;
-      if (odd == 2)
-      {
-        ad = _mm_setr_ps(add [0], add [1], 0, 0);
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        ad = _mm_setr_ps(add [0], add [1], add [2], 0);
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
-    }
-  }
-}
-#endif
-
-inline float CAEUtil::SoftClamp(const float x)
+inline float SoftClamp(const float x)
 {
 #if 1
     /*
@@ -352,85 +271,441 @@ inline float CAEUtil::SoftClamp(const float x)
 #endif
 }
 
-void CAEUtil::ClampArray(float *data, uint32_t count)
+void MulArrayC(float *data, const float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+void MulAddArrayC(float *data, const float *add, const float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] += add[i] * mul;
+}
+
+float DotProductC(const float *a, const float *b, uint32_t count)
+{
+  float sum = 0.0f;
+  for (uint32_t i = 0; i < count; ++i)
+    sum += a[i] * b[i];
+  return sum;
+}
+
+void ClampArrayC(float *data, uint32_t count)
 {
-#if !defined(HAVE_SSE) || !defined(__SSE__)
   for (uint32_t i = 0; i < count; ++i)
     data[i] = SoftClamp(data[i]);
+}
 
-#else
+/* the vector kernels leave the last few samples to the ones above,
+   loads and stores are unaligned, the buffers of ffmpeg are aligned anyway */
+
+#if defined(HAS_AE_SSE)
+void MulArraySSE(float *data, const float mul, uint32_t count)
+{
+  const __m128 m = _mm_set_ps1(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 x0 = _mm_loadu_ps(data + i);
+    __m128 x1 = _mm_loadu_ps(data + i + 4);
+    _mm_storeu_ps(data + i, _mm_mul_ps(x0, m));
+    _mm_storeu_ps(data + i + 4, _mm_mul_ps(x1, m));
+  }
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+
+  MulArrayC(data + i, mul, count - i);
+}
+
+void MulAddArraySSE(float *data, const float *add, const float mul, uint32_t count)
+{
+  const __m128 m = _mm_set_ps1(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 x0 = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    __m128 x1 = _mm_add_ps(_mm_loadu_ps(data + i + 4), _mm_mul_ps(_mm_loadu_ps(add + i + 4), m));
+    _mm_storeu_ps(data + i, x0);
+    _mm_storeu_ps(data + i + 4, x1);
+  }
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m)));
+
+  MulAddArrayC(data + i, add + i, mul, count - i);
+}
+
+void ClampArraySSE(float *data, uint32_t count)
+{
   const __m128 c1 = _mm_set_ps1(27.0f);
-  const __m128 c2 = _mm_set_ps1(27.0f + 9.0f);
+  const __m128 c2 = _mm_set_ps1(9.0f);
+  const __m128 lo = _mm_set_ps1(-3.0f);
+  const __m128 hi = _mm_set_ps1(3.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    /* tanh approx clamp, limited to +-3 where it reaches +-1 */
+    __m128 dt  = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi);
+    __m128 tmp = _mm_mul_ps(dt, dt);
+    __m128 out = _mm_div_ps(_mm_mul_ps(dt, _mm_add_ps(c1, tmp)),
+                            _mm_add_ps(c1, _mm_mul_ps(c2, tmp)));
+    _mm_storeu_ps(data + i, out);
+  }
+
+  ClampArrayC(data + i, count - i);
+}
+
+float DotProductSSE(const float *a, const float *b, uint32_t count)
+{
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  for (; i + 4 <= count; i += 4)
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+  float lanes[4];
+  _mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + DotProductC(a + i, b + i, count - i);
+}
+#endif
+
+#if defined(HAS_AE_AVX)
+TARGET_AVX void MulArrayAVX(float *data, const float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256 x0 = _mm256_loadu_ps(data + i);
+    __m256 x1 = _mm256_loadu_ps(data + i + 8);
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(x0, m));
+    _mm256_storeu_ps(data + i + 8, _mm256_mul_ps(x1, m));
+  }
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+
+  MulArrayC(data + i, mul, count - i);
+}
 
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+TARGET_AVX void MulAddArrayAVX(float *data, const float *add, const float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
   {
-    data[0] = SoftClamp(data[0]);
-    ++data;
-    --count;
+    __m256 x0 = _mm256_add_ps(_mm256_loadu_ps(data + i),
+                              _mm256_mul_ps(_mm256_loadu_ps(add + i), m));
+    __m256 x1 = _mm256_add_ps(_mm256_loadu_ps(data + i + 8),
+                              _mm256_mul_ps(_mm256_loadu_ps(add + i + 8), m));
+    _mm256_storeu_ps(data + i, x0);
+    _mm256_storeu_ps(data + i + 8, x1);
   }
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i),
+                                             _mm256_mul_ps(_mm256_loadu_ps(add + i), m)));
+
+  MulAddArrayC(data + i, add + i, mul, count - i);
+}
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
+TARGET_AVX void ClampArrayAVX(float *data, uint32_t count)
+{
+  const __m256 c1 = _mm256_set1_ps(27.0f);
+  const __m256 c2 = _mm256_set1_ps(9.0f);
+  const __m256 lo = _mm256_set1_ps(-3.0f);
+  const __m256 hi = _mm256_set1_ps(3.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
   {
-    /* tanh approx clamp */
-    __m128 dt = _mm_load_ps(data);
-    __m128 tmp     = _mm_mul_ps(dt, dt);
-    *(__m128*)data = _mm_div_ps(
-      _mm_mul_ps(
-        dt,
-        _mm_add_ps(c1, tmp)
-      ),
-      _mm_add_ps(c2, tmp)
-    );
+    __m256 dt  = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi);
+    __m256 tmp = _mm256_mul_ps(dt, dt);
+    __m256 out = _mm256_div_ps(_mm256_mul_ps(dt, _mm256_add_ps(c1, tmp)),
+                               _mm256_add_ps(c1, _mm256_mul_ps(c2, tmp)));
+    _mm256_storeu_ps(data + i, out);
   }
 
-  if (even != count)
+  ClampArrayC(data + i, count - i);
+}
+
+TARGET_AVX float DotProductAVX(const float *a, const float *b, uint32_t count)
+{
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] = SoftClamp(data[0]);
-    else
+    sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    sum1 = _mm256_add_ps(sum1,
+                         _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+  }
+  for (; i + 8 <= count; i += 8)
+    sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+
+  sum0 = _mm256_add_ps(sum0, sum1);
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+  float lanes[4];
+  _mm_storeu_ps(lanes, sum);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + DotProductC(a + i, b + i, count - i);
+}
+#endif
+
+#if defined(HAS_AE_NEON)
+void MulArrayNEON(float *data, const float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t x0 = vld1q_f32(data + i);
+    float32x4_t x1 = vld1q_f32(data + i + 4);
+    vst1q_f32(data + i, vmulq_n_f32(x0, mul));
+    vst1q_f32(data + i + 4, vmulq_n_f32(x1, mul));
+  }
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+
+  MulArrayC(data + i, mul, count - i);
+}
+
+void MulAddArrayNEON(float *data, const float *add, const float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t x0 = vaddq_f32(vld1q_f32(data + i), vmulq_n_f32(vld1q_f32(add + i), mul));
+    float32x4_t x1 = vaddq_f32(vld1q_f32(data + i + 4), vmulq_n_f32(vld1q_f32(add + i + 4), mul));
+    vst1q_f32(data + i, x0);
+    vst1q_f32(data + i + 4, x1);
+  }
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), vmulq_n_f32(vld1q_f32(add + i), mul)));
+
+  MulAddArrayC(data + i, add + i, mul, count - i);
+}
+
+void ClampArrayNEON(float *data, uint32_t count)
+{
+  const float32x4_t c1 = vdupq_n_f32(27.0f);
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t dt  = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t tmp = vmulq_f32(dt, dt);
+    float32x4_t num = vmulq_f32(dt, vaddq_f32(c1, tmp));
+    float32x4_t den = vaddq_f32(c1, vmulq_n_f32(tmp, 9.0f));
+#if defined(__aarch64__)
+    float32x4_t out = vdivq_f32(num, den);
+#else
+    /* no division on armv7, the estimate is refined twice to full precision */
+    float32x4_t rcp = vrecpeq_f32(den);
+    rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+    rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+    float32x4_t out = vmulq_f32(num, rcp);
+#endif
+    vst1q_f32(data + i, out);
+  }
+
+  ClampArrayC(data + i, count - i);
+}
+
+float DotProductNEON(const float *a, const float *b, uint32_t count)
+{
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  for (; i + 4 <= count; i += 4)
+    sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+
+  float lanes[4];
+  vst1q_f32(lanes, vaddq_f32(sum0, sum1));
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + DotProductC(a + i, b + i, count - i);
+}
+#endif
+} // namespace
+
+void CAEUtil::MulArray(float *data, const float mul, uint32_t count)
+{
+  MulArray(GetSIMD(), data, mul, count);
+}
+
+void CAEUtil::MulAddArray(float *data, const float *add, const float mul, uint32_t count)
+{
+  MulAddArray(GetSIMD(), data, add, mul, count);
+}
+
+void CAEUtil::ClampArray(float *data, uint32_t count)
+{
+  ClampArray(GetSIMD(), data, count);
+}
+
+float CAEUtil::DotProduct(const float *a, const float *b, uint32_t count)
+{
+  return DotProduct(GetSIMD(), a, b, count);
+}
+
+void CAEUtil::MulArray(SIMD simd, float *data, const float mul, uint32_t count)
+{
+  switch (simd)
+  {
+#if defined(HAS_AE_SSE)
+    case SIMD::SSE:
+      MulArraySSE(data, mul, count);
+      break;
+#endif
+#if defined(HAS_AE_AVX)
+    case SIMD::AVX:
+      MulArrayAVX(data, mul, count);
+      break;
+#endif
+#if defined(HAS_AE_NEON)
+    case SIMD::NEON:
+      MulArrayNEON(data, mul, count);
+      break;
+#endif
+    default:
+      MulArrayC(data, mul, count);
+      break;
+  }
+}
+
+void CAEUtil::MulAddArray(SIMD simd, float *data, const float *add, const float mul, uint32_t count)
+{
+  switch (simd)
+  {
+#if defined(HAS_AE_SSE)
+    case SIMD::SSE:
+      MulAddArraySSE(data, add, mul, count);
+      break;
+#endif
+#if defined(HAS_AE_AVX)
+    case SIMD::AVX:
+      MulAddArrayAVX(data, add, mul, count);
+      break;
+#endif
+#if defined(HAS_AE_NEON)
+    case SIMD::NEON:
+      MulAddArrayNEON(data, add, mul, count);
+      break;
+#endif
+    default:
+      MulAddArrayC(data, add, mul, count);
+      break;
+  }
+}
+
+void CAEUtil::ClampArray(SIMD simd, float *data, uint32_t count)
+{
+  switch (simd)
+  {
+#if defined(HAS_AE_SSE)
+    case SIMD::SSE:
+      ClampArraySSE(data, count);
+      break;
+#endif
+#if defined(HAS_AE_AVX)
+    case SIMD::AVX:
+      ClampArrayAVX(data, count);
+      break;
+#endif
+#if defined(HAS_AE_NEON)
+    case SIMD::NEON:
+      ClampArrayNEON(data, count);
+      break;
+#endif
+    default:
+      ClampArrayC(data, count);
+      break;
+  }
+}
+
+float CAEUtil::DotProduct(SIMD simd, const float *a, const float *b, uint32_t count)
+{
+  switch (simd)
+  {
+#if defined(HAS_AE_SSE)
+    case SIMD::SSE:
+      return DotProductSSE(a, b, count);
+#endif
+#if defined(HAS_AE_AVX)
+    case SIMD::AVX:
+      return DotProductAVX(a, b, count);
+#endif
+#if defined(HAS_AE_NEON)
+    case SIMD::NEON:
+      return DotProductNEON(a, b, count);
+#endif
+    default:
+      return DotProductC(a, b, count);
+  }
+}
+
+bool CAEUtil::SupportsSIMD(SIMD simd)
+{
+  const auto cpuInfo = CServiceBroker::GetCPUInfo();
+  const unsigned int features = cpuInfo ? cpuInfo->GetCPUFeatures() : 0;
+  (void)features;
+
+  switch (simd)
+  {
+    case SIMD::NONE:
+      return true;
+#if defined(HAS_AE_SSE)
+    case SIMD::SSE:
+      return (features & CPU_FEATURE_SSE) != 0;
+#endif
+#if defined(HAS_AE_AVX)
+    case SIMD::AVX:
+      return (features & CPU_FEATURE_AVX) != 0;
+#endif
+#if defined(HAS_AE_NEON)
+    case SIMD::NEON:
+#if defined(__aarch64__)
+      return true;
+#else
+      return (features & CPU_FEATURE_NEON) != 0;
+#endif
+#endif
+    default:
+      return false;
+  }
+}
+
+CAEUtil::SIMD CAEUtil::GetSIMD()
+{
+  static const SIMD simd = []() {
+    for (SIMD candidate : {SIMD::AVX, SIMD::SSE, SIMD::NEON})
     {
-      __m128 dt;
-      __m128 tmp;
-      __m128 out;
-      if (odd == 2)
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], 0, 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-      }
-      else
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], data[2], 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-        data[2] = ((float*)&out)[2];
-      }
+      if (SupportsSIMD(candidate))
+        return candidate;
     }
+    return SIMD::NONE;
+  }();
+  return simd;
+}
+
+const char* CAEUtil::SIMDToStr(SIMD simd)
+{
+  switch (simd)
+  {
+    case SIMD::SSE:
+      return "sse";
+    case SIMD::AVX:
+      return "avx";
+    case SIMD::NEON:
+      return "neon";
+    default:
+      return "none";
   }
-#endif
 }
 
 bool CAEUtil::S16NeedsByteSwap(AEDataFormat in, AEDataFormat out)
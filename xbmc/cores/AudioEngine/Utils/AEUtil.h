@@ -10,6 +10,8 @@
 
 #include "AEAudioFormat.h"
 #include "PlatformDefs.h"
+
+#include <atomic>
 #include <math.h>
 
 extern "C" {
@@ -36,7 +38,10 @@ struct AEDelayStatus
 /**
  * @brief lockless consistency guaranteeer
  *
- * Requires write to be a higher priority thread
+ * A sequence lock: the writer makes the sequence odd while it updates,
+ * readers copy the data and retry if the sequence was odd or has moved on.
+ * Readers never hold up the writer, there must only be one writer at a time.
+ * The data may be torn while copied, so only copy plain values, no containers.
  *
  * use in writer:
  *   m_locker.enter();
@@ -53,13 +58,19 @@ struct AEDelayStatus
 class CAESpinSection
 {
 public:
-  void enter() { m_enter++; }
-  void leave() { m_leave = m_enter; }
+  void enter()
+  {
+    m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  void leave()
+  {
+    m_sequence.store(m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
 
 protected:
   friend class CAESpinLock;
-  volatile unsigned int m_enter = 0;
-  volatile unsigned int m_leave = 0;
+  std::atomic<unsigned int> m_sequence{0};
 };
 
 class CAESpinLock
@@ -67,15 +78,16 @@ class CAESpinLock
 public:
   explicit CAESpinLock(CAESpinSection& section)
   : m_section(section)
-  , m_begin(section.m_enter)
+  , m_begin(section.m_sequence.load(std::memory_order_acquire))
   {}
 
   bool retry()
   {
-    if(m_section.m_enter != m_begin
-    || m_section.m_enter != m_section.m_leave)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const unsigned int sequence = m_section.m_sequence.load(std::memory_order_relaxed);
+    if ((m_begin & 1) || sequence != m_begin)
     {
-      m_begin = m_section.m_enter;
+      m_begin = m_section.m_sequence.load(std::memory_order_acquire);
       return true;
     }
     else
@@ -89,11 +101,18 @@ private:
 
 class CAEUtil
 {
-private:
-
-  static float SoftClamp(const float x);
-
 public:
+  /*!
+   \brief Instruction sets of the sample processing kernels
+   */
+  enum class SIMD
+  {
+    NONE,
+    SSE,
+    AVX,
+    NEON
+  };
+
   static CAEChannelInfo          GuessChLayout     (const unsigned int channels);
   static const char*             GetStdChLayoutName(const enum AEStdChLayout layout);
   static unsigned int      DataFormatToBits  (const enum AEDataFormat dataFormat);
@@ -160,11 +179,24 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
+  /*! \brief data[i] *= mul, with the kernel picked once for the cpu */
+  static void MulArray(float *data, const float mul, uint32_t count);
+  /*! \brief data[i] += add[i] * mul */
+  static void MulAddArray(float *data, const float *add, const float mul, uint32_t count);
+  /*! \brief soft clip the samples into -1..1 with a tanh-like curve */
   static void ClampArray(float *data, uint32_t count);
+  /*! \brief sum of a[i] * b[i], the order of the additions depends on the kernel */
+  static float DotProduct(const float *a, const float *b, uint32_t count);
+
+  // with the given kernel, it has to be supported by the cpu
+  static void MulArray(SIMD simd, float *data, const float mul, uint32_t count);
+  static void MulAddArray(SIMD simd, float *data, const float *add, const float mul, uint32_t count);
+  static void ClampArray(SIMD simd, float *data, uint32_t count);
+  static float DotProduct(SIMD simd, const float *a, const float *b, uint32_t count);
+
+  static bool SupportsSIMD(SIMD simd);
+  static SIMD GetSIMD();
+  static const char* SIMDToStr(SIMD simd);
 
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
 
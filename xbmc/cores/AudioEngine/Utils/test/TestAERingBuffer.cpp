@@ -0,0 +1,157 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+// byte n of plane p of the stream, the reader checks nothing got lost or duplicated
+unsigned char Pattern(unsigned int n, unsigned int plane)
+{
+  return static_cast<unsigned char>(n * 3 + n / 253 + plane * 101);
+}
+
+// streams bytes through a planar ring, writer and reader use chunk sizes that keep wrapping
+void Stream(unsigned int total, unsigned int loadThreads)
+{
+  const unsigned int planes = 2;
+  AERingBuffer buffer(1008, planes);
+
+  // keep the cores busy so the two threads get preempted in between plane copies
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> load;
+  for (unsigned int i = 0; i < loadThreads; i++)
+    load.emplace_back([&stop]() {
+      volatile unsigned int spin = 0;
+      while (!stop)
+        spin = spin + 1;
+    });
+
+  // failures only end the loops, all threads are joined before checking them
+  std::atomic<bool> writerDone{false};
+  std::atomic<bool> readerDone{false};
+  unsigned int written = 0;
+  std::thread writer([&]() {
+    std::vector<unsigned char> chunk(320);
+    for (unsigned int size = 1; written < total && !readerDone; size = size % 299 + 7)
+    {
+      size = std::min(size, total - written);
+      if (buffer.GetWriteSize() < size)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      bool failed = false;
+      for (unsigned int p = 0; p < planes && !failed; p++)
+      {
+        for (unsigned int i = 0; i < size; i++)
+          chunk[i] = Pattern(written + i, p);
+        failed = buffer.Write(chunk.data(), size, p) != 0;
+      }
+      if (failed)
+        break;
+      written += size;
+    }
+    writerDone = true;
+  });
+
+  std::vector<unsigned char> chunk(320);
+  unsigned int read = 0;
+  unsigned int mismatch = total;
+  unsigned int mismatchPlane = 0;
+  for (unsigned int size = 5; read < total && mismatch == total; size = size % 293 + 11)
+  {
+    size = std::min(size, total - read);
+    if (buffer.GetReadSize() < size)
+    {
+      // the writer may have given up, what it wrote is in the buffer by then
+      if (writerDone && buffer.GetReadSize() < size)
+        break;
+      std::this_thread::yield();
+      continue;
+    }
+    for (unsigned int p = 0; p < planes && mismatch == total; p++)
+    {
+      if (buffer.Read(chunk.data(), size, p) != 0)
+      {
+        mismatch = read;
+        mismatchPlane = p;
+        break;
+      }
+      for (unsigned int i = 0; i < size; i++)
+      {
+        if (chunk[i] != Pattern(read + i, p))
+        {
+          mismatch = read + i;
+          mismatchPlane = p;
+          break;
+        }
+      }
+    }
+    if (mismatch == total)
+      read += size;
+  }
+  readerDone = true;
+
+  writer.join();
+  stop = true;
+  for (auto& thread : load)
+    thread.join();
+
+  EXPECT_EQ(total, mismatch) << "byte " << mismatch << " plane " << mismatchPlane;
+  EXPECT_EQ(total, written);
+  EXPECT_EQ(total, read);
+  if (read == total)
+  {
+    EXPECT_EQ(0u, buffer.GetReadSize());
+    EXPECT_EQ(buffer.GetMaxSize(), buffer.GetWriteSize());
+  }
+}
+
+} // namespace
+
+TEST(TestAERingBuffer, Wrap)
+{
+  AERingBuffer buffer(16);
+  unsigned char data[16];
+  for (int i = 0; i < 16; i++)
+    data[i] = static_cast<unsigned char>(i + 1);
+  unsigned char out[16] = {};
+
+  EXPECT_EQ(1, buffer.Read(out, 1));
+  EXPECT_EQ(0, buffer.Write(data, 12));
+  EXPECT_EQ(2, buffer.Write(data, 6));
+  EXPECT_EQ(0, buffer.Read(out, 10));
+  EXPECT_EQ(0, buffer.Write(data, 12));
+  EXPECT_EQ(14u, buffer.GetReadSize());
+  EXPECT_EQ(3, buffer.Read(out, 16));
+
+  EXPECT_EQ(0, buffer.Read(out, 14));
+  EXPECT_EQ(11, out[0]);
+  EXPECT_EQ(12, out[1]);
+  for (int i = 0; i < 12; i++)
+    EXPECT_EQ(i + 1, out[i + 2]);
+}
+
+TEST(TestAERingBuffer, TwoThreads)
+{
+  Stream(2000000, 0);
+}
+
+TEST(TestAERingBuffer, TwoThreadsUnderLoad)
+{
+  Stream(500000, std::max(2u, std::thread::hardware_concurrency()));
+}
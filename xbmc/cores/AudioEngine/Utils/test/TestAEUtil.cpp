@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/CPUInfo.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+const CAEUtil::SIMD KERNELS[] = {CAEUtil::SIMD::NONE, CAEUtil::SIMD::SSE, CAEUtil::SIMD::AVX,
+                                 CAEUtil::SIMD::NEON};
+
+struct TestAEUtil : public ::testing::Test
+{
+  TestAEUtil() { CServiceBroker::RegisterCPUInfo(CCPUInfo::GetCPUInfo()); }
+
+  ~TestAEUtil() { CServiceBroker::UnregisterCPUInfo(); }
+};
+
+// samples from -4 to 4, beyond the knee of the soft clipper
+std::vector<float> Samples(size_t count, int seed)
+{
+  std::vector<float> samples(count);
+  for (size_t i = 0; i < count; i++)
+    samples[i] = static_cast<float>((i * 37 + seed) % 801) / 100.0f - 4.0f;
+  return samples;
+}
+
+// runs the kernels at odd offsets and lengths, the result has to match the plain c one
+void CheckKernel(CAEUtil::SIMD simd, size_t offset, size_t count)
+{
+  std::vector<float> data = Samples(offset + count + 1, 1);
+  std::vector<float> add = Samples(offset + count, 2);
+  std::vector<float> expected = data;
+  std::vector<float> actual = data;
+
+  // the kernels add up in another order, allow for the rounding of that
+  const float dot = CAEUtil::DotProduct(CAEUtil::SIMD::NONE, data.data() + offset,
+                                        add.data() + offset, count);
+  ASSERT_NEAR(dot, CAEUtil::DotProduct(simd, data.data() + offset, add.data() + offset, count),
+              1e-5f * 16 * (count + 1))
+      << CAEUtil::SIMDToStr(simd);
+
+  CAEUtil::MulArray(CAEUtil::SIMD::NONE, expected.data() + offset, 0.7f, count);
+  CAEUtil::MulArray(simd, actual.data() + offset, 0.7f, count);
+  CAEUtil::MulAddArray(CAEUtil::SIMD::NONE, expected.data() + offset, add.data() + offset, 0.3f,
+                       count);
+  CAEUtil::MulAddArray(simd, actual.data() + offset, add.data() + offset, 0.3f, count);
+  for (size_t i = 0; i < data.size(); i++)
+    ASSERT_FLOAT_EQ(expected[i], actual[i]) << CAEUtil::SIMDToStr(simd) << " sample " << i;
+
+  CAEUtil::ClampArray(CAEUtil::SIMD::NONE, expected.data() + offset, count);
+  CAEUtil::ClampArray(simd, actual.data() + offset, count);
+  for (size_t i = 0; i < data.size(); i++)
+  {
+    ASSERT_NEAR(expected[i], actual[i], 1e-6f) << CAEUtil::SIMDToStr(simd) << " sample " << i;
+    if (i >= offset && i < offset + count)
+    {
+      ASSERT_LE(std::abs(actual[i]), 1.0f);
+    }
+  }
+}
+
+} // namespace
+
+TEST_F(TestAEUtil, Kernels)
+{
+  for (CAEUtil::SIMD simd : KERNELS)
+  {
+    if (!CAEUtil::SupportsSIMD(simd))
+      continue;
+
+    CheckKernel(simd, 0, 0);
+    CheckKernel(simd, 1, 3);
+    CheckKernel(simd, 3, 21);
+    CheckKernel(simd, 0, 1024);
+    CheckKernel(simd, 2, 1031);
+  }
+}
+
+TEST_F(TestAEUtil, Dispatch)
+{
+  EXPECT_TRUE(CAEUtil::SupportsSIMD(CAEUtil::GetSIMD()));
+  CheckKernel(CAEUtil::GetSIMD(), 1, 8 * 1024 + 5);
+}
+
+// a reader of the spin section must never see a half written update
+TEST(TestAESpinLock, TornReads)
+{
+  CAESpinSection section;
+  AEDelayStatus status;
+  std::atomic<bool> done{false};
+  std::atomic<bool> torn{false};
+
+  std::thread writer([&section, &status, &done, &torn]() {
+    for (int64_t i = 1; i <= 1000000 && !torn; i++)
+    {
+      section.enter();
+      status.tick = i;
+      status.delay = static_cast<double>(i) / 1000;
+      status.maxcorrection = static_cast<double>(i) / 500;
+      section.leave();
+    }
+    done = true;
+  });
+
+  // a failure only ends the loop, the writer is joined before checking
+  AEDelayStatus copy;
+  int64_t last = 0;
+  for (bool finished = false; !finished && !torn;)
+  {
+    // one more read after the writer finished, it may be done before the first one
+    finished = done;
+    CAESpinLock lock(section);
+    do
+    {
+      copy = status;
+    } while (lock.retry());
+
+    torn = static_cast<double>(copy.tick) / 1000 != copy.delay ||
+           static_cast<double>(copy.tick) / 500 != copy.maxcorrection || copy.tick < last;
+    if (!torn)
+      last = copy.tick;
+  }
+  writer.join();
+
+  EXPECT_FALSE(torn) << "tick " << copy.tick << " after " << last << ", delay " << copy.delay
+                     << ", maxcorrection " << copy.maxcorrection;
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+TEST_F(TestAEUtil, DISABLED_Throughput)
+{
+  // 7.1 at 192 kHz, one period of 10 ms as mixed by ActiveAE
+  const uint32_t count = 8 * 1920;
+  std::vector<float> data = Samples(count, 1);
+  std::vector<float> add = Samples(count, 2);
+
+  for (CAEUtil::SIMD simd : KERNELS)
+  {
+    if (!CAEUtil::SupportsSIMD(simd))
+      continue;
+
+    const int runs = 20000;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++)
+    {
+      CAEUtil::MulAddArray(simd, data.data(), add.data(), 0.5f, count);
+      CAEUtil::MulArray(simd, data.data(), 0.5f, count);
+      CAEUtil::ClampArray(simd, data.data(), count);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << CAEUtil::SIMDToStr(simd) << ": " << elapsed.count() * 1e6 / runs
+              << " us per period" << std::endl;
+  }
+}
@@ -50,6 +50,18 @@ void CDataCacheCore::Reset()
     m_contentInfo.m_chapters.clear();
     m_contentInfo.m_cutList.clear();
   }
+
+  {
+    CSingleLock lock(m_videoPlayerSection);
+
+    m_playerVideoInfo.queue = SQueueInfo();
+  }
+
+  {
+    CSingleLock lock(m_audioPlayerSection);
+
+    m_playerAudioInfo.queue = SQueueInfo();
+  }
 }
 
 bool CDataCacheCore::HasAVInfoChanges()
@@ -96,6 +108,20 @@ bool CDataCacheCore::IsVideoHwDecoder()
   return m_playerVideoInfo.isHwDecoder;
 }
 
+void CDataCacheCore::SetVideoDecoderThreading(std::string threading)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decoderThreading = std::move(threading);
+}
+
+std::string CDataCacheCore::GetVideoDecoderThreading()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decoderThreading;
+}
+
 
 void CDataCacheCore::SetVideoDeintMethod(std::string method)
 {
@@ -189,6 +215,20 @@ float CDataCacheCore::GetVideoDAR()
   return m_playerVideoInfo.dar;
 }
 
+void CDataCacheCore::SetVideoQueueInfo(const SQueueInfo& info)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.queue = info;
+}
+
+CDataCacheCore::SQueueInfo CDataCacheCore::GetVideoQueueInfo()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.queue;
+}
+
 // player audio info
 void CDataCacheCore::SetAudioDecoderName(std::string name)
 {
@@ -246,6 +286,20 @@ int CDataCacheCore::GetAudioBitsPerSample()
   return m_playerAudioInfo.bitsPerSample;
 }
 
+void CDataCacheCore::SetAudioQueueInfo(const SQueueInfo& info)
+{
+  CSingleLock lock(m_audioPlayerSection);
+
+  m_playerAudioInfo.queue = info;
+}
+
+CDataCacheCore::SQueueInfo CDataCacheCore::GetAudioQueueInfo()
+{
+  CSingleLock lock(m_audioPlayerSection);
+
+  return m_playerAudioInfo.queue;
+}
+
 void CDataCacheCore::SetCutList(const std::vector<EDL::Cut>& cutList)
 {
   CSingleLock lock(m_contentSection);
@@ -270,6 +324,33 @@ std::vector<std::pair<std::string, int64_t>> CDataCacheCore::GetChapters() const
   return m_contentInfo.m_chapters;
 }
 
+// cache info
+void CDataCacheCore::SetCacheInfo(const std::string& path, const SCacheInfo& info)
+{
+  CSingleLock lock(m_cacheSection);
+
+  m_cacheInfo[path] = info;
+}
+
+void CDataCacheCore::ClearCacheInfo(const std::string& path)
+{
+  CSingleLock lock(m_cacheSection);
+
+  m_cacheInfo.erase(path);
+}
+
+bool CDataCacheCore::GetCacheInfo(const std::string& path, SCacheInfo& info)
+{
+  CSingleLock lock(m_cacheSection);
+
+  auto it = m_cacheInfo.find(path);
+  if (it == m_cacheInfo.end())
+    return false;
+
+  info = it->second;
+  return true;
+}
+
 void CDataCacheCore::SetRenderClockSync(bool enable)
 {
   CSingleLock lock(m_renderSection);
@@ -11,6 +11,7 @@
 #include "threads/CriticalSection.h"
 
 #include <atomic>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -31,10 +32,20 @@ public:
   void SignalAudioInfoChange();
   void SignalSubtitleInfoChange();
 
+  // player queue info
+  struct SQueueInfo
+  {
+    int maxDataSize = 0; ///< byte limit of the message queue
+    double maxTimeSize = 0.0; ///< time limit of the message queue in seconds
+    unsigned int bitrate = 0; ///< measured bitrate of the queued stream in bytes per second
+  };
+
   // player video info
   void SetVideoDecoderName(std::string name, bool isHw);
   std::string GetVideoDecoderName();
   bool IsVideoHwDecoder();
+  void SetVideoDecoderThreading(std::string threading);
+  std::string GetVideoDecoderThreading();
   void SetVideoDeintMethod(std::string method);
   std::string GetVideoDeintMethod();
   void SetVideoPixelFormat(std::string pixFormat);
@@ -48,6 +59,8 @@ public:
   float GetVideoFps();
   void SetVideoDAR(float dar);
   float GetVideoDAR();
+  void SetVideoQueueInfo(const SQueueInfo& info);
+  SQueueInfo GetVideoQueueInfo();
 
   // player audio info
   void SetAudioDecoderName(std::string name);
@@ -58,6 +71,8 @@ public:
   int GetAudioSampleRate();
   void SetAudioBitsPerSample(int bitsPerSample);
   int GetAudioBitsPerSample();
+  void SetAudioQueueInfo(const SQueueInfo& info);
+  SQueueInfo GetAudioQueueInfo();
 
   // content info
   void SetCutList(const std::vector<EDL::Cut>& cutList);
@@ -65,6 +80,19 @@ public:
   void SetChapters(const std::vector<std::pair<std::string, int64_t>>& chapters);
   std::vector<std::pair<std::string, int64_t>> GetChapters() const;
 
+  // cache info, per cached file since several caches can be open at once
+  struct SCacheInfo
+  {
+    int64_t readAhead = 0; ///< bytes read ahead of the player at full speed
+    unsigned int throttleRate = 0; ///< fill rate limit beyond the read-ahead, 0 if unlimited
+    unsigned int chunkSize = 0;
+    unsigned int consumptionRate = 0; ///< measured read rate of the player
+    unsigned int deliveryRate = 0; ///< measured rate of the source
+  };
+  void SetCacheInfo(const std::string& path, const SCacheInfo& info);
+  void ClearCacheInfo(const std::string& path);
+  bool GetCacheInfo(const std::string& path, SCacheInfo& info);
+
   // render info
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
@@ -134,6 +162,7 @@ protected:
   {
     std::string decoderName;
     bool isHwDecoder;
+    std::string decoderThreading;
     std::string deintMethod;
     std::string pixFormat;
     std::string stereoMode;
@@ -141,6 +170,7 @@ protected:
     int height;
     float fps;
     float dar;
+    SQueueInfo queue;
   } m_playerVideoInfo;
 
   CCriticalSection m_audioPlayerSection;
@@ -150,6 +180,7 @@ protected:
     std::string channels;
     int sampleRate;
     int bitsPerSample;
+    SQueueInfo queue;
   } m_playerAudioInfo;
 
   mutable CCriticalSection m_contentSection;
@@ -159,6 +190,9 @@ protected:
     std::vector<std::pair<std::string, int64_t>> m_chapters; // name and position for chapters
   } m_contentInfo;
 
+  CCriticalSection m_cacheSection;
+  std::map<std::string, SCacheInfo> m_cacheInfo; ///< keyed by the redacted path
+
   CCriticalSection m_renderSection;
   struct SRenderInfo
   {
@@ -0,0 +1,364 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ChannelPreloader.h"
+
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxPreloaded.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+#include "pvr/PVRManager.h"
+#include "pvr/PVRPlaybackState.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/channels/PVRChannelGroup.h"
+#include "pvr/channels/PVRChannelGroupMember.h"
+#include "pvr/guilib/PVRGUIActions.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JobManager.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+
+using namespace PVR;
+
+namespace
+{
+// a GOP of a high bitrate HD channel
+constexpr size_t MAX_BUFFERED_BYTES = 16 * 1024 * 1024;
+
+// radio channels have no keyframes to start at, keep the last seconds instead
+constexpr double MAX_BUFFERED_AUDIO_TIME = 2.0 * DVD_TIME_BASE;
+
+double GetTime(const DemuxPacket* packet)
+{
+  return packet->dts != DVD_NOPTS_VALUE ? packet->dts : packet->pts;
+}
+
+// wait for the packet being read when switching, a stalled stream is opened again instead
+constexpr unsigned int TAKE_TIMEOUT_MS = 500;
+} // namespace
+
+class CChannelPreloader::CChannel : private CThread
+{
+public:
+  explicit CChannel(const std::shared_ptr<CPVRChannelGroupMember>& groupMember);
+  ~CChannel() override;
+
+  void Start() { Create(); }
+  void Abort();
+  std::pair<int, int> GetStorageId() const { return m_storageId; }
+  bool Take(Stream& stream);
+
+private:
+  void Process() override;
+  bool Open();
+  void Buffer(DemuxPacket* packet);
+  void Drop();
+
+  const std::shared_ptr<CPVRChannelGroupMember> m_groupMember;
+  const std::pair<int, int> m_storageId;
+
+  CCriticalSection m_section;
+  std::shared_ptr<CDVDInputStream> m_inputStream;
+  std::unique_ptr<CDVDDemux> m_demuxer;
+
+  std::deque<DemuxPacket*> m_packets;
+  size_t m_bytes = 0;
+  bool m_hasVideo = false;
+};
+
+CChannelPreloader::CChannel::CChannel(const std::shared_ptr<CPVRChannelGroupMember>& groupMember)
+  : CThread("ChannelPreloader"),
+    m_groupMember(groupMember),
+    m_storageId(groupMember->Channel()->StorageId())
+{
+}
+
+CChannelPreloader::CChannel::~CChannel()
+{
+  Abort();
+  StopThread(true);
+
+  for (DemuxPacket* packet : m_packets)
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+void CChannelPreloader::CChannel::Abort()
+{
+  StopThread(false);
+
+  CSingleLock lock(m_section);
+  if (m_demuxer)
+    m_demuxer->Abort();
+  if (m_inputStream)
+    m_inputStream->Abort();
+}
+
+bool CChannelPreloader::CChannel::Take(Stream& stream)
+{
+  StopThread(false);
+  if (!Join(TAKE_TIMEOUT_MS) || !m_demuxer)
+    return false;
+
+  CLog::Log(LOGDEBUG, "CChannelPreloader - {} - switching to preloaded {}, {} packets buffered",
+            __FUNCTION__, CURL::GetRedacted(m_inputStream->GetFileName()), m_packets.size());
+
+  stream.inputStream = std::move(m_inputStream);
+  stream.demuxer = std::make_unique<CDVDDemuxPreloaded>(std::move(m_demuxer), std::move(m_packets));
+  m_packets.clear();
+  m_bytes = 0;
+  return true;
+}
+
+void CChannelPreloader::CChannel::Process()
+{
+  if (!Open())
+    return;
+
+  while (!m_bStop)
+  {
+    DemuxPacket* packet = m_demuxer->Read();
+    if (packet)
+      Buffer(packet);
+    else if (m_inputStream->IsEOF())
+      break;
+    else
+      Sleep(10);
+  }
+}
+
+bool CChannelPreloader::CChannel::Open()
+{
+  // the item as the pvr gui actions hand it to the player
+  CFileItem item(m_groupMember);
+  CServiceBroker::GetPVRManager().GUIActions()->FillStreamProperties(item);
+  item.SetMimeTypeForInternetFile();
+
+  if (URIUtils::IsPVRChannel(item.GetDynPath()))
+    return false;
+
+  std::shared_ptr<CDVDInputStream> inputStream =
+      CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+
+  // input stream add-ons depend on the player
+  if (!inputStream || !(inputStream->IsStreamType(DVDSTREAM_TYPE_FILE) ||
+                        inputStream->IsStreamType(DVDSTREAM_TYPE_FFMPEG)))
+    return false;
+
+  {
+    CSingleLock lock(m_section);
+    if (m_bStop)
+      return false;
+    m_inputStream = inputStream;
+  }
+
+  if (!inputStream->Open())
+    return false;
+
+  std::unique_ptr<CDVDDemux> demuxer;
+  try
+  {
+    demuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(inputStream));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "CChannelPreloader - {} - exception thrown when opening demuxer",
+              __FUNCTION__);
+  }
+
+  if (!demuxer)
+    return false;
+
+  CSingleLock lock(m_section);
+  if (m_bStop)
+    return false;
+  m_demuxer = std::move(demuxer);
+
+  CLog::Log(LOGDEBUG, "CChannelPreloader - {} - preloading {}", __FUNCTION__,
+            CURL::GetRedacted(item.GetDynPath()));
+  return true;
+}
+
+void CChannelPreloader::CChannel::Buffer(DemuxPacket* packet)
+{
+  // the player reads the streams of the demuxer when it takes over
+  if (packet->iStreamId < 0)
+  {
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+    return;
+  }
+
+  // playback starts at the last keyframe
+  const CDemuxStream* stream = m_demuxer->GetStream(packet->demuxerId, packet->iStreamId);
+  if (stream && stream->type == STREAM_VIDEO)
+  {
+    m_hasVideo = true;
+    if (packet->keyFrame)
+    {
+      for (DemuxPacket* buffered : m_packets)
+        CDVDDemuxUtils::FreeDemuxPacket(buffered);
+      m_packets.clear();
+      m_bytes = 0;
+    }
+  }
+
+  m_packets.push_back(packet);
+  m_bytes += packet->iSize;
+
+  while (m_bytes > MAX_BUFFERED_BYTES)
+    Drop();
+
+  const double newest = GetTime(packet);
+  if (!m_hasVideo && newest != DVD_NOPTS_VALUE)
+  {
+    while (m_packets.size() > 1)
+    {
+      const double oldest = GetTime(m_packets.front());
+      // older packets of a timestamp discontinuity are dropped as well
+      if (oldest != DVD_NOPTS_VALUE && oldest <= newest &&
+          newest - oldest <= MAX_BUFFERED_AUDIO_TIME)
+        break;
+      Drop();
+    }
+  }
+}
+
+void CChannelPreloader::CChannel::Drop()
+{
+  DemuxPacket* oldest = m_packets.front();
+  m_packets.pop_front();
+  m_bytes -= oldest->iSize;
+  CDVDDemuxUtils::FreeDemuxPacket(oldest);
+}
+
+CChannelPreloader::CChannelPreloader() = default;
+
+CChannelPreloader::~CChannelPreloader()
+{
+  Clear();
+}
+
+void CChannelPreloader::Update(const CFileItem& playing)
+{
+  const int count =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_iPVRPreloadChannels;
+  const std::shared_ptr<CPVRChannel> channel = playing.GetPVRChannelInfoTag();
+
+  std::vector<std::shared_ptr<CPVRChannelGroupMember>> members;
+  if (count > 0 && channel)
+  {
+    const std::shared_ptr<CPVRChannelGroup> group =
+        CServiceBroker::GetPVRManager().PlaybackState()->GetActiveChannelGroup(channel->IsRadio());
+    const std::shared_ptr<CPVRChannelGroupMember> playingMember =
+        group ? group->GetByUniqueID(channel->StorageId()) : nullptr;
+
+    const auto add = [&members, &playingMember](
+                         const std::shared_ptr<CPVRChannelGroupMember>& member) {
+      if (member && member != playingMember && !member->Channel()->IsLocked() &&
+          std::find(members.begin(), members.end(), member) == members.end())
+        members.push_back(member);
+    };
+
+    // the next channel, the previous one, the one after the next, ...
+    std::shared_ptr<CPVRChannelGroupMember> next = playingMember;
+    std::shared_ptr<CPVRChannelGroupMember> previous = playingMember;
+    for (int i = 0; playingMember && i < count; i++)
+    {
+      next = group->GetNextChannelGroupMember(next);
+      add(next);
+      if (members.size() < static_cast<size_t>(count))
+      {
+        previous = group->GetPreviousChannelGroupMember(previous);
+        add(previous);
+      }
+    }
+    if (members.size() > static_cast<size_t>(count))
+      members.resize(count);
+  }
+
+  std::vector<std::unique_ptr<CChannel>> channels;
+  for (const auto& member : members)
+  {
+    auto it = std::find_if(m_channels.begin(), m_channels.end(),
+                           [&member](const std::unique_ptr<CChannel>& preloaded) {
+                             return preloaded->GetStorageId() == member->Channel()->StorageId();
+                           });
+    if (it != m_channels.end())
+    {
+      channels.push_back(std::move(*it));
+      m_channels.erase(it);
+    }
+    else
+    {
+      channels.push_back(std::make_unique<CChannel>(member));
+      channels.back()->Start();
+    }
+  }
+
+  // stops the channels no longer next to the playing one
+  m_channels.swap(channels);
+  Stop(std::move(channels));
+}
+
+bool CChannelPreloader::Take(const CFileItem& item, Stream& stream)
+{
+  const std::shared_ptr<CPVRChannel> channel = item.GetPVRChannelInfoTag();
+  if (!channel)
+    return false;
+
+  auto it = std::find_if(m_channels.begin(), m_channels.end(),
+                         [&channel](const std::unique_ptr<CChannel>& preloaded) {
+                           return preloaded->GetStorageId() == channel->StorageId();
+                         });
+  if (it == m_channels.end())
+    return false;
+
+  std::unique_ptr<CChannel> preloaded = std::move(*it);
+  m_channels.erase(it);
+  if (preloaded->Take(stream))
+    return true;
+
+  // still opening or stalled in a read
+  std::vector<std::unique_ptr<CChannel>> stalled;
+  stalled.push_back(std::move(preloaded));
+  Stop(std::move(stalled));
+  return false;
+}
+
+void CChannelPreloader::Clear()
+{
+  Stop(std::move(m_channels));
+  m_channels.clear();
+}
+
+void CChannelPreloader::Stop(std::vector<std::unique_ptr<CChannel>> channels)
+{
+  if (channels.empty())
+    return;
+
+  // signal all of them before the first join
+  for (const auto& channel : channels)
+    channel->Abort();
+
+  CJobManager::GetInstance().Submit([channels = std::move(channels)]() mutable {
+    channels.clear();
+  });
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class CDVDDemux;
+class CDVDInputStream;
+class CFileItem;
+
+/*!
+ \brief Keeps the channels next to the playing one opened
+
+ Opening the url of an IPTV channel and probing the stream takes most of a
+ channel switch, followed by the wait for a keyframe. The preloader opens the
+ next and previous channels of the group in the background and keeps reading
+ them, holding the packets since the last keyframe, or the last seconds of a
+ channel without video. Switching to one of them hands its input stream and
+ demuxer to the player, starting with those packets.
+
+ Channels streamed by the pvr client itself can't be preloaded, a client has
+ a single live stream.
+ */
+class CChannelPreloader
+{
+public:
+  struct Stream
+  {
+    std::shared_ptr<CDVDInputStream> inputStream;
+    std::unique_ptr<CDVDDemux> demuxer;
+  };
+
+  CChannelPreloader();
+  ~CChannelPreloader();
+
+  /*!
+   \brief Preload the channels next to the one playing, stop the others
+   */
+  void Update(const CFileItem& playing);
+
+  /*!
+   \brief Hand out the stream of the channel of item
+   \return false if the channel isn't preloaded or not opened yet
+   */
+  bool Take(const CFileItem& item, Stream& stream);
+
+  void Clear();
+
+private:
+  class CChannel;
+
+  /*!
+   \brief Stop channels without waiting on the calling thread
+
+   Opening or reading a stream can block until the network times out, the
+   threads are joined in a job instead of the player thread.
+   */
+  static void Stop(std::vector<std::unique_ptr<CChannel>> channels);
+
+  std::vector<std::unique_ptr<CChannel>> m_channels;
+};
@@ -387,6 +387,10 @@ bool CDVDVideoCodecDRMPRIME::AddData(const DemuxPacket& packet)
   avpkt->side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt->side_data_elems = packet.iSideDataElems;
 
+  // the decoder keeps a reference instead of copying the data
+  if (packet.bufferRef)
+    avpkt->buf = av_buffer_ref(packet.bufferRef);
+
   int ret = avcodec_send_packet(m_pCodecContext, avpkt);
 
   //! @todo: properly handle avpkt side_data. this works around our inproper use of the side_data
@@ -52,6 +52,82 @@ enum DecoderState
   STATE_SW_MULTI
 };
 
+namespace
+{
+
+struct ThreadingPolicy
+{
+  int type;
+  int threads;
+  bool lowDelay;
+};
+
+// frame threading delays the output by a frame per thread, which is what channel
+// switching waits for on live streams. Slice threading adds no delay, but only
+// pays off with several slices per frame, common for SD broadcasts.
+ThreadingPolicy GetThreadingPolicy(const std::string& codec, int height, bool live)
+{
+  const int cpus = std::max(1, CServiceBroker::GetCPUInfo()->GetCPUCount());
+
+  ThreadingPolicy policy = {FF_THREAD_FRAME | FF_THREAD_SLICE, 0, false};
+  int maxFrameThreads = 16;
+  if (live)
+  {
+    if (height > 0 && height <= 576)
+      policy.type = FF_THREAD_SLICE;
+    else
+      maxFrameThreads = 4;
+  }
+
+  const auto& rules =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoDecoderThreading;
+  for (const auto& rule : rules)
+  {
+    if ((!rule.codec.empty() && rule.codec != codec) ||
+        (rule.live != -1 && rule.live != (live ? 1 : 0)) ||
+        (rule.minheight > 0 && height < rule.minheight) ||
+        (rule.maxheight > 0 && (height == 0 || height > rule.maxheight)))
+      continue;
+
+    policy.type =
+        (rule.frameThreads ? FF_THREAD_FRAME : 0) | (rule.sliceThreads ? FF_THREAD_SLICE : 0);
+    policy.threads = rule.threads;
+    policy.lowDelay = rule.lowdelay;
+    break;
+  }
+
+  if (policy.type == 0)
+    policy.threads = 1;
+  else if (policy.threads == 0)
+  {
+    if (policy.type & FF_THREAD_FRAME)
+      policy.threads = std::min(cpus * 3 / 2, maxFrameThreads);
+    else
+      policy.threads = std::min(cpus, 16);
+  }
+  policy.threads = std::max(1, policy.threads);
+
+  return policy;
+}
+
+std::string GetThreadingName(const AVCodecContext* avctx)
+{
+  std::string name = "none";
+  if (avctx->active_thread_type & FF_THREAD_FRAME)
+    name = "frame";
+  else if (avctx->active_thread_type & FF_THREAD_SLICE)
+    name = "slice";
+
+  if (avctx->active_thread_type)
+    name += StringUtils::Format(", {} threads", avctx->thread_count);
+  if (avctx->flags & AV_CODEC_FLAG_LOW_DELAY)
+    name += ", low delay";
+
+  return name;
+}
+
+} // namespace
+
 enum EFilterFlags {
   FILTER_NONE                =  0x0,
   FILTER_DEINTERLACE_YADIF   =  0x1,  //< use first deinterlace mode
@@ -368,12 +444,13 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      const ThreadingPolicy policy =
+          GetThreadingPolicy(pCodec->name, hints.height, m_processInfo.IsRealtimeStream());
+      m_pCodecContext->thread_type = policy.type;
+      m_pCodecContext->thread_count = policy.threads;
+      if (policy.lowDelay)
+        m_pCodecContext->flags |= AV_CODEC_FLAG_LOW_DELAY;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with {} threads",
-                num_threads);
     }
   }
   else
@@ -437,6 +514,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   }
 
   UpdateName();
+  // what the codec supports of it, e.g. no frame threads with low delay
+  const std::string threading = GetThreadingName(m_pCodecContext);
+  m_processInfo.SetVideoDecoderThreading(threading);
+  CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - threading: {}", threading);
   const char* pixFmtName = av_get_pix_fmt_name(m_pCodecContext->pix_fmt);
   m_processInfo.SetVideoDimensions(m_pCodecContext->coded_width, m_pCodecContext->coded_height);
   m_processInfo.SetVideoPixelFormat(pixFmtName ? pixFmtName : "");
@@ -579,6 +660,10 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt->side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt->side_data_elems = packet.iSideDataElems;
 
+  // the decoder keeps a reference instead of copying the data
+  if (packet.bufferRef)
+    avpkt->buf = av_buffer_ref(packet.bufferRef);
+
   int ret = avcodec_send_packet(m_pCodecContext, avpkt);
 
   //! @todo: properly handle avpkt side_data. this works around our inproper use of the side_data
@@ -713,6 +798,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     }
     else if (m_pFilterGraph && !m_filterEof)
     {
+      m_filterThread.Drain();
       int ret = FilterProcess(nullptr);
       if (ret == VC_PICTURE)
       {
@@ -1228,6 +1314,10 @@ int CDVDVideoCodecFFmpeg::FilterOpen(const std::string& filters, bool scale)
     }
   }
 
+  // a thread of its own is of no use with a single core
+  m_filterThread.Start(m_pFilterIn, m_pFilterOut,
+                       CServiceBroker::GetCPUInfo()->GetCPUCount() > 1);
+
   m_filterEof = false;
   return result;
 }
@@ -1237,6 +1327,7 @@ void CDVDVideoCodecFFmpeg::FilterClose()
   if (m_pFilterGraph)
   {
     CLog::Log(LOGDEBUG, LOGVIDEO, "CDVDVideoCodecFFmpeg::FilterClose - Freeing filter graph");
+    m_filterThread.Stop();
     avfilter_graph_free(&m_pFilterGraph);
 
     // Disposed by above code
@@ -1247,33 +1338,21 @@ void CDVDVideoCodecFFmpeg::FilterClose()
 
 CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::FilterProcess(AVFrame* frame)
 {
-  int result;
-
-  if (frame || (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN))
-  {
-    result = av_buffersrc_add_frame(m_pFilterIn, frame);
-    if (result < 0)
-    {
-      CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersrc_add_frame");
-      return VC_ERROR;
-    }
-  }
-
-  result = av_buffersink_get_frame(m_pFilterOut, m_pFilterFrame);
+  if (frame)
+    m_filterThread.AddFrame(frame);
 
-  if (result  == AVERROR(EAGAIN))
-    return VC_BUFFER;
-  else if (result == AVERROR_EOF)
+  switch (m_filterThread.GetFrame(m_pFilterFrame))
   {
-    result = av_buffersink_get_frame(m_pFilterOut, m_pFilterFrame);
-    m_filterEof = true;
-    if (result < 0)
+    case CDVDVideoFilterThread::Result::AGAIN:
       return VC_BUFFER;
-  }
-  else if (result < 0)
-  {
-    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersink_get_frame");
-    return VC_ERROR;
+    case CDVDVideoFilterThread::Result::DRAINED:
+      m_filterEof = true;
+      return VC_BUFFER;
+    case CDVDVideoFilterThread::Result::FAILED:
+      CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - filtering failed");
+      return VC_ERROR;
+    default:
+      break;
   }
 
   av_frame_unref(m_pFrame);
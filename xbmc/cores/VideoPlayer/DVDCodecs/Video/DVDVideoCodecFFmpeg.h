@@ -11,6 +11,7 @@
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
+#include "DVDVideoFilterThread.h"
 #include "DVDVideoPPFFmpeg.h"
 #include <string>
 #include <vector>
@@ -70,6 +71,7 @@ protected:
   AVFilterContext* m_pFilterIn = nullptr;
   AVFilterContext* m_pFilterOut = nullptr;;
   AVFrame* m_pFilterFrame = nullptr;;
+  CDVDVideoFilterThread m_filterThread;
   bool m_filterEof = false;
   bool m_eof = false;
 
@@ -0,0 +1,216 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDVideoFilterThread.h"
+
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+extern "C" {
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+}
+
+namespace
+{
+// frames handed over and not filtered yet, one being filtered and the next one
+constexpr size_t MAX_PENDING = 2;
+} // namespace
+
+CDVDVideoFilterThread::CDVDVideoFilterThread() : CThread("VideoFilter")
+{
+}
+
+CDVDVideoFilterThread::~CDVDVideoFilterThread()
+{
+  if (IsRunning())
+  {
+    StopThread(false);
+    {
+      CSingleLock lock(m_section);
+      m_condition.notifyAll();
+    }
+    StopThread(true);
+  }
+
+  Clear();
+}
+
+void CDVDVideoFilterThread::Start(AVFilterContext* in, AVFilterContext* out, bool threaded)
+{
+  Stop();
+
+  {
+    CSingleLock lock(m_section);
+    m_filterIn = in;
+    m_filterOut = out;
+    m_threaded = threaded;
+  }
+
+  if (threaded && !IsRunning())
+    Create();
+}
+
+void CDVDVideoFilterThread::Stop()
+{
+  CSingleLock lock(m_section);
+
+  // the graph is in use until the frame being filtered is done
+  while (m_busy)
+    m_condition.wait(lock);
+
+  Clear();
+  m_filterIn = nullptr;
+  m_filterOut = nullptr;
+  m_draining = false;
+  m_drained = false;
+  m_failed = false;
+}
+
+void CDVDVideoFilterThread::AddFrame(AVFrame* frame)
+{
+  AVFrame* pending = av_frame_alloc();
+  if (!pending)
+  {
+    CLog::Log(LOGERROR, "CDVDVideoFilterThread::{} - av_frame_alloc failed", __FUNCTION__);
+    CSingleLock lock(m_section);
+    m_failed = true;
+    return;
+  }
+  av_frame_move_ref(pending, frame);
+
+  if (!m_threaded)
+  {
+    Filter(pending);
+    av_frame_free(&pending);
+    return;
+  }
+
+  CSingleLock lock(m_section);
+  m_input.push_back(pending);
+  m_condition.notifyAll();
+}
+
+void CDVDVideoFilterThread::Drain()
+{
+  CSingleLock lock(m_section);
+  if (m_draining || !m_filterIn)
+    return;
+  m_draining = true;
+
+  if (!m_threaded)
+  {
+    lock.Leave();
+    Filter(nullptr);
+    return;
+  }
+
+  m_input.push_back(nullptr);
+  m_condition.notifyAll();
+}
+
+CDVDVideoFilterThread::Result CDVDVideoFilterThread::GetFrame(AVFrame* frame)
+{
+  CSingleLock lock(m_section);
+
+  while (m_output.empty() && !m_failed && !m_bStop)
+  {
+    const size_t pending = m_input.size() + (m_busy ? 1 : 0);
+    if (pending == 0 || (pending < MAX_PENDING && !m_draining))
+      break;
+    m_condition.wait(lock);
+  }
+
+  if (!m_output.empty())
+  {
+    AVFrame* filtered = m_output.front();
+    m_output.pop_front();
+    av_frame_unref(frame);
+    av_frame_move_ref(frame, filtered);
+    av_frame_free(&filtered);
+    return Result::FRAME;
+  }
+
+  if (m_failed)
+    return Result::FAILED;
+  if (m_drained)
+    return Result::DRAINED;
+  return Result::AGAIN;
+}
+
+void CDVDVideoFilterThread::Process()
+{
+  while (!m_bStop)
+  {
+    CSingleLock lock(m_section);
+    while (m_input.empty() && !m_bStop)
+      m_condition.wait(lock);
+    if (m_bStop)
+      break;
+
+    AVFrame* frame = m_input.front();
+    m_input.pop_front();
+    m_busy = true;
+    lock.Leave();
+
+    Filter(frame);
+    av_frame_free(&frame);
+
+    lock.Enter();
+    m_busy = false;
+    m_condition.notifyAll();
+  }
+}
+
+void CDVDVideoFilterThread::Filter(AVFrame* frame)
+{
+  if (av_buffersrc_add_frame(m_filterIn, frame) < 0)
+  {
+    CLog::Log(LOGERROR, "CDVDVideoFilterThread::{} - av_buffersrc_add_frame", __FUNCTION__);
+    CSingleLock lock(m_section);
+    m_failed = true;
+    return;
+  }
+
+  while (true)
+  {
+    AVFrame* filtered = av_frame_alloc();
+    int result = filtered ? av_buffersink_get_frame(m_filterOut, filtered) : AVERROR(ENOMEM);
+    if (result < 0)
+    {
+      av_frame_free(&filtered);
+
+      CSingleLock lock(m_section);
+      if (result == AVERROR_EOF || (result == AVERROR(EAGAIN) && !frame))
+        m_drained = true;
+      else if (result != AVERROR(EAGAIN))
+      {
+        CLog::Log(LOGERROR, "CDVDVideoFilterThread::{} - av_buffersink_get_frame", __FUNCTION__);
+        m_failed = true;
+      }
+      m_condition.notifyAll();
+      return;
+    }
+
+    // handed out right away, the second field of a frame follows a moment later
+    CSingleLock lock(m_section);
+    m_output.push_back(filtered);
+    m_condition.notifyAll();
+  }
+}
+
+void CDVDVideoFilterThread::Clear()
+{
+  for (AVFrame* frame : m_input)
+    av_frame_free(&frame);
+  m_input.clear();
+
+  for (AVFrame* frame : m_output)
+    av_frame_free(&frame);
+  m_output.clear();
+}
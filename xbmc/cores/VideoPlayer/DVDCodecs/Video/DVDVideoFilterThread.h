@@ -0,0 +1,96 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <deque>
+
+extern "C" {
+#include <libavfilter/avfilter.h>
+#include <libavutil/frame.h>
+}
+
+/*!
+ \brief Runs the filter graph of the software decoder on a thread of its own
+
+ Deinterlacing SD and 1080i at field rate takes about as long as decoding, one
+ after the other in the video thread a box without hardware decoding drops
+ frames. The decoder hands its frames over and takes the filtered ones back
+ later, so the next frame is decoded while the previous one is deinterlaced.
+
+ The graph is built and freed by the decoder, it's only touched by the filter
+ thread in between Start and Stop.
+ */
+class CDVDVideoFilterThread : private CThread
+{
+public:
+  enum class Result
+  {
+    FRAME,
+    AGAIN,
+    DRAINED,
+    FAILED
+  };
+
+  CDVDVideoFilterThread();
+  ~CDVDVideoFilterThread() override;
+
+  /*!
+   \brief Start filtering through a configured graph
+   \param threaded false to filter in the calling thread, e.g. on single core boxes
+   */
+  void Start(AVFilterContext* in, AVFilterContext* out, bool threaded);
+
+  /*!
+   \brief Drop all frames, the graph may be freed afterwards
+
+   Frames pending are lost like the ones held by the graph when it's reopened.
+   */
+  void Stop();
+
+  /*!
+   \brief Hand a decoded frame over, takes its reference
+   */
+  void AddFrame(AVFrame* frame);
+
+  /*!
+   \brief Flush the graph once the frames handed over are filtered
+   */
+  void Drain();
+
+  /*!
+   \brief Get the next filtered frame
+
+   Waits while the filter is behind by a few frames or is being drained, so the
+   decoder doesn't run further ahead.
+   */
+  Result GetFrame(AVFrame* frame);
+
+private:
+  void Process() override;
+  void Filter(AVFrame* frame);
+  void Clear();
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_condition;
+  // nullptr flushes the graph
+  std::deque<AVFrame*> m_input;
+  std::deque<AVFrame*> m_output;
+  bool m_busy = false;
+  bool m_draining = false;
+  bool m_drained = false;
+  bool m_failed = false;
+
+  AVFilterContext* m_filterIn = nullptr;
+  AVFilterContext* m_filterOut = nullptr;
+  bool m_threaded = false;
+};
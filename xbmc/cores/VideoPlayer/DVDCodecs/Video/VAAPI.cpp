@@ -19,7 +19,7 @@
 #include "settings/SettingsComponent.h"
 #include "settings/lib/Setting.h"
 #include "threads/SingleLock.h"
-#include "utils/MemUtils.h"
+#include "utils/PlaneCopy.h"
 #include "utils/StringUtils.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
@@ -2847,11 +2847,8 @@ bool CVppPostproc::CheckSuccess(VAStatus status, const std::string& function)
 // FFmpeg Postprocessing
 //-----------------------------------------------------------------------------
 
-#define CACHED_BUFFER_SIZE 4096
-
 CFFmpegPostproc::CFFmpegPostproc()
 {
-  m_cache = NULL;
   m_pFilterFrameIn = NULL;
   m_pFilterFrameOut = NULL;
   m_pFilterGraph = NULL;
@@ -2863,8 +2860,6 @@ CFFmpegPostproc::CFFmpegPostproc()
 CFFmpegPostproc::~CFFmpegPostproc()
 {
   Close();
-  KODI::MEMORY::AlignedFree(m_cache);
-  m_dllSSE4.Unload();
   av_frame_free(&m_pFilterFrameIn);
   av_frame_free(&m_pFilterFrameOut);
 }
@@ -2874,9 +2869,9 @@ bool CFFmpegPostproc::PreInit(CVaapiConfig &config, SDiMethods *methods)
   m_config = config;
   bool use_filter = true;
 
-  // copying large surfaces via sse4 is a bit slow
-  // we just return false here as the primary use case the
-  // sse4 copy method is deinterlacing of max 1080i content
+  // copying large surfaces from uncached memory is a bit slow
+  // we just return false here as the primary use case of the
+  // copy is deinterlacing of max 1080i content
   if (m_config.vidWidth > 1920 || m_config.vidHeight > 1088)
     return false;
 
@@ -2902,15 +2897,14 @@ bool CFFmpegPostproc::PreInit(CVaapiConfig &config, SDiMethods *methods)
   if (image.image_id != VA_INVALID_ID)
     CheckSuccess(vaDestroyImage(config.dpy, image.image_id), "vaDestroyImage");
 
-  if (use_filter && !m_dllSSE4.Load())
+  if (use_filter && !CPlaneCopy::Supports(CPlaneCopy::Kernel::SSE4))
   {
-    CLog::Log(LOGERROR,"VAAPI::SupportsFilter failed loading sse4 lib");
+    CLog::Log(LOGINFO, "VAAPI::SupportsFilter no sse4.1 for reading surfaces");
     use_filter = false;
   }
 
   if (use_filter)
   {
-    m_cache = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(CACHED_BUFFER_SIZE, 64));
     if (methods)
     {
       methods->diMethods[methods->numDiMethods++] = VS_INTERLACEMETHOD_DEINTERLACE;
@@ -3057,11 +3051,13 @@ bool CFFmpegPostproc::AddPicture(CVaapiDecodedPicture &inPic)
   uint8_t *src, *dst;
   src = buf + image.offsets[0];
   dst = m_pFilterFrameIn->data[0];
-  m_dllSSE4.copy_frame(src, dst, m_cache, m_config.vidWidth, m_config.vidHeight, image.pitches[0]);
+  CPlaneCopy::CopyUncached(dst, image.pitches[0], src, image.pitches[0], m_config.vidWidth,
+                           m_config.vidHeight);
 
   src = buf + image.offsets[1];
   dst = m_pFilterFrameIn->data[1];
-  m_dllSSE4.copy_frame(src, dst, m_cache, image.width, image.height/2, image.pitches[1]);
+  CPlaneCopy::CopyUncached(dst, image.pitches[1], src, image.pitches[1], image.width,
+                           image.height / 2);
 
   m_pFilterFrameIn->linesize[0] = image.pitches[0];
   m_pFilterFrameIn->linesize[1] = image.pitches[1];
@@ -18,8 +18,6 @@
 #include "utils/ActorProtocol.h"
 #include "utils/Geometry.h"
 
-#include "platform/linux/sse4/DllLibSSE4.h"
-
 #include <list>
 #include <map>
 #include <memory>
@@ -540,8 +538,6 @@ public:
 protected:
   bool CheckSuccess(VAStatus status, const std::string& function);
   void Close();
-  DllLibSSE4 m_dllSSE4;
-  uint8_t *m_cache;
   AVFilterGraph* m_pFilterGraph;
   AVFilterContext* m_pFilterIn;
   AVFilterContext* m_pFilterOut;
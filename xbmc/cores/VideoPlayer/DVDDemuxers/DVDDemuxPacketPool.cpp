@@ -0,0 +1,209 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxPacketPool.h"
+
+#include "cores/VideoPlayer/Interface/DemuxPacket.h"
+#include "threads/SingleLock.h"
+#include "utils/MemUtils.h"
+
+#include <algorithm>
+
+namespace
+{
+constexpr size_t MIN_CLASS_SIZE = 1024;
+constexpr size_t MAX_CLASS_SIZE = 4 * 1024 * 1024;
+
+// memory kept for reuse, small enough for the 32 bit boxes
+constexpr uint64_t MAX_CACHED_BYTES = 16 * 1024 * 1024;
+constexpr size_t MAX_CACHED_PER_CLASS = 256;
+constexpr size_t MAX_CACHED_PACKETS = 512;
+
+// in front of every payload, keeps the payload 16 byte aligned
+struct DataHeader
+{
+  uint32_t sizeClass;
+  uint32_t pad;
+  uint64_t size;
+};
+static_assert(sizeof(DataHeader) == 16, "payload alignment");
+
+constexpr uint32_t NO_CLASS = UINT32_MAX;
+
+DataHeader* GetHeader(uint8_t* data)
+{
+  return reinterpret_cast<DataHeader*>(data - sizeof(DataHeader));
+}
+} // namespace
+
+CDVDDemuxPacketPool& CDVDDemuxPacketPool::Get()
+{
+  static CDVDDemuxPacketPool pool;
+  return pool;
+}
+
+CDVDDemuxPacketPool::CDVDDemuxPacketPool()
+{
+  std::vector<size_t> sizes{MIN_CLASS_SIZE};
+  for (size_t base = MIN_CLASS_SIZE; base < MAX_CLASS_SIZE; base *= 2)
+  {
+    for (size_t step = 1; step <= 4; step++)
+      sizes.push_back(base + step * base / 4);
+  }
+
+  m_classes = std::vector<SizeClass>(sizes.size());
+  for (size_t i = 0; i < sizes.size(); i++)
+    m_classes[i].size = sizes[i];
+}
+
+CDVDDemuxPacketPool::~CDVDDemuxPacketPool()
+{
+  Trim();
+}
+
+DemuxPacket* CDVDDemuxPacketPool::AllocatePacket()
+{
+  {
+    CSingleLock lock(m_packetSection);
+    if (!m_freePackets.empty())
+    {
+      DemuxPacket* packet = m_freePackets.back();
+      m_freePackets.pop_back();
+      lock.Leave();
+
+      *packet = DemuxPacket();
+      return packet;
+    }
+  }
+
+  return new DemuxPacket();
+}
+
+void CDVDDemuxPacketPool::FreePacket(DemuxPacket* packet)
+{
+  CSingleLock lock(m_packetSection);
+  if (m_freePackets.size() < MAX_CACHED_PACKETS)
+  {
+    m_freePackets.push_back(packet);
+    return;
+  }
+  lock.Leave();
+
+  delete packet;
+}
+
+uint8_t* CDVDDemuxPacketPool::AllocateData(size_t size)
+{
+  m_allocations++;
+
+  const size_t sizeClass = GetClass(size);
+  if (sizeClass != NO_CLASS)
+  {
+    SizeClass& entry = m_classes[sizeClass];
+    CSingleLock lock(entry.section);
+    if (!entry.free.empty())
+    {
+      uint8_t* data = entry.free.back();
+      entry.free.pop_back();
+      m_cachedBytes -= entry.size;
+      m_hits++;
+      return data;
+    }
+    size = entry.size;
+  }
+
+  uint8_t* block =
+      static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(sizeof(DataHeader) + size, 16));
+  if (!block)
+    return nullptr;
+
+  DataHeader* header = reinterpret_cast<DataHeader*>(block);
+  header->sizeClass = static_cast<uint32_t>(sizeClass);
+  header->size = size;
+
+  const uint64_t bytes = m_bytes += size;
+  uint64_t peak = m_peakBytes;
+  while (bytes > peak && !m_peakBytes.compare_exchange_weak(peak, bytes))
+    ;
+
+  return block + sizeof(DataHeader);
+}
+
+void CDVDDemuxPacketPool::FreeData(uint8_t* data)
+{
+  if (!data)
+    return;
+
+  const DataHeader* header = GetHeader(data);
+  if (header->sizeClass != NO_CLASS && m_cachedBytes + header->size <= MAX_CACHED_BYTES)
+  {
+    SizeClass& entry = m_classes[header->sizeClass];
+    CSingleLock lock(entry.section);
+    if (entry.free.size() < MAX_CACHED_PER_CLASS)
+    {
+      entry.free.push_back(data);
+      m_cachedBytes += entry.size;
+      return;
+    }
+  }
+
+  ReleaseData(data, header->size);
+}
+
+void CDVDDemuxPacketPool::Trim()
+{
+  for (SizeClass& entry : m_classes)
+  {
+    std::vector<uint8_t*> free;
+    {
+      CSingleLock lock(entry.section);
+      free.swap(entry.free);
+      m_cachedBytes -= free.size() * entry.size;
+    }
+
+    for (uint8_t* data : free)
+      ReleaseData(data, entry.size);
+  }
+
+  std::vector<DemuxPacket*> packets;
+  {
+    CSingleLock lock(m_packetSection);
+    packets.swap(m_freePackets);
+  }
+
+  for (DemuxPacket* packet : packets)
+    delete packet;
+}
+
+CDVDDemuxPacketPool::Stats CDVDDemuxPacketPool::GetStats() const
+{
+  Stats stats;
+  stats.allocations = m_allocations;
+  stats.hits = m_hits;
+  stats.bytes = m_bytes;
+  stats.peakBytes = m_peakBytes;
+  return stats;
+}
+
+size_t CDVDDemuxPacketPool::GetClass(size_t size) const
+{
+  if (size > MAX_CLASS_SIZE)
+    return NO_CLASS;
+
+  const auto it = std::lower_bound(m_classes.begin(), m_classes.end(), size,
+                                   [](const SizeClass& entry, size_t size) {
+                                     return entry.size < size;
+                                   });
+  return it - m_classes.begin();
+}
+
+void CDVDDemuxPacketPool::ReleaseData(uint8_t* data, size_t size)
+{
+  m_bytes -= size;
+  KODI::MEMORY::AlignedFree(data - sizeof(DataHeader));
+}
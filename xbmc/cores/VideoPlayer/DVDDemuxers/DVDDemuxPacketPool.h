@@ -0,0 +1,85 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct DemuxPacket;
+
+/*!
+ \brief Recycles demux packets and their payload buffers
+
+ Every packet read by a demuxer used to cost a new DemuxPacket and an aligned
+ payload allocation, freed again once decoded. The pool keeps both around
+ instead. Payloads are kept in size classes a quarter of a power of two apart,
+ so the free lists of the video stream and the audio stream don't mix and a
+ recycled buffer is never much larger than needed.
+
+ Packets are taken by the demuxing thread and given back by the decoding
+ threads, each size class has its own lock.
+ */
+class CDVDDemuxPacketPool
+{
+public:
+  struct Stats
+  {
+    uint64_t allocations; // payloads handed out
+    uint64_t hits; // of them recycled
+    uint64_t bytes; // payload bytes held, in use and cached
+    uint64_t peakBytes;
+  };
+
+  static CDVDDemuxPacketPool& Get();
+
+  CDVDDemuxPacketPool();
+  ~CDVDDemuxPacketPool();
+
+  DemuxPacket* AllocatePacket();
+  void FreePacket(DemuxPacket* packet);
+
+  /*!
+   \brief Get a payload buffer of at least size bytes, 16 byte aligned
+   */
+  uint8_t* AllocateData(size_t size);
+  void FreeData(uint8_t* data);
+
+  /*!
+   \brief Release everything cached, e.g. once playback ended
+   */
+  void Trim();
+
+  Stats GetStats() const;
+
+private:
+  struct SizeClass
+  {
+    size_t size = 0;
+    CCriticalSection section;
+    std::vector<uint8_t*> free;
+  };
+
+  size_t GetClass(size_t size) const;
+  void ReleaseData(uint8_t* data, size_t size);
+
+  std::vector<SizeClass> m_classes;
+
+  CCriticalSection m_packetSection;
+  std::vector<DemuxPacket*> m_freePackets;
+
+  std::atomic<uint64_t> m_allocations{0};
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_bytes{0};
+  std::atomic<uint64_t> m_peakBytes{0};
+  std::atomic<uint64_t> m_cachedBytes{0};
+};
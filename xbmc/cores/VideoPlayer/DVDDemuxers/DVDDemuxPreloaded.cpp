@@ -0,0 +1,162 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxPreloaded.h"
+
+#include "DVDDemuxUtils.h"
+
+CDVDDemuxPreloaded::CDVDDemuxPreloaded(std::unique_ptr<CDVDDemux> demuxer,
+                                       std::deque<DemuxPacket*> packets)
+  : m_demuxer(std::move(demuxer)), m_packets(std::move(packets))
+{
+  // the packets and streams carry the id of the demuxer that read them
+  m_demuxerId = m_demuxer->GetDemuxerId();
+}
+
+CDVDDemuxPreloaded::~CDVDDemuxPreloaded()
+{
+  FreePackets();
+}
+
+void CDVDDemuxPreloaded::FreePackets()
+{
+  for (DemuxPacket* packet : m_packets)
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  m_packets.clear();
+}
+
+bool CDVDDemuxPreloaded::Reset()
+{
+  FreePackets();
+  return m_demuxer->Reset();
+}
+
+void CDVDDemuxPreloaded::Abort()
+{
+  m_demuxer->Abort();
+}
+
+void CDVDDemuxPreloaded::Flush()
+{
+  FreePackets();
+  m_demuxer->Flush();
+}
+
+DemuxPacket* CDVDDemuxPreloaded::Read()
+{
+  if (!m_packets.empty())
+  {
+    DemuxPacket* packet = m_packets.front();
+    m_packets.pop_front();
+    return packet;
+  }
+
+  return m_demuxer->Read();
+}
+
+bool CDVDDemuxPreloaded::SeekTime(double time, bool backwards, double* startpts)
+{
+  FreePackets();
+  return m_demuxer->SeekTime(time, backwards, startpts);
+}
+
+bool CDVDDemuxPreloaded::SeekChapter(int chapter, double* startpts)
+{
+  FreePackets();
+  return m_demuxer->SeekChapter(chapter, startpts);
+}
+
+int CDVDDemuxPreloaded::GetChapterCount()
+{
+  return m_demuxer->GetChapterCount();
+}
+
+int CDVDDemuxPreloaded::GetChapter()
+{
+  return m_demuxer->GetChapter();
+}
+
+void CDVDDemuxPreloaded::GetChapterName(std::string& strChapterName, int chapterIdx)
+{
+  m_demuxer->GetChapterName(strChapterName, chapterIdx);
+}
+
+int64_t CDVDDemuxPreloaded::GetChapterPos(int chapterIdx)
+{
+  return m_demuxer->GetChapterPos(chapterIdx);
+}
+
+void CDVDDemuxPreloaded::SetSpeed(int iSpeed)
+{
+  m_demuxer->SetSpeed(iSpeed);
+}
+
+void CDVDDemuxPreloaded::FillBuffer(bool mode)
+{
+  m_demuxer->FillBuffer(mode);
+}
+
+int CDVDDemuxPreloaded::GetStreamLength()
+{
+  return m_demuxer->GetStreamLength();
+}
+
+CDemuxStream* CDVDDemuxPreloaded::GetStream(int64_t demuxerId, int iStreamId) const
+{
+  return m_demuxer->GetStream(demuxerId, iStreamId);
+}
+
+CDemuxStream* CDVDDemuxPreloaded::GetStream(int iStreamId) const
+{
+  return m_demuxer->GetStream(m_demuxerId, iStreamId);
+}
+
+std::vector<CDemuxStream*> CDVDDemuxPreloaded::GetStreams() const
+{
+  return m_demuxer->GetStreams();
+}
+
+int CDVDDemuxPreloaded::GetNrOfStreams() const
+{
+  return m_demuxer->GetNrOfStreams();
+}
+
+int CDVDDemuxPreloaded::GetPrograms(std::vector<ProgramInfo>& programs)
+{
+  return m_demuxer->GetPrograms(programs);
+}
+
+void CDVDDemuxPreloaded::SetProgram(int progId)
+{
+  m_demuxer->SetProgram(progId);
+}
+
+std::string CDVDDemuxPreloaded::GetFileName()
+{
+  return m_demuxer->GetFileName();
+}
+
+std::string CDVDDemuxPreloaded::GetStreamCodecName(int64_t demuxerId, int iStreamId)
+{
+  return m_demuxer->GetStreamCodecName(demuxerId, iStreamId);
+}
+
+void CDVDDemuxPreloaded::EnableStream(int64_t demuxerId, int id, bool enable)
+{
+  m_demuxer->EnableStream(demuxerId, id, enable);
+}
+
+void CDVDDemuxPreloaded::OpenStream(int64_t demuxerId, int id)
+{
+  m_demuxer->OpenStream(demuxerId, id);
+}
+
+void CDVDDemuxPreloaded::SetVideoResolution(int width, int height)
+{
+  m_demuxer->SetVideoResolution(width, height);
+}
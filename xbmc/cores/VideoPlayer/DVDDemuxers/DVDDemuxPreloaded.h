@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DVDDemux.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ \brief A demuxer that was read ahead of playback
+
+ Returns the packets read before playback started first, then reads on
+ from the demuxer it wraps. Everything else is passed on to that demuxer.
+ */
+class CDVDDemuxPreloaded : public CDVDDemux
+{
+public:
+  CDVDDemuxPreloaded(std::unique_ptr<CDVDDemux> demuxer, std::deque<DemuxPacket*> packets);
+  ~CDVDDemuxPreloaded() override;
+
+  // implementation of CDVDDemux
+  bool Reset() override;
+  void Abort() override;
+  void Flush() override;
+  DemuxPacket* Read() override;
+  bool SeekTime(double time, bool backwards = false, double* startpts = NULL) override;
+  bool SeekChapter(int chapter, double* startpts = NULL) override;
+  int GetChapterCount() override;
+  int GetChapter() override;
+  void GetChapterName(std::string& strChapterName, int chapterIdx = -1) override;
+  int64_t GetChapterPos(int chapterIdx = -1) override;
+  void SetSpeed(int iSpeed) override;
+  void FillBuffer(bool mode) override;
+  int GetStreamLength() override;
+  CDemuxStream* GetStream(int64_t demuxerId, int iStreamId) const override;
+  std::vector<CDemuxStream*> GetStreams() const override;
+  int GetNrOfStreams() const override;
+  int GetPrograms(std::vector<ProgramInfo>& programs) override;
+  void SetProgram(int progId) override;
+  std::string GetFileName() override;
+  std::string GetStreamCodecName(int64_t demuxerId, int iStreamId) override;
+  void EnableStream(int64_t demuxerId, int id, bool enable) override;
+  void OpenStream(int64_t demuxerId, int id) override;
+  void SetVideoResolution(int width, int height) override;
+
+protected:
+  CDemuxStream* GetStream(int iStreamId) const override;
+
+private:
+  void FreePackets();
+
+  std::unique_ptr<CDVDDemux> m_demuxer;
+  std::deque<DemuxPacket*> m_packets;
+};
@@ -8,8 +8,8 @@
 
 #include "DVDDemuxUtils.h"
 
+#include "DVDDemuxPacketPool.h"
 #include "cores/VideoPlayer/Interface/DemuxCrypto.h"
-#include "utils/MemUtils.h"
 #include "utils/log.h"
 
 extern "C" {
@@ -20,8 +20,12 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      KODI::MEMORY::AlignedFree(pPacket->pData);
+    CDVDDemuxPacketPool& pool = CDVDDemuxPacketPool::Get();
+
+    if (pPacket->bufferRef)
+      av_buffer_unref(&pPacket->bufferRef);
+    else if (pPacket->pData)
+      pool.FreeData(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket* avPkt = av_packet_alloc();
@@ -45,13 +49,14 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
     }
     if (pPacket->cryptoInfo)
       delete pPacket->cryptoInfo;
-    delete pPacket;
+    pool.FreePacket(pPacket);
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  CDVDDemuxPacketPool& pool = CDVDDemuxPacketPool::Get();
+  DemuxPacket* pPacket = pool.AllocatePacket();
 
   if (iDataSize > 0)
   {
@@ -64,7 +69,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+    pPacket->pData = pool.AllocateData(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE);
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -86,6 +91,32 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
   return ret;
 }
 
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(const AVPacket& src)
+{
+  // FFmpeg zeroes the padding behind the data of the packets it allocates
+  if (src.buf && src.data && src.size > 0 && src.data >= src.buf->data &&
+      src.data + src.size + AV_INPUT_BUFFER_PADDING_SIZE <= src.buf->data + src.buf->size)
+  {
+    DemuxPacket* pPacket = AllocateDemuxPacket(0);
+    pPacket->bufferRef = av_buffer_ref(src.buf);
+    if (pPacket->bufferRef)
+    {
+      pPacket->pData = src.data;
+      pPacket->iSize = src.size;
+      return pPacket;
+    }
+    FreeDemuxPacket(pPacket);
+  }
+
+  DemuxPacket* pPacket = AllocateDemuxPacket(src.size);
+  if (pPacket && src.data)
+  {
+    pPacket->iSize = src.size;
+    memcpy(pPacket->pData, src.data, src.size);
+  }
+  return pPacket;
+}
+
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket* avPkt = av_packet_alloc();
@@ -19,6 +19,13 @@ public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+  /*!
+   \brief Allocate a packet holding the data of an FFmpeg packet
+
+   A padded, reference counted buffer of the FFmpeg packet is referenced
+   rather than copied, so it can be passed on to the decoder as it is.
+   */
+  static DemuxPacket* AllocateDemuxPacket(const AVPacket& src);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
 };
 
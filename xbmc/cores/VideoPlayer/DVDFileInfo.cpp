@@ -18,6 +18,7 @@
 #include "utils/URIUtils.h"
 
 #include "DVDStreamInfo.h"
+#include "DVDThumbContext.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #ifdef HAVE_LIBBLURAY
 #include "DVDInputStreams/DVDInputStreamBluray.h"
@@ -93,45 +94,23 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
   const std::string redactPath = CURL::GetRedacted(fileItem.GetPath());
   auto start = std::chrono::steady_clock::now();
 
-  CFileItem item(fileItem);
-  item.SetMimeTypeForInternetFile();
-  auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
-  if (!pInputStream)
-  {
-    CLog::Log(LOGERROR, "InputStream: Error creating stream for {}", redactPath);
-    return false;
-  }
-
-  if (!pInputStream->Open())
-  {
-    CLog::Log(LOGERROR, "InputStream: Error opening, {}", redactPath);
-    return false;
-  }
-
-  CDVDDemux *pDemuxer = NULL;
-
-  try
+  // the next chapter of a file comes with the decoder open and the file probed already
+  CDVDThumbContextPool& pool = CDVDThumbContextPool::GetInstance();
+  std::unique_ptr<CDVDThumbContext> thumbContext = pool.Acquire(fileItem.GetPath());
+  if (!thumbContext)
   {
-    pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(pInputStream, true);
-    if(!pDemuxer)
-    {
-      CLog::Log(LOGERROR, "{} - Error creating demuxer", __FUNCTION__);
+    thumbContext = std::make_unique<CDVDThumbContext>();
+    if (!thumbContext->Open(fileItem))
       return false;
-    }
   }
-  catch(...)
-  {
-    CLog::Log(LOGERROR, "{} - Exception thrown when opening demuxer", __FUNCTION__);
-    if (pDemuxer)
-      delete pDemuxer;
 
-    return false;
-  }
+  auto pInputStream = thumbContext->GetInputStream();
+  CDVDDemux* pDemuxer = thumbContext->GetDemuxer();
 
   if (pStreamDetails)
   {
 
-    const std::string& strPath = item.GetPath();
+    const std::string& strPath = fileItem.GetPath();
     DemuxerToStreamDetails(pInputStream, pDemuxer, *pStreamDetails, strPath);
 
     //extern subtitles
@@ -163,133 +142,60 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     }
   }
 
-  int nVideoStream = -1;
-  int64_t demuxerId = -1;
-  for (CDemuxStream* pStream : pDemuxer->GetStreams())
-  {
-    if (pStream)
-    {
-      // ignore if it's a picture attachment (e.g. jpeg artwork)
-      if (pStream->type == STREAM_VIDEO && !(pStream->flags & AV_DISPOSITION_ATTACHED_PIC))
-      {
-        nVideoStream = pStream->uniqueId;
-        demuxerId = pStream->demuxerId;
-      }
-      else
-        pDemuxer->EnableStream(pStream->demuxerId, pStream->uniqueId, false);
-    }
-  }
-
   bool bOk = false;
   int packetsTried = 0;
 
-  if (nVideoStream != -1)
+  if (thumbContext->HasVideo())
   {
-    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
-    std::vector<AVPixelFormat> pixFmts;
-    pixFmts.push_back(AV_PIX_FMT_YUV420P);
-    pProcessInfo->SetPixFormats(pixFmts);
-
-    CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
-    hint.codecOptions = CODEC_FORCE_SOFTWARE;
-
-    std::unique_ptr<CDVDVideoCodec> pVideoCodec =
-        CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    const CDVDStreamInfo& hint = thumbContext->GetHint();
+    VideoPicture picture = {};
 
-    if (pVideoCodec)
+    if (thumbContext->GetPicture(pos, picture, packetsTried))
     {
-      int nTotalLen = pDemuxer->GetStreamLength();
-      int64_t nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
-
-      CLog::Log(LOGDEBUG, "{} - seeking to pos {}ms (total: {}ms) in {}", __FUNCTION__, nSeekTo,
-                nTotalLen, redactPath);
-
-      if (pDemuxer->SeekTime(static_cast<double>(nSeekTo), true))
+      unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
+      double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+      if(hint.forced_aspect && hint.aspect != 0)
+        aspect = hint.aspect;
+      unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+      // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
+      int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
+      uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
+      struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
+            AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+
+      if (context)
       {
-        CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
-        VideoPicture picture = {};
-
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
-        {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
-
-          if (!pPacket)
-            break;
-
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
-
-          pVideoCodec->AddData(*pPacket);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
-
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
-          {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
-          }
-
-        } while (abort_index--);
-
-        if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
-        {
-          {
-            unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
-
-            // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
-            int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
-            uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
-          }
-        }
-        else
-        {
-          CLog::Log(LOGDEBUG, "{} - decode failed in {} after {} packets.", __FUNCTION__,
-                    redactPath, packetsTried);
-        }
+        uint8_t *planes[YuvImage::MAX_PLANES];
+        int stride[YuvImage::MAX_PLANES];
+        picture.videoBuffer->GetPlanes(planes);
+        picture.videoBuffer->GetStrides(stride);
+        uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+        int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+        uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+        int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+        int orientation = DegreeToOrientation(hint.orientation);
+        sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+        sws_freeContext(context);
+
+        details.width = nWidth;
+        details.height = nHeight;
+        CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+        bOk = true;
       }
+      av_free(pOutBuf);
     }
+    else
+    {
+      CLog::Log(LOGDEBUG, "{} - decode failed in {} after {} packets.", __FUNCTION__,
+                redactPath, packetsTried);
+    }
+
+    // give the buffer back to the decoder before it's kept for later
+    picture.Reset();
   }
 
-  if (pDemuxer)
-    delete pDemuxer;
+  pool.Release(std::move(thumbContext));
 
   if(!bOk)
   {
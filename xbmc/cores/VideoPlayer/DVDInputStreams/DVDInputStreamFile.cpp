@@ -10,9 +10,12 @@
 
 #include "filesystem/File.h"
 #include "filesystem/IFile.h"
+#include "utils/BitstreamStats.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <string.h>
+
 using namespace XFILE;
 
 CDVDInputStreamFile::CDVDInputStreamFile(const CFileItem& fileitem, unsigned int flags)
@@ -67,6 +70,14 @@ bool CDVDInputStreamFile::Open()
   if (m_pFile->GetImplementation() && (content.empty() || content == "application/octet-stream"))
     m_content = m_pFile->GetImplementation()->GetProperty(XFILE::FILE_PROPERTY_CONTENT_TYPE);
 
+  // local files are read directly from their mapped pages, which saves a
+  // system call and a copy out of the page cache per read
+  SMappedRange range = {0, 0, nullptr};
+  m_mapped = m_pFile->IoControl(IOCTRL_MAP_RANGE, &range) == 0;
+  m_mapPos = 0;
+  if (m_mapped)
+    CLog::Log(LOGDEBUG, "CDVDInputStreamFile::Open - reading mapped file");
+
   m_eof = false;
   return true;
 }
@@ -83,12 +94,40 @@ void CDVDInputStreamFile::Close()
   CDVDInputStream::Close();
   m_pFile = NULL;
   m_eof = true;
+  m_mapped = false;
 }
 
 int CDVDInputStreamFile::Read(uint8_t* buf, int buf_size)
 {
   if(!m_pFile) return -1;
 
+  if (m_mapped)
+  {
+    SMappedRange range = {m_mapPos, static_cast<size_t>(buf_size), nullptr};
+    if (m_pFile->IoControl(IOCTRL_MAP_RANGE, &range) == 0)
+    {
+      if (range.size == 0)
+        m_eof = true;
+      else
+      {
+        memcpy(buf, range.data, range.size);
+        // CFile::Read() isn't involved, keep the bitrate of READ_BITRATE streams up to date
+        if (m_pFile->GetBitstreamStats())
+          m_pFile->GetBitstreamStats()->AddSampleBytes(range.size);
+      }
+
+      m_mapPos += range.size;
+      return static_cast<int>(range.size);
+    }
+
+    // continue with regular reads from where the mapping stopped
+    CLog::Log(LOGDEBUG, "CDVDInputStreamFile::Read - mapping failed at {}, reading file",
+              m_mapPos);
+    m_mapped = false;
+    if (m_pFile->Seek(m_mapPos, SEEK_SET) != m_mapPos)
+      return -1;
+  }
+
   ssize_t ret = m_pFile->Read(buf, buf_size);
 
   if (ret < 0)
@@ -108,6 +147,24 @@ int64_t CDVDInputStreamFile::Seek(int64_t offset, int whence)
   if(whence == SEEK_POSSIBLE)
     return m_pFile->IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
 
+  if (m_mapped)
+  {
+    int64_t pos = offset;
+    if (whence == SEEK_CUR)
+      pos += m_mapPos;
+    else if (whence == SEEK_END)
+      pos += m_pFile->GetLength();
+    else if (whence != SEEK_SET)
+      return -1;
+
+    if (pos < 0)
+      return -1;
+
+    m_mapPos = pos;
+    m_eof = false;
+    return pos;
+  }
+
   int64_t ret = m_pFile->Seek(offset, whence);
 
   /* if we succeed, we are not eof anymore */
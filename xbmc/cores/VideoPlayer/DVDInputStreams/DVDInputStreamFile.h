@@ -30,4 +30,6 @@ protected:
   XFILE::CFile* m_pFile = nullptr;
   bool m_eof = false;
   unsigned int m_flags = 0;
+  bool m_mapped = false; /**< read from pages mapped by IOCTRL_MAP_RANGE instead of m_pFile */
+  int64_t m_mapPos = 0;
 };
@@ -15,7 +15,26 @@
 
 #include <math.h>
 
-CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
+namespace
+{
+// packets the demuxer may run ahead of the consumer before falling back to the lists
+constexpr size_t RING_SIZE = 2048;
+
+double GetPacketTime(CDVDMsg& msg)
+{
+  if (!msg.IsType(CDVDMsg::DEMUXER_PACKET))
+    return DVD_NOPTS_VALUE;
+
+  DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket&>(msg).GetPacket();
+  if (!packet)
+    return DVD_NOPTS_VALUE;
+
+  return packet->dts != DVD_NOPTS_VALUE ? packet->dts : packet->pts;
+}
+} // namespace
+
+CDVDMessageQueue::CDVDMessageQueue(const std::string& owner)
+  : m_hEvent(true), m_ring(RING_SIZE), m_owner(owner)
 {
   m_iDataSize     = 0;
   m_bAbortRequest = false;
@@ -35,31 +54,53 @@ CDVDMessageQueue::~CDVDMessageQueue()
 
 void CDVDMessageQueue::Init()
 {
+  CSingleLock lock(m_section);
+
+  if (m_sizePolicy)
+  {
+    m_sizePolicy->Reset();
+    m_iMaxDataSize = m_iInitialDataSize;
+  }
+
   m_iDataSize = 0;
   m_bAbortRequest = false;
   m_bInitialized = true;
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
   m_drain = false;
+  m_policyRestart = false;
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
+  CSingleLock consumerLock(m_consumerSection);
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  for (auto it = m_messages.begin(); it != m_messages.end();)
+  {
+    if (type == CDVDMsg::NONE || it->message->IsType(type))
+    {
+      Taken(*it->message);
+      it = m_messages.erase(it);
+    }
+    else
+      ++it;
+  }
+  m_listCount = m_messages.size();
 
   m_prioMessages.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
   });
+  m_prioCount = m_prioMessages.size();
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
-    m_iDataSize = 0;
+    FlushRing();
     m_TimeBack = DVD_NOPTS_VALUE;
     m_TimeFront = DVD_NOPTS_VALUE;
+
+    // the policy belongs to the thread putting the packets
+    m_policyRestart = true;
   }
 }
 
@@ -75,10 +116,10 @@ void CDVDMessageQueue::Abort()
 
 void CDVDMessageQueue::End()
 {
-  CSingleLock lock(m_section);
-
   Flush(CDVDMsg::NONE);
 
+  CSingleLock lock(m_section);
+
   m_bInitialized = false;
   m_iDataSize = 0;
   m_bAbortRequest = false;
@@ -98,8 +139,6 @@ MsgQueueReturnCode CDVDMessageQueue::Put(const std::shared_ptr<CDVDMsg>& pMsg,
                                          int priority,
                                          bool front)
 {
-  CSingleLock lock(m_section);
-
   if (!m_bInitialized)
   {
     CLog::Log(LOGWARNING, "CDVDMessageQueue({})::Put MSGQ_NOT_INITIALIZED", m_owner);
@@ -111,6 +150,27 @@ MsgQueueReturnCode CDVDMessageQueue::Put(const std::shared_ptr<CDVDMsg>& pMsg,
     return MSGQ_INVALID_MSG;
   }
 
+  DemuxPacket* packet = nullptr;
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+    packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg.get())->GetPacket();
+
+  // only one thread at a time may push to the ring
+  const bool producer =
+      packet && front && !m_ringProducer.test_and_set(std::memory_order_acquire);
+  if (producer)
+  {
+    UpdateSizePolicy(*packet);
+
+    const bool pushed = PutRing(pMsg, *packet);
+    if (pushed)
+    {
+      m_ringProducer.clear(std::memory_order_release);
+      return MSGQ_OK;
+    }
+  }
+
+  CSingleLock lock(m_section);
+
   if (priority > 0)
   {
     int prio = priority;
@@ -122,47 +182,93 @@ MsgQueueReturnCode CDVDMessageQueue::Put(const std::shared_ptr<CDVDMsg>& pMsg,
                              return prio <= item.priority;
                            });
     m_prioMessages.emplace(it, pMsg, priority);
+    m_prioCount++;
   }
   else
   {
-    if (m_messages.empty())
+    if (m_messages.empty() && m_ring.Empty())
     {
-      m_iDataSize = 0;
       m_TimeBack = DVD_NOPTS_VALUE;
       m_TimeFront = DVD_NOPTS_VALUE;
     }
 
+    // put back messages are taken before anything put
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+      m_messages.emplace_front(pMsg, priority, m_sequence++);
     else
       m_messages.emplace_back(pMsg, priority);
+    m_listCount++;
   }
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+  if (packet)
   {
-    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg.get())->GetPacket();
-    if (packet)
-    {
-      m_iDataSize += packet->iSize;
-      if (front)
-        UpdateTimeFront();
-      else
-        UpdateTimeBack();
-    }
+    m_iDataSize += packet->iSize;
+    if (front)
+      UpdateTimeFront(*pMsg);
+    else
+      UpdateTimeBack(*pMsg);
   }
 
+  if (producer)
+    m_ringProducer.clear(std::memory_order_release);
+
   // inform waiter for new packet
   m_hEvent.Set();
 
   return MSGQ_OK;
 }
 
+bool CDVDMessageQueue::PutRing(const std::shared_ptr<CDVDMsg>& pMsg, const DemuxPacket& packet)
+{
+  // only this thread fills the ring, there's room for the push if there's room now
+  if (m_ring.Size() >= m_ring.Capacity())
+    return false;
+
+  if (m_ring.Empty() && m_listCount == 0)
+  {
+    m_TimeBack = DVD_NOPTS_VALUE;
+    m_TimeFront = DVD_NOPTS_VALUE;
+  }
+
+  // accounted before the consumer can take it
+  m_iDataSize += packet.iSize;
+  UpdateTimeFront(*pMsg);
+
+  m_ring.Push({pMsg, m_sequence++});
+
+  // pairs with the fence of the consumer going to sleep, only wake it if it does
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_waiting)
+    m_hEvent.Set();
+
+  return true;
+}
+
+void CDVDMessageQueue::UpdateSizePolicy(const DemuxPacket& packet)
+{
+  if (!m_sizePolicy)
+    return;
+
+  if (m_policyRestart.exchange(false))
+    m_sizePolicy->Restart();
+
+  if (m_sizePolicy->AddPacket(packet.iSize,
+                              packet.dts != DVD_NOPTS_VALUE ? packet.dts : packet.pts))
+  {
+    const int maxDataSize = m_sizePolicy->GetDataSize(1.0 / m_TimeSize);
+    if (maxDataSize > 0 && maxDataSize != m_iMaxDataSize)
+    {
+      CLog::Log(LOGDEBUG, "CDVDMessageQueue({})::Put - {} kB/s, limit {} kB", m_owner,
+                m_sizePolicy->GetBitrate() / 1024, maxDataSize / 1024);
+      m_iMaxDataSize = maxDataSize;
+    }
+  }
+}
+
 MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
                                          unsigned int iTimeoutInMilliSeconds,
                                          int& priority)
 {
-  CSingleLock lock(m_section);
-
   int ret = 0;
 
   if (!m_bInitialized)
@@ -171,28 +277,12 @@ MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
     return MSGQ_NOT_INITIALIZED;
   }
 
+  CSingleLock lock(m_consumerSection);
+
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
-
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    if (GetNext(pMsg, priority))
     {
-      DVDMessageListItem& item(msgs.back());
-      priority = item.priority;
-
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
-      {
-        DemuxPacket* packet =
-            std::static_pointer_cast<CDVDMsgDemuxerPacket>(item.message)->GetPacket();
-        if (packet)
-        {
-          m_iDataSize -= packet->iSize;
-        }
-      }
-
-      pMsg = std::move(item.message);
-      msgs.pop_back();
-      UpdateTimeBack();
       ret = MSGQ_OK;
       break;
     }
@@ -204,13 +294,23 @@ MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
     else
     {
       m_hEvent.Reset();
-      lock.Leave();
+      m_waiting = true;
 
-      // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
+      // look again, a packet pushed before the producer could see us waiting is there now
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!HasNext(priority) && !m_bAbortRequest)
+      {
+        lock.Leave();
 
-      lock.Enter();
+        // wait for a new message
+        const bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+        m_waiting = false;
+        if (!signaled)
+          return MSGQ_TIMEOUT;
+
+        lock.Enter();
+      }
+      m_waiting = false;
     }
   }
 
@@ -220,50 +320,134 @@ MsgQueueReturnCode CDVDMessageQueue::Get(std::shared_ptr<CDVDMsg>& pMsg,
   return (MsgQueueReturnCode)ret;
 }
 
-void CDVDMessageQueue::UpdateTimeFront()
+bool CDVDMessageQueue::GetNext(std::shared_ptr<CDVDMsg>& pMsg, int& priority)
 {
-  if (!m_messages.empty())
+  if (priority > 0 || m_prioCount > 0)
   {
-    auto &item = m_messages.front();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    CSingleLock lock(m_section);
+
+    if (!m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
     {
-      DemuxPacket* packet =
-          std::static_pointer_cast<CDVDMsgDemuxerPacket>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->pts;
+      DVDMessageListItem& item(m_prioMessages.back());
+      priority = item.priority;
+      pMsg = std::move(item.message);
+      m_prioMessages.pop_back();
+      m_prioCount--;
+      return true;
+    }
 
-        if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
-      }
+    if (priority > 0)
+      return false;
+  }
+
+  // look at the ring first, a packet in it makes the messages put before it visible
+  RingItem* ringItem = m_ring.Front();
+  bool fromList = false;
+
+  if (m_listCount > 0)
+  {
+    CSingleLock lock(m_section);
+
+    if (!ringItem)
+      ringItem = m_ring.Front();
+
+    if (!m_messages.empty() && (!ringItem || m_messages.back().sequence < ringItem->sequence))
+    {
+      pMsg = std::move(m_messages.back().message);
+      m_messages.pop_back();
+      m_listCount--;
+      fromList = true;
     }
   }
+
+  if (!fromList)
+  {
+    if (!ringItem)
+      return false;
+
+    pMsg = std::move(ringItem->message);
+    m_ring.Pop();
+  }
+
+  priority = 0;
+  Taken(*pMsg);
+  UpdateTimeBack();
+  return true;
+}
+
+bool CDVDMessageQueue::HasNext(int priority)
+{
+  if (priority > 0 || m_prioCount > 0)
+  {
+    CSingleLock lock(m_section);
+
+    if (!m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
+      return true;
+
+    if (priority > 0)
+      return false;
+  }
+
+  return m_listCount > 0 || !m_ring.Empty();
+}
+
+void CDVDMessageQueue::Taken(CDVDMsg& msg)
+{
+  if (msg.IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket&>(msg).GetPacket();
+    if (packet)
+      m_iDataSize -= packet->iSize;
+  }
+}
+
+void CDVDMessageQueue::FlushRing()
+{
+  while (RingItem* item = m_ring.Front())
+  {
+    Taken(*item->message);
+    m_ring.Pop();
+  }
+}
+
+void CDVDMessageQueue::UpdateTimeFront(CDVDMsg& msg)
+{
+  const double time = GetPacketTime(msg);
+  if (time != DVD_NOPTS_VALUE)
+  {
+    m_TimeFront = time;
+    if (m_TimeBack == DVD_NOPTS_VALUE)
+      m_TimeBack = time;
+  }
+}
+
+void CDVDMessageQueue::UpdateTimeBack(CDVDMsg& msg)
+{
+  const double time = GetPacketTime(msg);
+  if (time != DVD_NOPTS_VALUE)
+  {
+    m_TimeBack = time;
+    if (m_TimeFront == DVD_NOPTS_VALUE)
+      m_TimeFront = time;
+  }
 }
 
 void CDVDMessageQueue::UpdateTimeBack()
 {
-  if (!m_messages.empty())
+  // the next message to be taken
+  RingItem* ringItem = m_ring.Front();
+  CDVDMsg* next = ringItem ? ringItem->message.get() : nullptr;
+
+  if (m_listCount > 0)
   {
-    auto &item = m_messages.back();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
-    {
-      DemuxPacket* packet =
-          std::static_pointer_cast<CDVDMsgDemuxerPacket>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->pts;
+    CSingleLock lock(m_section);
 
-        if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
-      }
-    }
+    if (!m_messages.empty() && (!ringItem || m_messages.back().sequence < ringItem->sequence))
+      next = m_messages.back().message.get();
   }
+
+  if (next)
+    UpdateTimeBack(*next);
 }
 
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
@@ -285,45 +469,46 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
       count++;
   }
 
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    count += m_ring.Size();
+
   return count;
 }
 
 void CDVDMessageQueue::WaitUntilEmpty()
 {
-  {
-    CSingleLock lock(m_section);
-    m_drain = true;
-  }
+  m_drain = true;
 
   CLog::Log(LOGINFO, "CDVDMessageQueue({})::WaitUntilEmpty", m_owner);
   auto msg = std::make_shared<CDVDMsgGeneralSynchronize>(40000, SYNCSOURCE_ANY);
   Put(msg);
   msg->Wait(m_bAbortRequest, 0);
 
-  {
-    CSingleLock lock(m_section);
-    m_drain = false;
-  }
+  m_drain = false;
 }
 
 int CDVDMessageQueue::GetLevel() const
 {
-  CSingleLock lock(m_section);
+  // called by the demuxing thread for every packet, works on a snapshot rather than locking
+  const int dataSize = m_iDataSize;
+  const int maxDataSize = m_iMaxDataSize;
+  const double timeFront = m_TimeFront;
+  const double timeBack = m_TimeBack;
 
-  if (m_iDataSize > m_iMaxDataSize)
+  if (dataSize > maxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize <= 0)
     return 0;
 
-  if (IsDataBased())
+  if (IsDataBased(timeFront, timeBack))
   {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / maxDataSize);
   }
 
-  int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
+  int level = std::min(100.0, ceil(100.0 * m_TimeSize * (timeFront - timeBack) / DVD_TIME_BASE));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
@@ -334,17 +519,38 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  CSingleLock lock(m_section);
+  const double timeFront = m_TimeFront;
+  const double timeBack = m_TimeBack;
 
-  if (IsDataBased())
+  if (IsDataBased(timeFront, timeBack))
     return 0;
   else
-    return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
+    return (int)((timeFront - timeBack) / DVD_TIME_BASE);
+}
+
+void CDVDMessageQueue::SetSizePolicy(std::unique_ptr<CDVDQueueSizePolicy> policy)
+{
+  CSingleLock lock(m_section);
+
+  m_sizePolicy = std::move(policy);
+  m_iInitialDataSize = m_iMaxDataSize;
+}
+
+unsigned int CDVDMessageQueue::GetBitrate() const
+{
+  CSingleLock lock(m_section);
+
+  return m_sizePolicy ? m_sizePolicy->GetBitrate() : 0;
 }
 
 bool CDVDMessageQueue::IsDataBased() const
 {
-  return (m_TimeBack == DVD_NOPTS_VALUE  ||
-          m_TimeFront == DVD_NOPTS_VALUE ||
-          m_TimeFront <= m_TimeBack);
+  return IsDataBased(m_TimeFront, m_TimeBack);
+}
+
+bool CDVDMessageQueue::IsDataBased(double timeFront, double timeBack)
+{
+  return (timeBack == DVD_NOPTS_VALUE  ||
+          timeFront == DVD_NOPTS_VALUE ||
+          timeFront <= timeBack);
 }
@@ -9,25 +9,30 @@
 #pragma once
 
 #include "DVDMessage.h"
+#include "DVDQueueSizePolicy.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/SPSCQueue.h"
 
 #include <algorithm>
 #include <atomic>
 #include <list>
+#include <memory>
 #include <string>
 
 struct DVDMessageListItem
 {
-  DVDMessageListItem(std::shared_ptr<CDVDMsg> msg, int prio)
+  DVDMessageListItem(std::shared_ptr<CDVDMsg> msg, int prio, uint64_t seq = 0)
   {
     message = std::move(msg);
     priority = prio;
+    sequence = seq;
   }
   DVDMessageListItem()
   {
     message = NULL;
     priority = 0;
+    sequence = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
   ~DVDMessageListItem() = default;
@@ -36,6 +41,7 @@ struct DVDMessageListItem
 
   std::shared_ptr<CDVDMsg> message;
   int priority;
+  uint64_t sequence; // order among the messages put, 0 for messages put back
 };
 
 enum MsgQueueReturnCode
@@ -95,24 +101,65 @@ public:
   bool IsInited() const { return m_bInitialized; }
   bool IsDataBased() const;
 
+  /*!
+   \brief Size the queue from the bitrate of the packets put into it
+
+   The byte limit set with SetMaxDataSize() only holds until the bitrate is
+   measured, from then on the queue holds the time size of the stream.
+   */
+  void SetSizePolicy(std::unique_ptr<CDVDQueueSizePolicy> policy);
+  unsigned int GetBitrate() const;
+
 private:
+  struct RingItem
+  {
+    std::shared_ptr<CDVDMsg> message;
+    uint64_t sequence = 0;
+  };
+
   MsgQueueReturnCode Put(const std::shared_ptr<CDVDMsg>& pMsg, int priority, bool front);
-  void UpdateTimeFront();
+  bool PutRing(const std::shared_ptr<CDVDMsg>& pMsg, const DemuxPacket& packet);
+  bool GetNext(std::shared_ptr<CDVDMsg>& pMsg, int& priority);
+  bool HasNext(int priority);
+  void Taken(CDVDMsg& msg);
+  void FlushRing();
+  void UpdateSizePolicy(const DemuxPacket& packet);
+  void UpdateTimeFront(CDVDMsg& msg);
+  void UpdateTimeBack(CDVDMsg& msg);
   void UpdateTimeBack();
+  static bool IsDataBased(double timeFront, double timeBack);
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
-  bool m_drain = false;
+  std::atomic<bool> m_bInitialized;
+  std::atomic<bool> m_drain{false};
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
-  int m_iMaxDataSize;
+  /*!
+   Demuxer packets pass from the demuxing thread to the consuming one through
+   a ring without either of them taking a lock. Messages with a priority, put
+   back ones, other messages and packets put while the ring is full or another
+   thread is putting packets take the lists. The sequence numbers keep the
+   messages in the order they were put, no matter which way they took.
+   */
+  CSPSCQueue<RingItem> m_ring;
+  std::atomic_flag m_ringProducer = ATOMIC_FLAG_INIT;
+  CCriticalSection m_consumerSection; // consumer side of the ring, also taken to flush it
+  std::atomic<uint64_t> m_sequence{1};
+  std::atomic<unsigned int> m_listCount{0}; // messages in m_messages
+  std::atomic<unsigned int> m_prioCount{0}; // messages in m_prioMessages
+  std::atomic<bool> m_waiting{false};
+  std::atomic<bool> m_policyRestart{false};
+
+  std::atomic<int> m_iMaxDataSize;
+  int m_iInitialDataSize = 0;
+  std::unique_ptr<CDVDQueueSizePolicy> m_sizePolicy;
   std::string m_owner;
 
   std::list<DVDMessageListItem> m_messages;
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDQueueSizePolicy.h"
+
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+#include "utils/MemUtils.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+// stream time a measurement spans, long enough to even out the frame types
+constexpr double MEASURE_TIME = 2.0 * DVD_TIME_BASE;
+// room for peaks above the measured bitrate
+constexpr double HEADROOM = 1.25;
+}
+
+CDVDQueueSizePolicy::CDVDQueueSizePolicy(int minDataSize, double memoryShare /* = 0.125 */)
+  : m_minDataSize(minDataSize), m_memoryShare(memoryShare)
+{
+  Reset();
+}
+
+void CDVDQueueSizePolicy::Reset()
+{
+  m_bitrate = 0;
+  Restart();
+}
+
+void CDVDQueueSizePolicy::Restart()
+{
+  m_bytes = 0;
+  m_start = DVD_NOPTS_VALUE;
+  m_end = DVD_NOPTS_VALUE;
+}
+
+bool CDVDQueueSizePolicy::AddPacket(int size, double dts)
+{
+  if (dts == DVD_NOPTS_VALUE)
+  {
+    m_bytes += size;
+    return false;
+  }
+
+  // timestamps jumped back, a new measurement is needed
+  if (m_start == DVD_NOPTS_VALUE || dts < m_start)
+  {
+    m_start = dts;
+    m_end = dts;
+    m_bytes = 0;
+    return false;
+  }
+
+  m_bytes += size;
+  m_end = std::max(m_end, dts);
+  if (m_end - m_start < MEASURE_TIME)
+    return false;
+
+  const double bitrate = m_bytes * DVD_TIME_BASE / (m_end - m_start);
+
+  // follow rising rates right away so the queue doesn't run full on a peak,
+  // falling ones slowly
+  if (bitrate > m_bitrate)
+    m_bitrate = static_cast<unsigned int>(bitrate);
+  else
+    m_bitrate = static_cast<unsigned int>(0.75 * m_bitrate.load() + 0.25 * bitrate);
+
+  m_start = m_end;
+  m_bytes = 0;
+  return true;
+}
+
+int CDVDQueueSizePolicy::GetDataSize(double duration) const
+{
+  if (m_bitrate == 0)
+    return 0;
+
+  KODI::MEMORY::MemoryStatus memory;
+  KODI::MEMORY::GetMemoryStatus(&memory);
+
+  const double maxSize = std::min(static_cast<double>(std::numeric_limits<int>::max()),
+                                  m_memoryShare * memory.availPhys);
+  const double size = std::min(maxSize, HEADROOM * duration * m_bitrate.load());
+  return std::max(m_minDataSize, static_cast<int>(size));
+}
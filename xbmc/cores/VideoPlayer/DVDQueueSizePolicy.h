@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/*!
+ \brief Sizes a message queue from the bitrate of the stream it holds
+
+ A fixed byte limit is hit long before the time limit by high bitrate streams
+ and is far more than needed by low bitrate ones. The policy measures the
+ bitrate of the packets put into the queue and gives the byte limit needed to
+ hold the queue's duration of the stream, within a share of the available
+ memory.
+ */
+class CDVDQueueSizePolicy
+{
+public:
+  /*!
+   \param minDataSize the byte limit never goes below this
+   \param memoryShare the byte limit never goes above this share of the available memory
+   */
+  explicit CDVDQueueSizePolicy(int minDataSize, double memoryShare = 0.125);
+
+  /*!
+   \brief Forget the measured bitrate, e.g. for a new stream
+   */
+  void Reset();
+
+  /*!
+   \brief Start a new measurement, keeping the bitrate measured so far
+
+   Called on discontinuities like a seek, timestamps before and after are
+   unrelated.
+   */
+  void Restart();
+
+  /*!
+   \brief Account for a demuxer packet put into the queue
+   \param dts decoding or presentation timestamp, DVD_NOPTS_VALUE if unknown
+   \return true if the bitrate was measured again
+   */
+  bool AddPacket(int size, double dts);
+
+  /*!
+   \brief Byte limit to hold the duration of the stream
+   \return 0 if the bitrate isn't known yet
+   */
+  int GetDataSize(double duration) const;
+
+  /*!
+   \brief Measured bitrate in bytes per second, 0 if not known yet
+   */
+  unsigned int GetBitrate() const { return m_bitrate; }
+
+private:
+  const int m_minDataSize;
+  const double m_memoryShare;
+
+  std::atomic<unsigned int> m_bitrate{0}; // also read by other threads
+  int64_t m_bytes = 0;
+  double m_start;
+  double m_end;
+};
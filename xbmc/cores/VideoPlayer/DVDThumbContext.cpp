@@ -0,0 +1,304 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDThumbContext.h"
+
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "FileItem.h"
+#include "Process/ProcessInfo.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace
+{
+// how long the context of a file is kept for the next image of it
+constexpr auto IDLE_TIME = std::chrono::seconds(5);
+} // namespace
+
+CDVDThumbContext::CDVDThumbContext() = default;
+
+CDVDThumbContext::~CDVDThumbContext() = default;
+
+bool CDVDThumbContext::Open(const CFileItem& fileItem)
+{
+  m_path = fileItem.GetPath();
+  const std::string redactPath = CURL::GetRedacted(m_path);
+
+  CFileItem item(fileItem);
+  item.SetMimeTypeForInternetFile();
+  m_inputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
+  if (!m_inputStream)
+  {
+    CLog::Log(LOGERROR, "InputStream: Error creating stream for {}", redactPath);
+    return false;
+  }
+
+  if (!m_inputStream->Open())
+  {
+    CLog::Log(LOGERROR, "InputStream: Error opening, {}", redactPath);
+    return false;
+  }
+
+  try
+  {
+    m_demuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(m_inputStream, true));
+    if (!m_demuxer)
+    {
+      CLog::Log(LOGERROR, "{} - Error creating demuxer", __FUNCTION__);
+      return false;
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - Exception thrown when opening demuxer", __FUNCTION__);
+    return false;
+  }
+
+  int64_t demuxerId = -1;
+  for (CDemuxStream* pStream : m_demuxer->GetStreams())
+  {
+    if (pStream)
+    {
+      // ignore if it's a picture attachment (e.g. jpeg artwork)
+      if (pStream->type == STREAM_VIDEO && !(pStream->flags & AV_DISPOSITION_ATTACHED_PIC))
+      {
+        m_videoStream = pStream->uniqueId;
+        demuxerId = pStream->demuxerId;
+      }
+      else
+        m_demuxer->EnableStream(pStream->demuxerId, pStream->uniqueId, false);
+    }
+  }
+
+  // opened, there's just nothing to take an image of
+  if (m_videoStream == -1)
+    return true;
+
+  m_processInfo.reset(CProcessInfo::CreateInstance());
+  std::vector<AVPixelFormat> pixFmts;
+  pixFmts.push_back(AV_PIX_FMT_YUV420P);
+  m_processInfo->SetPixFormats(pixFmts);
+
+  m_hint.Assign(*m_demuxer->GetStream(demuxerId, m_videoStream), true);
+  m_hint.codecOptions = CODEC_FORCE_SOFTWARE;
+
+  if (!OpenCodec(true))
+    OpenCodec(false);
+
+  return true;
+}
+
+bool CDVDThumbContext::OpenCodec(bool keyFramesOnly)
+{
+  m_codec.reset();
+  m_keyFramesOnly = false;
+
+  // decoders of add-ons don't take options
+  if (m_hint.externalInterfaces)
+  {
+    m_codec = CDVDFactoryCodec::CreateVideoCodec(m_hint, *m_processInfo);
+    return m_codec != nullptr;
+  }
+
+  CDVDCodecOptions options;
+  if (keyFramesOnly)
+  {
+    // a keyframe is all it takes, and deblocking doesn't show once it's scaled down
+    options.m_keys.emplace_back("skip_frame", "nokey");
+    options.m_keys.emplace_back("skip_loop_filter", "all");
+  }
+
+  std::unique_ptr<CDVDVideoCodec> codec = std::make_unique<CDVDVideoCodecFFmpeg>(*m_processInfo);
+  if (!codec->Open(m_hint, options))
+    return false;
+
+  m_codec = std::move(codec);
+  m_keyFramesOnly = keyFramesOnly;
+  return true;
+}
+
+bool CDVDThumbContext::GetPicture(int64_t pos, VideoPicture& picture, int& packetsTried)
+{
+  if (!m_codec)
+    return false;
+
+  if (Decode(pos, picture, packetsTried))
+    return true;
+
+  if (!m_keyFramesOnly)
+    return false;
+
+  // e.g. streams with recovery points only, try again with every frame
+  CLog::Log(LOGDEBUG, "{} - no keyframe decoded in {}, decoding all frames", __FUNCTION__,
+            CURL::GetRedacted(m_path));
+
+  picture.Reset();
+  if (!OpenCodec(false))
+    return false;
+
+  return Decode(pos, picture, packetsTried);
+}
+
+bool CDVDThumbContext::Decode(int64_t pos, VideoPicture& picture, int& packetsTried)
+{
+  int nTotalLen = m_demuxer->GetStreamLength();
+  int64_t nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
+
+  CLog::Log(LOGDEBUG, "{} - seeking to pos {}ms (total: {}ms) in {}", __FUNCTION__, nSeekTo,
+            nTotalLen, CURL::GetRedacted(m_path));
+
+  // seeks to the keyframe before the position
+  if (!m_demuxer->SeekTime(static_cast<double>(nSeekTo), true))
+    return false;
+
+  // the context may have been used for another position before
+  m_codec->Reset();
+
+  CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+
+  // num streams * 160 frames, should get a valid frame, if not abort.
+  int abort_index = m_demuxer->GetNrOfStreams() * 160;
+  do
+  {
+    DemuxPacket* pPacket = m_demuxer->Read();
+    packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != m_videoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    m_codec->AddData(*pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    iDecoderState = CDVDVideoCodec::VC_NONE;
+    while (iDecoderState == CDVDVideoCodec::VC_NONE)
+    {
+      iDecoderState = m_codec->GetPicture(&picture);
+    }
+
+    if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
+    {
+      if (!(picture.iFlags & DVP_FLAG_DROPPED))
+        break;
+    }
+
+  } while (abort_index--);
+
+  return iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED);
+}
+
+CDVDThumbContextPool& CDVDThumbContextPool::GetInstance()
+{
+  static CDVDThumbContextPool pool;
+  return pool;
+}
+
+CDVDThumbContextPool::CDVDThumbContextPool() : m_timer(this)
+{
+}
+
+CDVDThumbContextPool::~CDVDThumbContextPool()
+{
+  m_timer.Stop(true);
+}
+
+std::unique_ptr<CDVDThumbContext> CDVDThumbContextPool::Acquire(const std::string& path)
+{
+  CSingleLock lock(m_section);
+
+  for (auto it = m_idle.begin(); it != m_idle.end(); ++it)
+  {
+    if (it->context->GetPath() == path)
+    {
+      std::unique_ptr<CDVDThumbContext> context = std::move(it->context);
+      m_idle.erase(it);
+      return context;
+    }
+  }
+
+  return nullptr;
+}
+
+void CDVDThumbContextPool::Release(std::unique_ptr<CDVDThumbContext> context)
+{
+  if (!context || !context->HasVideo())
+    return;
+
+  // closed outside the lock, closing a file may take a while
+  std::vector<std::unique_ptr<CDVDThumbContext>> expired;
+  {
+    CSingleLock lock(m_section);
+
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = m_idle.begin(); it != m_idle.end();)
+    {
+      if (now - it->released > IDLE_TIME)
+      {
+        expired.push_back(std::move(it->context));
+        it = m_idle.erase(it);
+      }
+      else
+        ++it;
+    }
+
+    m_idle.push_back({std::move(context), now});
+    while (m_idle.size() > 2 * GetMaxJobs())
+    {
+      expired.push_back(std::move(m_idle.front().context));
+      m_idle.erase(m_idle.begin());
+    }
+
+    const uint32_t timeout = std::chrono::duration_cast<std::chrono::milliseconds>(IDLE_TIME).count();
+    if (m_timer.IsRunning())
+      m_timer.RestartAsync(timeout);
+    else
+      m_timer.Start(timeout);
+  }
+}
+
+unsigned int CDVDThumbContextPool::GetMaxJobs()
+{
+  // the decoders run single threaded, leave half of the cores to everything else
+  return std::max(1, CServiceBroker::GetCPUInfo()->GetCPUCount() / 2);
+}
+
+void CDVDThumbContextPool::Clear()
+{
+  m_timer.Stop(true);
+  OnTimeout();
+}
+
+void CDVDThumbContextPool::OnTimeout()
+{
+  std::vector<IdleContext> idle;
+  {
+    CSingleLock lock(m_section);
+    idle.swap(m_idle);
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DVDStreamInfo.h"
+#include "threads/CriticalSection.h"
+#include "threads/Timer.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CDVDDemux;
+class CDVDInputStream;
+class CDVDVideoCodec;
+class CFileItem;
+class CProcessInfo;
+struct VideoPicture;
+
+/*!
+ \brief A file opened for thumbnail extraction
+
+ Holds the input stream, the demuxer and the video decoder of a file, so
+ several images can be taken from it, e.g. one per chapter, without probing
+ the file and opening the decoder again for each of them.
+ */
+class CDVDThumbContext
+{
+public:
+  CDVDThumbContext();
+  ~CDVDThumbContext();
+
+  bool Open(const CFileItem& fileItem);
+
+  /*!
+   \brief Decode the first picture at or after the keyframe before pos
+   \param pos position in ms, -1 for a third into the file
+   \param packetsTried packets read, for the log
+   */
+  bool GetPicture(int64_t pos, VideoPicture& picture, int& packetsTried);
+
+  const std::string& GetPath() const { return m_path; }
+  bool HasVideo() const { return m_codec != nullptr; }
+  const CDVDStreamInfo& GetHint() const { return m_hint; }
+  std::shared_ptr<CDVDInputStream> GetInputStream() const { return m_inputStream; }
+  CDVDDemux* GetDemuxer() const { return m_demuxer.get(); }
+
+private:
+  bool OpenCodec(bool keyFramesOnly);
+  bool Decode(int64_t pos, VideoPicture& picture, int& packetsTried);
+
+  std::string m_path;
+  std::shared_ptr<CDVDInputStream> m_inputStream;
+  std::unique_ptr<CDVDDemux> m_demuxer;
+  std::unique_ptr<CProcessInfo> m_processInfo;
+  std::unique_ptr<CDVDVideoCodec> m_codec;
+  CDVDStreamInfo m_hint;
+  int m_videoStream = -1;
+  bool m_keyFramesOnly = false;
+};
+
+/*!
+ \brief Keeps the contexts of the files images were just taken from
+
+ Contexts given back are handed out again for the same file for a few
+ seconds, then closed so no file stays open.
+ */
+class CDVDThumbContextPool : private ITimerCallback
+{
+public:
+  static CDVDThumbContextPool& GetInstance();
+
+  CDVDThumbContextPool();
+  ~CDVDThumbContextPool() override;
+
+  /*!
+   \return an opened context of the file, nullptr if there's none
+   */
+  std::unique_ptr<CDVDThumbContext> Acquire(const std::string& path);
+  void Release(std::unique_ptr<CDVDThumbContext> context);
+
+  /*!
+   \brief Close all kept contexts, called on shutdown while their codecs can still be closed
+   */
+  void Clear();
+
+  /*!
+   \brief Number of extractions to run at the same time
+   */
+  static unsigned int GetMaxJobs();
+
+private:
+  struct IdleContext
+  {
+    std::unique_ptr<CDVDThumbContext> context;
+    std::chrono::steady_clock::time_point released;
+  };
+
+  void OnTimeout() override;
+
+  CCriticalSection m_section;
+  std::vector<IdleContext> m_idle;
+  CTimer m_timer;
+};
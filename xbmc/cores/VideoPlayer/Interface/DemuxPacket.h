@@ -19,6 +19,8 @@ extern "C"
 {
 #endif /* __cplusplus */
 
+  struct AVBufferRef;
+
   struct DemuxPacket : DEMUX_PACKET
   {
     DemuxPacket()
@@ -39,7 +41,16 @@ extern "C"
       recoveryPoint = false;
 
       cryptoInfo = nullptr;
+
+      bufferRef = nullptr;
+      keyFrame = false;
     }
+
+    // the FFmpeg buffer pData points into, nullptr if pData was allocated for the packet
+    AVBufferRef* bufferRef;
+
+    // decoding can start at the packet, only known for packets of the FFmpeg demuxer
+    bool keyFrame;
   };
 
 #ifdef __cplusplus
@@ -13,6 +13,7 @@
 #include "DVDDemuxers/DVDDemux.h"
 #include "DVDDemuxers/DVDDemuxCC.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DVDDemuxPacketPool.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
@@ -762,19 +763,30 @@ bool CVideoPlayer::OpenInputStream()
     m_item.SetPath(CServiceBroker::GetMediaManager().TranslateDevicePath(""));
   }
 
-  m_pInputStream = CDVDFactoryInputStream::CreateInputStream(this, m_item, true);
-  if (m_pInputStream == nullptr)
+  CChannelPreloader::Stream preloaded;
+  if (m_channelPreloader.Take(m_item, preloaded))
   {
-    CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - unable to create input stream for [{}]",
+    CLog::Log(LOGINFO, "CVideoPlayer::OpenInputStream - using preloaded stream for [{}]",
               CURL::GetRedacted(m_item.GetPath()));
-    return false;
+    m_pInputStream = preloaded.inputStream;
+    m_pPreloadedDemuxer = std::move(preloaded.demuxer);
   }
-
-  if (!m_pInputStream->Open())
+  else
   {
-    CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - error opening [{}]",
-              CURL::GetRedacted(m_item.GetPath()));
-    return false;
+    m_pInputStream = CDVDFactoryInputStream::CreateInputStream(this, m_item, true);
+    if (m_pInputStream == nullptr)
+    {
+      CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - unable to create input stream for [{}]",
+                CURL::GetRedacted(m_item.GetPath()));
+      return false;
+    }
+
+    if (!m_pInputStream->Open())
+    {
+      CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - error opening [{}]",
+                CURL::GetRedacted(m_item.GetPath()));
+      return false;
+    }
   }
 
   // find any available external subtitles for non dvd files
@@ -821,8 +833,11 @@ bool CVideoPlayer::OpenDemuxStream()
 
   CLog::Log(LOGINFO, "Creating Demuxer");
 
+  // a preloaded channel comes with its demuxer
+  m_pDemuxer = std::move(m_pPreloadedDemuxer);
+
   int attempts = 10;
-  while (!m_bStop && attempts-- > 0)
+  while (!m_pDemuxer && !m_bStop && attempts-- > 0)
   {
     m_pDemuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(m_pInputStream));
     if(!m_pDemuxer && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER))
@@ -1312,6 +1327,8 @@ void CVideoPlayer::Prepare()
   UpdatePlayState(0);
 
   SetCaching(CACHESTATE_FLUSH);
+
+  m_channelPreloader.Update(m_item);
 }
 
 void CVideoPlayer::Process()
@@ -2433,6 +2450,15 @@ void CVideoPlayer::OnExit()
   // subtitles are added from video player. after video player has finished, overlays have to be cleared.
   CloseStream(m_CurrentSubtitle, false);  // clear overlay container
 
+  m_channelPreloader.Clear();
+  m_pPreloadedDemuxer.reset();
+
+  CDVDDemuxPacketPool& packetPool = CDVDDemuxPacketPool::Get();
+  const CDVDDemuxPacketPool::Stats poolStats = packetPool.GetStats();
+  CLog::Log(LOGDEBUG, "CVideoPlayer::OnExit() - packet pool: {} of {} buffers recycled, peak {} kB",
+            poolStats.hits, poolStats.allocations, poolStats.peakBytes / 1024);
+  packetPool.Trim();
+
   CServiceBroker::GetWinSystem()->UnregisterRenderLoop(this);
 
   IPlayerCallback *cb = &m_callback;
@@ -3183,6 +3209,20 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
       if (m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
         strBuf += StringUtils::Format(" {} msec", DVD_TIME_TO_MSEC(m_State.cache_delay));
     }
+    if (m_State.cache_rates.size() > 1)
+    {
+      std::vector<std::string> rates;
+      for (unsigned rate : m_State.cache_rates)
+        rates.emplace_back(StringUtils::SizeToString(rate) + "/s");
+      strBuf += StringUtils::Format(" src:{}", StringUtils::Join(rates, "|"));
+    }
+    if (m_State.cache_readahead > 0)
+    {
+      strBuf += StringUtils::Format(" ra:{}", StringUtils::SizeToString(m_State.cache_readahead));
+      if (m_State.cache_throttle > 0)
+        strBuf +=
+            StringUtils::Format(" thr:{}/s", StringUtils::SizeToString(m_State.cache_throttle));
+    }
 
     strGeneralInfo = StringUtils::Format("Player: a/v:{: 6.3f}, {}", dDiff, strBuf);
   }
@@ -3564,6 +3604,9 @@ bool CVideoPlayer::OpenAudioStream(CDVDStreamInfo& hint, bool reset)
 
 bool CVideoPlayer::OpenVideoStream(CDVDStreamInfo& hint, bool reset)
 {
+  // the decoder keeps its delay low for live streams
+  m_processInfo->SetStateRealtime(m_pInputStream && m_pInputStream->IsRealtime());
+
   if (m_pInputStream && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD))
   {
     /* set aspect ratio as requested by navigator for dvd's */
@@ -4732,15 +4775,35 @@ void CVideoPlayer::UpdatePlayState(double timeout)
     state.cache_offset = GetQueueTime() / state.timeMax;
   }
 
-  XFILE::SCacheStatus status;
+  XFILE::SCacheStatus status = {};
   if (m_pInputStream && m_pInputStream->GetCacheStatus(&status))
   {
     state.cache_bytes = status.forward;
     if(state.timeMax)
       state.cache_bytes += m_pInputStream->GetLength() * (int64_t) (GetQueueTime() / state.timeMax);
+    const unsigned connections = std::min(status.connections, XFILE::CACHE_MAX_CONNECTIONS);
+    state.cache_rates.assign(status.conrate, status.conrate + connections);
+
+    CDataCacheCore::SCacheInfo info;
+    if (CServiceBroker::GetDataCacheCore().GetCacheInfo(
+            CURL::GetRedacted(URIUtils::SubstitutePath(m_pInputStream->GetFileName())), info))
+    {
+      state.cache_readahead = info.readAhead;
+      state.cache_throttle = info.throttleRate;
+    }
+    else
+    {
+      state.cache_readahead = 0;
+      state.cache_throttle = 0;
+    }
   }
   else
+  {
     state.cache_bytes = 0;
+    state.cache_rates.clear();
+    state.cache_readahead = 0;
+    state.cache_throttle = 0;
+  }
 
   state.timestamp = m_clock.GetAbsoluteClock();
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "ChannelPreloader.h"
 #include "DVDClock.h"
 #include "DVDMessageQueue.h"
 #include "Edl.h"
@@ -55,6 +56,9 @@ struct SPlayerState
     cache_level = 0.0;
     cache_delay = 0.0;
     cache_offset = 0.0;
+    cache_rates.clear();
+    cache_readahead = 0;
+    cache_throttle = 0;
     lastSeek = 0;
     streamsReady = false;
   }
@@ -86,6 +90,9 @@ struct SPlayerState
   double cache_level;   // current estimated required cache level
   double cache_delay;   // time until cache is expected to reach estimated level
   double cache_offset;  // percentage of file ahead of current position
+  std::vector<unsigned> cache_rates; // read rate of each source connection filling the cache
+  int64_t cache_readahead; // adaptive read-ahead of the cache, 0 if not adaptive
+  unsigned cache_throttle; // fill rate limit of the cache beyond the read-ahead
 };
 
 class CDVDInputStream;
@@ -500,6 +507,8 @@ protected:
 
   std::shared_ptr<CDVDInputStream> m_pInputStream;
   std::unique_ptr<CDVDDemux> m_pDemuxer;
+  std::unique_ptr<CDVDDemux> m_pPreloadedDemuxer;
+  CChannelPreloader m_channelPreloader;
   std::shared_ptr<CDVDDemux> m_pSubtitleDemuxer;
   std::unordered_map<int64_t, std::shared_ptr<CDVDDemux>> m_subtitleDemuxerMap;
   std::unique_ptr<CDVDDemuxCC> m_pCCDemuxer;
@@ -61,6 +61,8 @@ CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent
 
   m_messageQueue.SetMaxDataSize(6 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
+  m_messageQueue.SetSizePolicy(std::make_unique<CDVDQueueSizePolicy>(1024 * 1024));
+  m_queueDataSize = 0;
 }
 
 CVideoPlayerAudio::~CVideoPlayerAudio()
@@ -191,6 +193,8 @@ void CVideoPlayerAudio::UpdatePlayerInfo()
 {
   std::ostringstream s;
   s << "aq:"     << std::setw(2) << std::min(99,m_messageQueue.GetLevel()) << "%";
+  s << " of " << std::fixed << std::setprecision(1)
+    << m_messageQueue.GetMaxDataSize() / (1024.0 * 1024.0) << "MB";
   s << ", Kb/s:" << std::fixed << std::setprecision(2) << m_audioStats.GetBitrate() / 1024.0;
 
   //print the inverse of the resample ratio, since that makes more sense
@@ -198,6 +202,14 @@ void CVideoPlayerAudio::UpdatePlayerInfo()
   if (m_synctype == SYNC_RESAMPLE)
     s << ", rr:" << std::fixed << std::setprecision(5) << 1.0 / m_audioSink.GetResampleRatio();
 
+  const int queueDataSize = m_messageQueue.GetMaxDataSize();
+  if (queueDataSize != m_queueDataSize)
+  {
+    m_queueDataSize = queueDataSize;
+    m_processInfo.SetAudioQueueInfo(m_queueDataSize, 1.0 / m_messageQueue.GetMaxTimeSize(),
+                                    m_messageQueue.GetBitrate());
+  }
+
   SInfo info;
   info.info        = s.str();
   info.pts         = m_audioSink.GetPlayingPts();
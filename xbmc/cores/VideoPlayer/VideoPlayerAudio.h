@@ -97,6 +97,7 @@ protected:
 
   bool   m_prevskipped;
   double m_maxspeedadjust;
+  int m_queueDataSize; // byte limit of the message queue last reported
 
   struct SInfo
   {
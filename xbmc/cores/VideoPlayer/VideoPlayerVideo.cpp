@@ -65,6 +65,8 @@ CVideoPlayerVideo::CVideoPlayerVideo(CDVDClock* pClock
   m_fForcedAspectRatio = 0;
   m_messageQueue.SetMaxDataSize(40 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
+  m_messageQueue.SetSizePolicy(std::make_unique<CDVDQueueSizePolicy>(8 * 1024 * 1024));
+  m_queueDataSize = 0;
 
   m_iDroppedFrames = 0;
   m_fFrameRate = 25;
@@ -292,6 +294,14 @@ inline MsgQueueReturnCode CVideoPlayerVideo::GetMessage(std::shared_ptr<CDVDMsg>
 {
   MsgQueueReturnCode ret = m_messageQueue.Get(pMsg, iTimeoutInMilliSeconds, priority);
   m_processInfo.SetLevelVQ(m_messageQueue.GetLevel());
+
+  const int queueDataSize = m_messageQueue.GetMaxDataSize();
+  if (queueDataSize != m_queueDataSize)
+  {
+    m_queueDataSize = queueDataSize;
+    m_processInfo.SetVideoQueueInfo(m_queueDataSize, 1.0 / m_messageQueue.GetMaxTimeSize(),
+                                    m_messageQueue.GetBitrate());
+  }
   return ret;
 }
 
@@ -937,6 +947,7 @@ std::string CVideoPlayerVideo::GetPlayerInfo()
 {
   std::ostringstream s;
   s << "vq:"   << std::setw(2) << std::min(99, m_processInfo.GetLevelVQ()) << "%";
+  s << " of " << m_messageQueue.GetMaxDataSize() / (1024 * 1024) << "MB";
   s << ", Mb/s:" << std::fixed << std::setprecision(2) << (double)GetVideoBitrate() / (1024.0*1024.0);
   s << ", fr:"     << std::fixed << std::setprecision(3) << m_fFrameRate;
   s << ", drop:" << m_iDroppedFrames;
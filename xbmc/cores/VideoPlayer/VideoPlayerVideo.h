@@ -108,6 +108,7 @@ protected:
 
   int m_iLateFrames;
   int m_iDroppedFrames;
+  int m_queueDataSize; // byte limit of the message queue last reported
   int m_iDroppedRequest;
 
   double m_fFrameRate;       //framerate of the video currently playing
@@ -43,6 +43,8 @@ protected:
   bool LoadShadersHook() override;
   bool RenderHook(int idx) override;
   void AfterRenderHook(int idx) override;
+  // the frames are copied by UploadTexture, if they are not imported
+  bool CanCopyOnAdd() override { return false; };
 
   // textures
   bool UploadTexture(int index) override;
@@ -49,6 +49,9 @@
 //! is a multiple of 128 and deinterlacing is on
 #define PBO_OFFSET 16
 
+// how long a released buffer waits for the texture update from its pixel buffers, in ns
+#define PBO_FENCE_TIMEOUT 100000000
+
 using namespace Shaders;
 
 static const GLubyte stipple_weave[] = {
@@ -92,8 +95,11 @@ CLinuxRendererGL::CPictureBuffer::CPictureBuffer()
   memset(&fields, 0, sizeof(fields));
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
+  memset(&pboData, 0, sizeof(pboData));
+  fence = nullptr;
   videoBuffer = nullptr;
   loaded = false;
+  copied = false;
 }
 
 CBaseRenderer* CLinuxRendererGL::Create(CVideoBuffer *buffer)
@@ -233,6 +239,18 @@ bool CLinuxRendererGL::Configure(const VideoPicture &picture, float fps, unsigne
   m_pixelRatio = 1.0;
 
   m_pboSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object");
+#if defined(GL_MAP_PERSISTENT_BIT)
+  m_pboPersistent = m_pboSupported &&
+                    CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_buffer_storage");
+#endif
+
+  // the pixel buffers are sized for the old format until the textures are recreated,
+  // AddVideoPicture must not copy into them anymore
+  for (auto& buf : m_buffers)
+  {
+    CSingleLock lock(buf.section);
+    memset(&buf.pboData, 0, sizeof(buf.pboData));
+  }
 
   // setup the background colour
   m_clearColour = CServiceBroker::GetWinSystem()->UseLimitedColor() ? (16.0f / 0xff) : 0.0f;
@@ -285,11 +303,36 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
   buf.lightMetadata = picture.lightMetadata;
   if (picture.hasLightMetadata && picture.lightMetadata.MaxCLL)
     buf.hasLightMetadata = picture.hasLightMetadata;
+
+  // with persistently mapped pixel buffers the planes are copied right here in the
+  // video thread, the render thread only updates the textures from them
+  buf.copied = false;
+  if (CanCopyOnAdd())
+  {
+    CSingleLock lock(buf.section);
+    if (buf.pboData[0])
+    {
+      YuvImage dst = buf.image;
+      for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+        dst.plane[p] = buf.pboData[p];
+      CopyPicture(buf, dst);
+      buf.copied = true;
+    }
+  }
 }
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
   CPictureBuffer &buf = m_buffers[idx];
+  // released without asking NeedBuffer, e.g. on flush
+  if (buf.fence)
+  {
+    glClientWaitSync(buf.fence, GL_SYNC_FLUSH_COMMANDS_BIT, PBO_FENCE_TIMEOUT);
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
+  buf.copied = false;
+
   if (buf.videoBuffer)
   {
     buf.videoBuffer->Release();
@@ -297,6 +340,25 @@ void CLinuxRendererGL::ReleaseBuffer(int idx)
   }
 }
 
+bool CLinuxRendererGL::NeedBuffer(int idx)
+{
+  // the pixel buffers are not written again before the textures are updated from them
+  CPictureBuffer &buf = m_buffers[idx];
+  if (buf.fence)
+  {
+    GLint state;
+    GLsizei length;
+    glGetSynciv(buf.fence, GL_SYNC_STATUS, 1, &length, &state);
+    if (state != GL_SIGNALED)
+      return true;
+
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
+
+  return false;
+}
+
 void CLinuxRendererGL::GetPlaneTextureSize(CYuvPlane& plane)
 {
   /* texture is assumed to be bound */
@@ -956,6 +1018,8 @@ void CLinuxRendererGL::LoadShaders(int field)
   if (m_pboSupported)
   {
     CLog::Log(LOGINFO, "GL: Using GL_ARB_pixel_buffer_object");
+    if (m_pboPersistent)
+      CLog::Log(LOGINFO, "GL: Using GL_ARB_buffer_storage");
     m_pboUsed = true;
   }
   else
@@ -1731,6 +1795,8 @@ GLint CLinuxRendererGL::GetInternalFormat(GLint format, int bpp)
 
 bool CLinuxRendererGL::CreateTexture(int index)
 {
+  CSingleLock lock(m_buffers[index].section);
+
   if (m_format == AV_PIX_FMT_NV12)
     return CreateNV12Texture(index);
   else if (m_format == AV_PIX_FMT_YUYV422 ||
@@ -1743,7 +1809,9 @@ bool CLinuxRendererGL::CreateTexture(int index)
 void CLinuxRendererGL::DeleteTexture(int index)
 {
   CPictureBuffer& buf = m_buffers[index];
+  CSingleLock lock(buf.section);
   buf.loaded = false;
+  buf.copied = false;
 
   if (m_format == AV_PIX_FMT_NV12)
     DeleteNV12Texture(index);
@@ -1756,44 +1824,44 @@ void CLinuxRendererGL::DeleteTexture(int index)
 
 bool CLinuxRendererGL::UploadTexture(int index)
 {
-  if (!m_buffers[index].videoBuffer)
+  CPictureBuffer &buf = m_buffers[index];
+  if (!buf.videoBuffer)
     return false;
 
   bool ret = true;
 
-  if (!m_buffers[index].loaded)
+  if (!buf.loaded)
   {
     ret = false;
 
-    YuvImage &dst = m_buffers[index].image;
-    YuvImage src;
-    m_buffers[index].videoBuffer->GetPlanes(src.plane);
-    m_buffers[index].videoBuffer->GetStrides(src.stride);
-
-    UnBindPbo(m_buffers[index]);
+    // AddVideoPicture has copied the planes already if the pixel buffers are mapped for good
+    if (!buf.copied)
+    {
+      UnBindPbo(buf);
+      CopyPicture(buf, buf.image);
+    }
+    BindPbo(buf);
 
     if (m_format == AV_PIX_FMT_NV12)
-    {
-      CVideoBuffer::CopyNV12Picture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadNV12Texture(index);
-    }
     else if (m_format == AV_PIX_FMT_YUYV422 ||
              m_format == AV_PIX_FMT_UYVY422)
-    {
-      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYUV422PackedTexture(index);
-    }
     else
-    {
-      CVideoBuffer::CopyPicture(&dst, &src);
-      BindPbo(m_buffers[index]);
       ret = UploadYV12Texture(index);
-    }
 
     if (ret)
-      m_buffers[index].loaded = true;
+    {
+      buf.loaded = true;
+
+      // the buffer is handed back to the decoder once the textures are updated
+      if (buf.pboData[0])
+      {
+        if (buf.fence)
+          glDeleteSync(buf.fence);
+        buf.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      }
+    }
   }
 
   if (ret)
@@ -1864,8 +1932,7 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
     for (int i = 0; i < 3; i++)
     {
       glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[i]);
-      glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-      void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+      void* pboPtr = MapPbo(im.planesize[i] + PBO_OFFSET);
       if (pboPtr)
       {
         im.plane[i] = (uint8_t*) pboPtr + PBO_OFFSET;
@@ -1889,6 +1956,11 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
       glDeleteBuffers(3, pbo);
       memset(m_buffers[index].pbo, 0, sizeof(m_buffers[index].pbo));
     }
+    else if (m_pboPersistent)
+    {
+      for (int i = 0; i < 3; i++)
+        m_buffers[index].pboData[i] = im.plane[i];
+    }
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
   }
@@ -2046,6 +2118,13 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
     }
   }
 
+  // the fence of the last upload goes with the pixel buffers
+  if (m_buffers[index].fence)
+  {
+    glDeleteSync(m_buffers[index].fence);
+    m_buffers[index].fence = nullptr;
+  }
+
   for(int p = 0;p<YuvImage::MAX_PLANES;p++)
   {
     if (pbo[p])
@@ -2059,6 +2138,7 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
       }
       glDeleteBuffers(1, pbo + p);
       pbo[p] = 0;
+      m_buffers[index].pboData[p] = nullptr;
     }
     else
     {
@@ -2170,8 +2250,7 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
     for (int i = 0; i < 2; i++)
     {
       glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[i]);
-      glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-      void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+      void* pboPtr = MapPbo(im.planesize[i] + PBO_OFFSET);
       if (pboPtr)
       {
         im.plane[i] = (uint8_t*)pboPtr + PBO_OFFSET;
@@ -2195,6 +2274,11 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
       glDeleteBuffers(2, pbo);
       memset(m_buffers[index].pbo, 0, sizeof(m_buffers[index].pbo));
     }
+    else if (m_pboPersistent)
+    {
+      for (int i = 0; i < 2; i++)
+        m_buffers[index].pboData[i] = im.plane[i];
+    }
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
   }
@@ -2288,6 +2372,12 @@ void CLinuxRendererGL::DeleteNV12Texture(int index)
     buf.fields[f][2].id = 0;
   }
 
+  if (buf.fence)
+  {
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
+
   for(int p = 0;p<2;p++)
   {
     if (pbo[p])
@@ -2301,6 +2391,7 @@ void CLinuxRendererGL::DeleteNV12Texture(int index)
       }
       glDeleteBuffers(1, pbo + p);
       pbo[p] = 0;
+      m_buffers[index].pboData[p] = nullptr;
     }
     else
     {
@@ -2376,6 +2467,12 @@ void CLinuxRendererGL::DeleteYUV422PackedTexture(int index)
     buf.fields[f][2].id = 0;
   }
 
+  if (buf.fence)
+  {
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
+
   if (pbo[0])
   {
     if (im.plane[0])
@@ -2387,6 +2484,7 @@ void CLinuxRendererGL::DeleteYUV422PackedTexture(int index)
     }
     glDeleteBuffers(1, pbo);
     pbo[0] = 0;
+    m_buffers[index].pboData[0] = nullptr;
   }
   else
   {
@@ -2436,8 +2534,7 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
     glGenBuffers(1, pbo);
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo[0]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, im.planesize[0] + PBO_OFFSET, 0, GL_STREAM_DRAW);
-    void* pboPtr = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    void* pboPtr = MapPbo(im.planesize[0] + PBO_OFFSET);
     if (pboPtr)
     {
       im.plane[0] = (uint8_t*)pboPtr + PBO_OFFSET;
@@ -2456,6 +2553,8 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
       glDeleteBuffers(1, pbo);
       memset(m_buffers[index].pbo, 0, sizeof(m_buffers[index].pbo));
     }
+    else if (m_pboPersistent)
+      m_buffers[index].pboData[0] = im.plane[0];
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
   }
@@ -2610,6 +2709,22 @@ bool CLinuxRendererGL::Supports(ESCALINGMETHOD method)
   return false;
 }
 
+void* CLinuxRendererGL::MapPbo(GLsizeiptr size)
+{
+#if defined(GL_MAP_PERSISTENT_BIT)
+  if (m_pboPersistent)
+  {
+    // mapped until the buffer is deleted, the textures are updated from it meanwhile
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+    return glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+  }
+#endif
+
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, size, 0, GL_STREAM_DRAW);
+  return glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+}
+
 void CLinuxRendererGL::BindPbo(CPictureBuffer& buff)
 {
   bool pbo = false;
@@ -2617,6 +2732,12 @@ void CLinuxRendererGL::BindPbo(CPictureBuffer& buff)
   {
     if(!buff.pbo[plane] || buff.image.plane[plane] == (uint8_t*)PBO_OFFSET)
       continue;
+
+    if (buff.pboData[plane])
+    {
+      buff.image.plane[plane] = (uint8_t*)PBO_OFFSET;
+      continue;
+    }
     pbo = true;
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buff.pbo[plane]);
@@ -2634,6 +2755,13 @@ void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
   {
     if(!buff.pbo[plane] || buff.image.plane[plane] != (uint8_t*)PBO_OFFSET)
       continue;
+
+    // no need to orphan it, the buffer isn't reused before the last update is done
+    if (buff.pboData[plane])
+    {
+      buff.image.plane[plane] = buff.pboData[plane];
+      continue;
+    }
     pbo = true;
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buff.pbo[plane]);
@@ -2644,6 +2772,21 @@ void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
+void CLinuxRendererGL::CopyPicture(CPictureBuffer& buff, YuvImage& dst)
+{
+  YuvImage src;
+  buff.videoBuffer->GetPlanes(src.plane);
+  buff.videoBuffer->GetStrides(src.stride);
+
+  if (m_format == AV_PIX_FMT_NV12)
+    CVideoBuffer::CopyNV12Picture(&dst, &src);
+  else if (m_format == AV_PIX_FMT_YUYV422 ||
+           m_format == AV_PIX_FMT_UYVY422)
+    CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
+  else
+    CVideoBuffer::CopyPicture(&dst, &src);
+}
+
 CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
@@ -20,6 +20,7 @@
 #include "windowing/GraphicContext.h"
 #include "BaseRenderer.h"
 #include "ColorManager.h"
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 #include "VideoShaders/ShaderFormats.h"
 #include "utils/Geometry.h"
@@ -81,6 +82,7 @@ public:
   bool Flush(bool saveBuffers) override;
   void SetBufferSize(int numBuffers) override { m_NumYV12Buffers = numBuffers; }
   void ReleaseBuffer(int idx) override;
+  bool NeedBuffer(int idx) override;
   void RenderUpdate(int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override;
   void Update() override;
   bool RenderCapture(CRenderCapture* capture) override;
@@ -135,8 +137,10 @@ protected:
   struct CYuvPlane;
   struct CPictureBuffer;
 
+  void* MapPbo(GLsizeiptr size);
   void BindPbo(CPictureBuffer& buff);
   void UnBindPbo(CPictureBuffer& buff);
+  void CopyPicture(CPictureBuffer& buff, YuvImage& dst);
   void LoadPlane(CYuvPlane& plane, int type,
                  unsigned width,  unsigned height,
                  int stride, int bpp, void* data);
@@ -148,6 +152,7 @@ protected:
   virtual bool RenderHook(int idx) { return false; };
   virtual void AfterRenderHook(int idx) {};
   virtual bool CanSaveBuffers() { return true; };
+  virtual bool CanCopyOnAdd() { return true; };
 
   struct
   {
@@ -191,9 +196,15 @@ protected:
     CYuvPlane fields[MAX_FIELDS][YuvImage::MAX_PLANES];
     YuvImage image;
     GLuint pbo[3]; // one pbo for 3 planes
+    uint8_t* pboData[3]; // planes of persistently mapped pbos
+    GLsync fence;
 
     CVideoBuffer *videoBuffer;
     bool loaded;
+    bool copied; // planes copied into the pbos by AddVideoPicture
+
+    // guards the pbo mapping against the copy in AddVideoPicture
+    CCriticalSection section;
 
     AVColorPrimaries m_srcPrimaries;
     AVColorSpace m_srcColSpace;
@@ -224,6 +235,7 @@ protected:
   float m_clearColour = 0.0f;
   bool m_pboSupported = true;
   bool m_pboUsed = false;
+  bool m_pboPersistent = false;
   bool m_nonLinStretch = false;
   bool m_nonLinStretchGui = false;
   float m_pixelRatio = 0.0f;
@@ -26,6 +26,7 @@
 #include "threads/SingleLock.h"
 #include "utils/GLUtils.h"
 #include "utils/MathUtils.h"
+#include "utils/PlaneCopy.h"
 #include "utils/log.h"
 #include "windowing/WinSystem.h"
 
@@ -305,11 +306,8 @@ void CLinuxRendererGLES::LoadPlane(CYuvPlane& plane, int type,
         m_planeBufferSize = planeSize;
       }
 
-      unsigned char *src(static_cast<unsigned char*>(data)),
-                    *dst(m_planeBuffer);
-
-      for (unsigned int y = 0; y < height; ++y, src += stride, dst += width * bps)
-        memcpy(dst, src, width * bps);
+      CPlaneCopy::Copy(m_planeBuffer, width * bps, static_cast<const uint8_t*>(data), stride,
+                       width * bps, height);
 
       pixelData = m_planeBuffer;
     }
@@ -12,6 +12,7 @@
 #include "VideoRenderers/BaseRenderer.h"
 #include "WIN32Util.h"
 #include "rendering/dx/RenderContext.h"
+#include "utils/PlaneCopy.h"
 #include "utils/log.h"
 #include "utils/memcpy_sse2.h"
 #include "windowing/GraphicContext.h"
@@ -356,11 +357,12 @@ bool CRendererDXVA::CRenderBufferImpl::UploadToTexture()
       copy_plane(src[0], srcStrides[0], height, width, dst[0], dstStride[0]);
     }, [&]() {
       // convert U+V -> UV
-      convert_yuv420_nv12_chrome(&src[1], &srcStrides[1], height, width, dst[1], dstStride[1]);
+      CPlaneCopy::InterleaveUV(dst[1], dstStride[1], src[1], srcStrides[1], src[2], srcStrides[2],
+                               (width + 1) >> 1, height >> 1);
     });
     // copy cache size of UV line again to fix Intel cache issue
-    // height and width multiplied by two because they will be divided by func
-    convert_yuv420_nv12_chrome(&src[1], &srcStrides[1], 2, 64, dst[1], dstStride[1]);
+    CPlaneCopy::InterleaveUV(dst[1], dstStride[1], src[1], srcStrides[1], src[2], srcStrides[2],
+                             32, 1);
   }
   // convert 10/16bit
   else if (buffer_format == AV_PIX_FMT_YUV420P10 ||
@@ -369,14 +371,15 @@ bool CRendererDXVA::CRenderBufferImpl::UploadToTexture()
     const uint8_t bpp = buffer_format == AV_PIX_FMT_YUV420P10 ? 10 : 16;
     Concurrency::parallel_invoke([&]() {
       // copy Y
-      copy_plane(src[0], srcStrides[0], height, width, dst[0], dstStride[0], bpp);
+      CPlaneCopy::PackP010(dst[0], dstStride[0], src[0], srcStrides[0], width, height, bpp);
     }, [&]() {
       // convert U+V -> UV
-      convert_yuv420_p01x_chrome(&src[1], &srcStrides[1], height, width, dst[1], dstStride[1], bpp);
+      CPlaneCopy::InterleaveP010(dst[1], dstStride[1], src[1], srcStrides[1], src[2],
+                                 srcStrides[2], (width + 1) >> 1, height >> 1, bpp);
     });
     // copy cache size of UV line again to fix Intel cache issue
-    // height multiplied by two because it will be divided by func
-    convert_yuv420_p01x_chrome(&src[1], &srcStrides[1], 2, 32, dst[1], dstStride[1], bpp);
+    CPlaneCopy::InterleaveP010(dst[1], dstStride[1], src[1], srcStrides[1], src[2], srcStrides[2],
+                               16, 1, bpp);
   }
 
   m_bLoaded = m_texture.UnlockRect(0);
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2005-2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/Interface/DemuxPacket.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+std::shared_ptr<CDVDMsg> Packet(int size = 100)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  return std::make_shared<CDVDMsgDemuxerPacket>(packet);
+}
+
+std::shared_ptr<CDVDMsg> Message()
+{
+  return std::make_shared<CDVDMsg>(CDVDMsg::GENERAL_RESYNC);
+}
+
+// takes the next message without waiting, nullptr if there is none
+std::shared_ptr<CDVDMsg> Take(CDVDMessageQueue& queue, int& priority)
+{
+  std::shared_ptr<CDVDMsg> msg;
+  if (queue.Get(msg, 0, priority) != MSGQ_OK)
+    return nullptr;
+  return msg;
+}
+
+std::shared_ptr<CDVDMsg> Take(CDVDMessageQueue& queue)
+{
+  int priority = 0;
+  return Take(queue, priority);
+}
+
+} // namespace
+
+// packets take the ring until it's full, other messages the list, the order is kept across both
+TEST(TestDVDMessageQueue, InterleavedOrder)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  std::vector<std::shared_ptr<CDVDMsg>> put;
+  for (int i = 0; i < 5000; i++)
+  {
+    put.push_back(i % 3 == 2 ? Message() : Packet());
+    EXPECT_EQ(MSGQ_OK, queue.Put(put.back()));
+  }
+
+  for (size_t i = 0; i < put.size(); i++)
+  {
+    const std::shared_ptr<CDVDMsg> msg = Take(queue);
+    ASSERT_EQ(put[i], msg) << "message " << i;
+  }
+  EXPECT_EQ(nullptr, Take(queue));
+  EXPECT_EQ(0, queue.GetDataSize());
+}
+
+TEST(TestDVDMessageQueue, Priority)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  const std::shared_ptr<CDVDMsg> packet = Packet();
+  const std::shared_ptr<CDVDMsg> low = Message();
+  const std::shared_ptr<CDVDMsg> high = Message();
+  const std::shared_ptr<CDVDMsg> highBack = Message();
+  EXPECT_EQ(MSGQ_OK, queue.Put(packet));
+  EXPECT_EQ(MSGQ_OK, queue.Put(low, 1));
+  EXPECT_EQ(MSGQ_OK, queue.Put(high, 2));
+  // put back in front of the messages of the same priority
+  EXPECT_EQ(MSGQ_OK, queue.PutBack(highBack, 2));
+
+  // asking for a minimum priority leaves the rest alone
+  int priority = 3;
+  EXPECT_EQ(nullptr, Take(queue, priority));
+
+  priority = 2;
+  EXPECT_EQ(highBack, Take(queue, priority));
+  EXPECT_EQ(2, priority);
+  EXPECT_EQ(high, Take(queue, priority));
+  EXPECT_EQ(nullptr, Take(queue, priority));
+
+  priority = 0;
+  EXPECT_EQ(low, Take(queue, priority));
+  EXPECT_EQ(1, priority);
+  priority = 0;
+  EXPECT_EQ(packet, Take(queue, priority));
+  EXPECT_EQ(0, priority);
+}
+
+TEST(TestDVDMessageQueue, FlushPackets)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  // enough packets to spill from the ring into the list
+  std::vector<std::shared_ptr<CDVDMsg>> messages;
+  for (int i = 0; i < 3000; i++)
+  {
+    if (i % 1000 == 500)
+    {
+      messages.push_back(Message());
+      EXPECT_EQ(MSGQ_OK, queue.Put(messages.back()));
+    }
+    else
+      EXPECT_EQ(MSGQ_OK, queue.Put(Packet()));
+  }
+  EXPECT_EQ(100 * (3000 - 3), queue.GetDataSize());
+
+  queue.Flush();
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  for (const auto& message : messages)
+    EXPECT_EQ(message, Take(queue));
+  EXPECT_EQ(nullptr, Take(queue));
+
+  // the ring is usable again
+  const std::shared_ptr<CDVDMsg> packet = Packet();
+  EXPECT_EQ(MSGQ_OK, queue.Put(packet));
+  EXPECT_EQ(packet, Take(queue));
+}
+
+TEST(TestDVDMessageQueue, PutBack)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  const std::shared_ptr<CDVDMsg> first = Packet();
+  const std::shared_ptr<CDVDMsg> second = Message();
+  const std::shared_ptr<CDVDMsg> third = Packet();
+  EXPECT_EQ(MSGQ_OK, queue.Put(first));
+  EXPECT_EQ(MSGQ_OK, queue.Put(second));
+  EXPECT_EQ(MSGQ_OK, queue.Put(third));
+
+  // messages put back are taken before anything put, the last put back first
+  EXPECT_EQ(first, Take(queue));
+  EXPECT_EQ(second, Take(queue));
+  EXPECT_EQ(MSGQ_OK, queue.PutBack(second));
+  EXPECT_EQ(MSGQ_OK, queue.PutBack(first));
+
+  const std::shared_ptr<CDVDMsg> fourth = Packet();
+  EXPECT_EQ(MSGQ_OK, queue.Put(fourth));
+
+  EXPECT_EQ(first, Take(queue));
+  EXPECT_EQ(second, Take(queue));
+  EXPECT_EQ(third, Take(queue));
+  EXPECT_EQ(fourth, Take(queue));
+  EXPECT_EQ(nullptr, Take(queue));
+  EXPECT_EQ(0, queue.GetDataSize());
+}
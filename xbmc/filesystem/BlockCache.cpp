@@ -0,0 +1,402 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "BlockCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+constexpr int64_t BLOCK_SIZE = 1024 * 1024;
+constexpr char INDEX_MAGIC[4] = {'K', 'B', 'C', '1'};
+
+struct IndexHeader
+{
+  char magic[4];
+  uint32_t blockSize;
+  int64_t fileSize;
+  uint64_t cachedBytes;
+};
+
+bool ReadIndexHeader(IFile& file, const std::string& path, IndexHeader& header)
+{
+  if (!file.Open(CURL(path)))
+    return false;
+
+  const bool valid = file.Read(&header, sizeof(header)) == sizeof(header) &&
+                     memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+                     header.blockSize == BLOCK_SIZE;
+  if (!valid)
+    file.Close();
+  return valid;
+}
+} // namespace
+
+CBlockCacheFile::CBlockCacheFile(CBlockCache& owner,
+                                 const std::string& path,
+                                 int64_t fileSize,
+                                 uint64_t maxBytes)
+  : m_owner(owner),
+    m_path(path),
+    m_fileSize(fileSize),
+    m_maxBytes(maxBytes),
+    m_blocks((fileSize + BLOCK_SIZE - 1) / BLOCK_SIZE / 8 + 1)
+{
+}
+
+CBlockCacheFile::~CBlockCacheFile()
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (m_data)
+    {
+      // saved even if unchanged, the index time stamp is the last use after a restart
+      SaveIndex();
+      m_data->Close();
+    }
+  }
+
+  m_owner.OnReleased(m_path, m_cachedBytes);
+}
+
+bool CBlockCacheFile::Open()
+{
+  CSingleLock lock(m_critSection);
+
+  const bool indexLoaded = LoadIndex();
+
+  m_data.reset(new CacheLocalFile());
+  if (!m_data->OpenForWrite(CURL(m_path + ".data"), !indexLoaded))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"{}.data\"", m_path);
+    m_data.reset();
+    return false;
+  }
+
+  return true;
+}
+
+ssize_t CBlockCacheFile::Read(int64_t iFilePosition, void* buffer, size_t size)
+{
+  CSingleLock lock(m_critSection);
+
+  size_t total = 0;
+  while (total < size && iFilePosition < m_fileSize)
+  {
+    const int64_t block = iFilePosition / BLOCK_SIZE;
+    if (!IsBlockCached(block))
+      break;
+
+    const int64_t blockEnd = std::min((block + 1) * BLOCK_SIZE, m_fileSize);
+    const size_t readSize = std::min<int64_t>(size - total, blockEnd - iFilePosition);
+    if (m_data->Seek(iFilePosition, SEEK_SET) != iFilePosition)
+      break;
+
+    const ssize_t iRead = m_data->Read(static_cast<char*>(buffer) + total, readSize);
+    if (iRead <= 0)
+      break;
+
+    total += iRead;
+    iFilePosition += iRead;
+  }
+
+  return total;
+}
+
+int64_t CBlockCacheFile::GetCachedSize(int64_t iFilePosition, int64_t maxSize)
+{
+  CSingleLock lock(m_critSection);
+
+  int64_t pos = iFilePosition;
+  while (pos < m_fileSize && pos - iFilePosition < maxSize && IsBlockCached(pos / BLOCK_SIZE))
+    pos = std::min((pos / BLOCK_SIZE + 1) * BLOCK_SIZE, m_fileSize);
+
+  return std::min(pos - iFilePosition, maxSize);
+}
+
+void CBlockCacheFile::Write(int64_t iFilePosition, const void* buffer, size_t size)
+{
+  CSingleLock lock(m_critSection);
+
+  if (!m_data)
+    return;
+
+  // a write must not take the file past its budget, blocks it touches may complete
+  const int64_t end = iFilePosition + size;
+  uint64_t growth = 0;
+  for (int64_t block = iFilePosition / BLOCK_SIZE; block * BLOCK_SIZE < end; block++)
+  {
+    if (!IsBlockCached(block))
+      growth += std::min((block + 1) * BLOCK_SIZE, m_fileSize) - block * BLOCK_SIZE;
+  }
+  if (m_cachedBytes + growth > m_maxBytes)
+    return;
+
+  if (m_data->Seek(iFilePosition, SEEK_SET) != iFilePosition)
+    return;
+
+  size_t written = 0;
+  while (written < size)
+  {
+    const ssize_t iWrite = m_data->Write(static_cast<const char*>(buffer) + written, size - written);
+    if (iWrite <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file \"{}.data\"", m_path);
+      return;
+    }
+    written += iWrite;
+  }
+
+  for (int64_t block = iFilePosition / BLOCK_SIZE; block * BLOCK_SIZE < end; block++)
+  {
+    const int64_t blockBeg = block * BLOCK_SIZE;
+    const int64_t blockEnd = std::min(blockBeg + BLOCK_SIZE, m_fileSize);
+    if (IsBlockCached(block) ||
+        !AddToBlock(block, std::max(iFilePosition, blockBeg), std::min(end, blockEnd)))
+      continue;
+
+    m_blocks[block / 8] |= 1 << (block % 8);
+    m_cachedBytes += blockEnd - blockBeg;
+    m_modified = true;
+  }
+}
+
+bool CBlockCacheFile::IsBlockCached(int64_t block) const
+{
+  return (m_blocks[block / 8] & (1 << (block % 8))) != 0;
+}
+
+/**
+ * Adds [from, to) to the written intervals of a block.
+ * Returns true once the whole block has been written.
+ */
+bool CBlockCacheFile::AddToBlock(int64_t block, int64_t from, int64_t to)
+{
+  std::map<int64_t, int64_t>& intervals = m_partial[block];
+
+  auto it = intervals.upper_bound(from);
+  if (it != intervals.begin() && std::prev(it)->second >= from)
+  {
+    --it;
+    from = it->first;
+    to = std::max(to, it->second);
+    it = intervals.erase(it);
+  }
+  while (it != intervals.end() && it->first <= to)
+  {
+    to = std::max(to, it->second);
+    it = intervals.erase(it);
+  }
+  intervals.emplace(from, to);
+
+  const int64_t blockBeg = block * BLOCK_SIZE;
+  const int64_t blockEnd = std::min(blockBeg + BLOCK_SIZE, m_fileSize);
+  if (from > blockBeg || to < blockEnd)
+    return false;
+
+  m_partial.erase(block);
+  return true;
+}
+
+bool CBlockCacheFile::LoadIndex()
+{
+  CacheLocalFile file;
+  IndexHeader header;
+  if (!ReadIndexHeader(file, m_path + ".idx", header))
+    return false;
+
+  if (header.fileSize != m_fileSize ||
+      file.Read(m_blocks.data(), m_blocks.size()) != static_cast<ssize_t>(m_blocks.size()))
+  {
+    CLog::LogF(LOGWARNING, "discarding invalid index \"{}.idx\"", m_path);
+    std::fill(m_blocks.begin(), m_blocks.end(), 0);
+    return false;
+  }
+
+  m_cachedBytes = header.cachedBytes;
+  return true;
+}
+
+void CBlockCacheFile::SaveIndex()
+{
+  CacheLocalFile file;
+  if (!file.OpenForWrite(CURL(m_path + ".idx"), true))
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"{}.idx\"", m_path);
+    return;
+  }
+
+  IndexHeader header;
+  memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  header.blockSize = BLOCK_SIZE;
+  header.fileSize = m_fileSize;
+  header.cachedBytes = m_cachedBytes;
+
+  if (file.Write(&header, sizeof(header)) != sizeof(header) ||
+      file.Write(m_blocks.data(), m_blocks.size()) != static_cast<ssize_t>(m_blocks.size()))
+    CLog::LogF(LOGERROR, "failed to write file \"{}.idx\"", m_path);
+
+  m_modified = false;
+}
+
+CBlockCache& CBlockCache::GetInstance()
+{
+  static CBlockCache blockCache;
+  return blockCache;
+}
+
+std::shared_ptr<CBlockCacheFile> CBlockCache::Open(const CURL& url,
+                                                   int64_t fileSize,
+                                                   time_t modified)
+{
+  const uint64_t maxBytes = static_cast<uint64_t>(CServiceBroker::GetSettingsComponent()
+                                                      ->GetAdvancedSettings()
+                                                      ->m_cachePersistentSize) *
+                            1024 * 1024;
+  if (maxBytes == 0 || fileSize <= 0)
+    return nullptr;
+
+  CSingleLock lock(m_critSection);
+
+  if (!m_loaded)
+    LoadEntries();
+
+  const std::string key = CDigest::Calculate(
+      CDigest::Type::MD5, StringUtils::Format("{}|{}|{}", url.Get(), fileSize, modified));
+  const std::string path =
+      CSpecialProtocol::TranslatePath(URIUtils::AddFileToFolder("special://temp/blockcache", key));
+
+  for (auto it = m_openFiles.find(path); it != m_openFiles.end(); it = m_openFiles.find(path))
+  {
+    std::shared_ptr<CBlockCacheFile> file = it->second.lock();
+    if (file)
+      return file;
+
+    // released but still saving its index, opening the data now would truncate it
+    m_fileReleased.wait(lock);
+  }
+
+  auto file = std::make_shared<CBlockCacheFile>(*this, path, fileSize, maxBytes);
+  if (!file->Open())
+    return nullptr;
+
+  CLog::Log(LOGDEBUG, "CBlockCache::{} - <{}> has {} bytes cached", __FUNCTION__, url.GetRedacted(),
+            file->GetCachedBytes());
+
+  m_openFiles[path] = file;
+  return file;
+}
+
+void CBlockCache::OnReleased(const std::string& path, uint64_t cachedBytes)
+{
+  CSingleLock lock(m_critSection);
+
+  // openers wait for the entry to go, no new file of the path was made in the meantime
+  m_openFiles.erase(path);
+  m_fileReleased.notifyAll();
+
+  m_entries[path] = {cachedBytes, time(nullptr)};
+
+  Evict(static_cast<uint64_t>(
+            CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cachePersistentSize) *
+        1024 * 1024);
+}
+
+void CBlockCache::LoadEntries()
+{
+  m_loaded = true;
+
+  const std::string folder = "special://temp/blockcache/";
+  if (!CDirectory::Exists(folder) && !CDirectory::Create(folder))
+  {
+    CLog::Log(LOGERROR, "CBlockCache::{} - failed to create {}", __FUNCTION__, folder);
+    return;
+  }
+
+  CFileItemList items;
+  CDirectory::GetDirectory(folder, items, ".idx|.data",
+                           DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+
+  for (const auto& item : items)
+  {
+    const std::string path = CSpecialProtocol::TranslatePath(item->GetPath());
+    if (URIUtils::HasExtension(path, ".data"))
+    {
+      // data left behind without an index is of no use
+      if (!CFile::Exists(URIUtils::ReplaceExtension(path, ".idx")))
+        CFile::Delete(path);
+      continue;
+    }
+
+    CacheLocalFile file;
+    IndexHeader header;
+    if (!ReadIndexHeader(file, path, header))
+    {
+      CFile::Delete(path);
+      CFile::Delete(URIUtils::ReplaceExtension(path, ".data"));
+      continue;
+    }
+
+    time_t lastUse = 0;
+    item->m_dateTime.GetAsTime(lastUse);
+    m_entries[URIUtils::ReplaceExtension(path, "")] = {header.cachedBytes, lastUse};
+  }
+}
+
+void CBlockCache::Evict(uint64_t maxBytes)
+{
+  uint64_t total = 0;
+  for (const auto& entry : m_entries)
+    total += entry.second.cachedBytes;
+
+  while (total > maxBytes)
+  {
+    auto lru = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (m_openFiles.find(it->first) == m_openFiles.end() &&
+          (lru == m_entries.end() || it->second.lastUse < lru->second.lastUse))
+        lru = it;
+    }
+
+    if (lru == m_entries.end())
+      break; // everything left is in use
+
+    CLog::Log(LOGDEBUG, "CBlockCache::{} - removing {} ({} bytes)", __FUNCTION__, lru->first,
+              lru->second.cachedBytes);
+    CFile::Delete(lru->first + ".idx");
+    CFile::Delete(lru->first + ".data");
+    total -= lru->second.cachedBytes;
+    m_entries.erase(lru);
+  }
+}
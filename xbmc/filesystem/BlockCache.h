@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <time.h>
+
+class CURL;
+
+namespace XFILE
+{
+
+class CBlockCache;
+class IFile;
+
+/*!
+ \brief Blocks of one source file kept on local disk
+
+ Data is stored at its original offset in a sparse local file. An index
+ tracks which blocks are complete and is saved next to it when the file is
+ released, so a later open of the same source finds the blocks again. Only
+ complete blocks are ever read back.
+ */
+class CBlockCacheFile
+{
+public:
+  CBlockCacheFile(CBlockCache& owner, const std::string& path, int64_t fileSize, uint64_t maxBytes);
+  ~CBlockCacheFile();
+
+  bool Open();
+
+  /*!
+   \brief Read cached data
+   \return number of bytes read, 0 if the block at iFilePosition isn't cached
+   */
+  ssize_t Read(int64_t iFilePosition, void* buffer, size_t size);
+
+  /*!
+   \brief Number of bytes cached contiguously from iFilePosition, up to maxSize
+   */
+  int64_t GetCachedSize(int64_t iFilePosition, int64_t maxSize);
+
+  /*!
+   \brief Store source data, blocks become available once written completely
+   */
+  void Write(int64_t iFilePosition, const void* buffer, size_t size);
+
+  uint64_t GetCachedBytes() const { return m_cachedBytes; }
+
+private:
+  bool IsBlockCached(int64_t block) const;
+  bool AddToBlock(int64_t block, int64_t from, int64_t to);
+  bool LoadIndex();
+  void SaveIndex();
+
+  CBlockCache& m_owner;
+  const std::string m_path; /**< path without extension */
+  const int64_t m_fileSize;
+  const uint64_t m_maxBytes;
+  std::unique_ptr<IFile> m_data;
+  std::vector<uint8_t> m_blocks; /**< bitmap of complete blocks */
+  std::map<int64_t, std::map<int64_t, int64_t>> m_partial; /**< written intervals of incomplete blocks */
+  uint64_t m_cachedBytes = 0;
+  bool m_modified = false;
+  CCriticalSection m_critSection;
+};
+
+/*!
+ \brief Persistent read-through cache for network sources
+
+ Keeps blocks of recently played remote files in special://temp/blockcache,
+ keyed by url, size and modification time of the source. The total size is
+ capped by advancedsettings <cache><persistentsize>, the least recently
+ released files are removed first.
+ */
+class CBlockCache
+{
+public:
+  static CBlockCache& GetInstance();
+
+  /*!
+   \brief Open the cached blocks of a source file
+   \return nullptr if the persistent cache is disabled or unavailable
+   */
+  std::shared_ptr<CBlockCacheFile> Open(const CURL& url, int64_t fileSize, time_t modified);
+
+private:
+  friend class CBlockCacheFile;
+
+  CBlockCache() = default;
+  void OnReleased(const std::string& path, uint64_t cachedBytes);
+  void LoadEntries();
+  void Evict(uint64_t maxBytes);
+
+  struct Entry
+  {
+    uint64_t cachedBytes;
+    time_t lastUse;
+  };
+
+  std::map<std::string, Entry> m_entries; /**< cached files keyed by path without extension */
+  /*!
+   Files in use. An entry outlives its file until the file is done writing
+   its index, openers of the same path wait on m_fileReleased for that.
+   */
+  std::map<std::string, std::weak_ptr<CBlockCacheFile>> m_openFiles;
+  bool m_loaded = false;
+  CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_fileReleased;
+};
+
+} // namespace XFILE
@@ -470,6 +470,10 @@ void CCurlFile::SetCommonOptions(CReadState* state, bool failOnError /* = true *
 
   g_curlInterface.easy_reset(h);
 
+  // reuse DNS lookups and TLS sessions of all other transfers
+  if (g_curlInterface.GetShare())
+    g_curlInterface.easy_setopt(h, CURLOPT_SHARE, g_curlInterface.GetShare());
+
   g_curlInterface.easy_setopt(h, CURLOPT_DEBUGFUNCTION, debug_callback);
 
   if( CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_logLevel >= LOG_LEVEL_DEBUG )
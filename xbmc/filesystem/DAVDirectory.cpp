@@ -67,6 +67,16 @@ void CDAVDirectory::ParseResponse(const TiXmlElement *pElement, CFileItem &item)
                 struct tm timeDate = {};
                 strptime(pPropChild->FirstChild()->Value(), "%a, %d %b %Y %T", &timeDate);
                 item.m_dateTime = mktime(&timeDate);
+
+                // same value a HEAD request would give for Stat()
+                const CDateTime modified =
+                    CDateTime::FromRFC1123DateTime(pPropChild->FirstChild()->ValueStr());
+                if (modified.IsValid())
+                {
+                  time_t mtime;
+                  modified.GetAsTime(mtime);
+                  SetItemTimes(item, mtime, 0);
+                }
               }
               else
               if (CDAVCommon::ValueWithoutNamespace(pPropChild, "displayname") && !pPropChild->NoChildren())
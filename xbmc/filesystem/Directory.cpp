@@ -169,9 +169,22 @@ bool CDirectory::GetDirectory(const CURL& url,
     if (!pDirectory)
       return false;
 
+    const bool persistent = (hints.flags & DIR_FLAG_PERSISTENT_CACHE) &&
+                            !(hints.flags & DIR_FLAG_BYPASS_CACHE);
+    const bool fileInfo = !(hints.flags & DIR_FLAG_NO_FILE_INFO);
+    int64_t mtime = 0;
+
     // check our cache for this path
     if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
       items.SetURL(url);
+    else if (persistent &&
+             g_directoryCache.GetPersistentDirectory(realURL.Get(), items, fileInfo, mtime))
+    {
+      items.SetURL(url);
+      // a listing without size and date mustn't answer later callers that need them
+      if (fileInfo)
+        g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -254,6 +267,8 @@ bool CDirectory::GetDirectory(const CURL& url,
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
+      if (persistent)
+        g_directoryCache.SetPersistentDirectory(realURL.Get(), items, fileInfo, mtime);
     }
 
     // now filter for allowed files
@@ -9,21 +9,106 @@
 #include "DirectoryCache.h"
 
 #include "Directory.h"
+#include "File.h"
 #include "FileItem.h"
+#include "IDirectoryWatcher.h"
 #include "URL.h"
 #include "threads/SingleLock.h"
+#include "utils/Archive.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+#include "platform/linux/InotifyDirectoryWatcher.h"
+#endif
+
 #include <algorithm>
 #include <climits>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <vector>
 
 // Maximum number of directories to keep in our cache
 #define MAX_CACHED_DIRS 50
 
+// Maximum number of directory listings kept across runs
+#define MAX_PERSISTENT_DIRS 5000
+#define PERSISTENT_CACHE_FILE "special://temp/dircache.fi"
+#define PERSISTENT_CACHE_VERSION 2
+
 using namespace XFILE;
 
+namespace
+{
+
+int64_t GetModificationTime(const std::string& strPath)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(strPath, &buffer) != 0)
+    return 0;
+  return buffer.st_mtime;
+}
+
+/* Rewriting a file in place doesn't change the modification time of its
+ * directory, so size and date of the entries are only kept while a watch on
+ * the directory reports such changes.
+ */
+void ClearFileInfo(CFileItemList& items)
+{
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItem& item = *items[i];
+    item.m_dwSize = 0;
+    item.m_dateTime.Reset();
+    IDirectory::ClearItemTimes(item);
+  }
+}
+
+/* Neither a watch nor the modification time of a directory notice changes
+ * inside its subfolders, so the times listed for them get outdated.
+ */
+void ClearFolderTimes(CFileItemList& items)
+{
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      IDirectory::ClearItemTimes(*items[i]);
+  }
+}
+
+// watched directories are local, the dates of their folders are cheap to get again
+void RefreshFolderDates(CFileItemList& items)
+{
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItem& item = *items[i];
+    struct __stat64 buffer;
+    if (!item.m_bIsFolder || item.IsParentFolder() || CFile::Stat(item.GetPath(), &buffer) != 0)
+      continue;
+
+    KODI::TIME::FileTime fileTime, localTime;
+    KODI::TIME::TimeTToFileTime(buffer.st_mtime, &fileTime);
+    KODI::TIME::FileTimeToLocalFileTime(&fileTime, &localTime);
+    item.m_dateTime = localTime;
+  }
+}
+
+bool IsRecentlyModified(int64_t mtime)
+{
+  // timestamps have a granularity of a second, changes in the same second would go unnoticed
+  return mtime + 2 >= static_cast<int64_t>(time(nullptr));
+}
+
+bool IsWatchable(const std::string& strPath)
+{
+  return URIUtils::IsHD(strPath) && CURL(strPath).GetProtocol().empty();
+}
+
+} // namespace
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
@@ -46,9 +131,10 @@ void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
 CDirectoryCache::CDirectoryCache(void)
 {
   m_accessCounter = 0;
-#ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+  m_watcher.reset(new CInotifyDirectoryWatcher());
 #endif
 }
 
@@ -71,9 +157,7 @@ bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &it
     {
       items.Copy(*dir->m_Items);
       dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
       m_cacheHits+=items.Size();
-#endif
       return true;
     }
   }
@@ -132,6 +216,8 @@ void CDirectoryCache::ClearDirectory(const std::string& strPath)
   iCache i = m_cache.find(storedPath);
   if (i != m_cache.end())
     Delete(i);
+
+  ClearPersistent(storedPath);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
@@ -149,6 +235,15 @@ void CDirectoryCache::ClearSubPaths(const std::string& strPath)
     else
       i++;
   }
+
+  auto it = m_persistent.begin();
+  while (it != m_persistent.end())
+  {
+    if (URIUtils::PathHasParent(it->first, storedPath))
+      it = DeletePersistent(it);
+    else
+      ++it;
+  }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
@@ -167,6 +262,8 @@ void CDirectoryCache::AddFile(const std::string& strFile)
     dir->m_Items->Add(item);
     dir->SetLastAccess(m_accessCounter);
   }
+
+  ClearPersistent(strPath);
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
@@ -186,17 +283,57 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
     bInCache = true;
     CDir *dir = i->second;
     dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
     m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
+bool CDirectoryCache::GetStat(const std::string& strFile, struct __stat64* buffer)
+{
+  CSingleLock lock (m_cs);
+
+  // Get rid of any URL options, else the compare may be wrong
+  std::string strPath = CURL(strFile).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(strPath);
+  std::string storedPath = URIUtils::GetDirectory(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  ciCache i = m_cache.find(storedPath);
+  if (i == m_cache.end())
+  {
+    m_cacheMisses++;
+    return false;
+  }
+
+  CDir *dir = i->second;
+  dir->SetLastAccess(m_accessCounter);
+  m_cacheHits++;
+
+  // callers stat every entry of a listing, don't search it for each of them
+  dir->m_Items->SetFastLookup(true);
+  CFileItemPtr item = dir->m_Items->Get(strPath);
+  if (!item)
+  {
+    // folders are listed with a trailing slash
+    std::string folderPath = strPath;
+    URIUtils::AddSlashAtEnd(folderPath);
+    item = dir->m_Items->Get(folderPath);
+  }
+
+  int64_t mtime, ctime;
+  if (!item || !IDirectory::GetItemTimes(*item, mtime, ctime))
+    return false;
+
+  memset(buffer, 0, sizeof(struct __stat64));
+  buffer->st_mode = item->m_bIsFolder ? S_IFDIR : S_IFREG;
+  buffer->st_size = item->m_dwSize;
+  buffer->st_mtime = mtime;
+  buffer->st_ctime = ctime;
+  return true;
+}
+
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
@@ -205,6 +342,13 @@ void CDirectoryCache::Clear()
   iCache i = m_cache.begin();
   while (i != m_cache.end() )
     Delete(i++);
+
+  // only the copies in memory, the listings are read back from disk when needed again
+  auto it = m_persistent.begin();
+  while (it != m_persistent.end())
+    it = DeletePersistent(it);
+  m_persistentLoaded = false;
+  m_persistentDirty = false;
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -257,6 +401,280 @@ void CDirectoryCache::Delete(iCache it)
   m_cache.erase(it);
 }
 
+bool CDirectoryCache::GetPersistentDirectory(const std::string& strPath,
+                                             CFileItemList& items,
+                                             bool needFileInfo,
+                                             int64_t& mtime)
+{
+  mtime = 0;
+
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  CSingleLock lock(m_cs);
+
+  LoadPersistent();
+  ProcessChanges();
+
+  auto it = m_persistent.find(storedPath);
+  if (it != m_persistent.end() && (it->second.m_hasFileInfo || !needFileInfo))
+  {
+    if (it->second.m_watched)
+    {
+      items.Copy(*it->second.m_items);
+      it->second.m_lastAccess = m_accessCounter++;
+      m_persistentHits++;
+      if (it->second.m_hasFileInfo)
+      {
+        CSingleExit exit(m_cs);
+        RefreshFolderDates(items);
+      }
+      return true;
+    }
+
+    const std::shared_ptr<CFileItemList> cached = it->second.m_items;
+    const int64_t cachedTime = it->second.m_mtime;
+    {
+      // remote filesystems may take a while, don't hold up everyone else
+      CSingleExit exit(m_cs);
+      mtime = GetModificationTime(storedPath);
+    }
+
+    it = m_persistent.find(storedPath);
+    if (it != m_persistent.end() && it->second.m_items == cached)
+    {
+      if (mtime != 0 && mtime == cachedTime)
+      {
+        // unchanged since the last run, from now on rely on change notifications
+        if (m_watcher && IsWatchable(storedPath) && m_watcher->Watch(storedPath))
+        {
+          mtime = GetModificationTime(storedPath);
+          it->second.m_watched = mtime == cachedTime;
+          if (!it->second.m_watched)
+            m_watcher->Unwatch(storedPath);
+        }
+
+        if (mtime == cachedTime)
+        {
+          items.Copy(*cached);
+          it->second.m_lastAccess = m_accessCounter++;
+          m_persistentHits++;
+          return true;
+        }
+      }
+      DeletePersistent(it);
+    }
+  }
+  else
+  {
+    CSingleExit exit(m_cs);
+    mtime = GetModificationTime(storedPath);
+  }
+
+  m_persistentMisses++;
+  return false;
+}
+
+void CDirectoryCache::SetPersistentDirectory(const std::string& strPath,
+                                             const CFileItemList& items,
+                                             bool hasFileInfo,
+                                             int64_t mtime)
+{
+  // without a usable modification time the listing could never be validated
+  if (mtime == 0 || IsRecentlyModified(mtime))
+    return;
+
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  CSingleLock lock(m_cs);
+
+  LoadPersistent();
+  ClearPersistent(storedPath);
+  CheckIfPersistentFull();
+
+  CPersistentDir dir;
+  dir.m_items = std::make_shared<CFileItemList>();
+  dir.m_items->Copy(items);
+  dir.m_mtime = mtime;
+  dir.m_lastAccess = m_accessCounter++;
+
+  // mtime was taken before listing, a change since then means the listing may be stale
+  if (m_watcher && IsWatchable(storedPath) && m_watcher->Watch(storedPath))
+  {
+    if (GetModificationTime(storedPath) != mtime)
+    {
+      m_watcher->Unwatch(storedPath);
+      return;
+    }
+    dir.m_watched = true;
+  }
+
+  dir.m_hasFileInfo = hasFileInfo && dir.m_watched;
+  if (!dir.m_hasFileInfo)
+    ClearFileInfo(*dir.m_items);
+  ClearFolderTimes(*dir.m_items);
+
+  m_persistent.emplace(storedPath, std::move(dir));
+  m_persistentDirty = true;
+}
+
+void CDirectoryCache::SavePersistent()
+{
+  CSingleLock lock(m_cs);
+
+  if (!m_persistentDirty)
+    return;
+
+  CFile file;
+  if (!file.OpenForWrite(PERSISTENT_CACHE_FILE, true))
+  {
+    CLog::Log(LOGWARNING, "{} - unable to write {}", __FUNCTION__, PERSISTENT_CACHE_FILE);
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << PERSISTENT_CACHE_VERSION;
+  ar << static_cast<int>(m_persistent.size());
+  for (auto& it : m_persistent)
+  {
+    ar << it.first;
+    ar << it.second.m_mtime;
+    // watches don't survive a restart, the file info can't be validated then
+    if (it.second.m_hasFileInfo)
+    {
+      CFileItemList items;
+      items.Copy(*it.second.m_items);
+      ClearFileInfo(items);
+      ar << items;
+    }
+    else
+      ar << *it.second.m_items;
+  }
+  ar.Close();
+  file.Close();
+
+  m_persistentDirty = false;
+}
+
+CDirectoryCache::Stats CDirectoryCache::GetStats() const
+{
+  CSingleLock lock(m_cs);
+
+  Stats stats = {};
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+  stats.persistentHits = m_persistentHits;
+  stats.persistentMisses = m_persistentMisses;
+  stats.directories = m_cache.size();
+  stats.persistentDirectories = m_persistent.size();
+  for (const auto& it : m_persistent)
+  {
+    if (it.second.m_watched)
+      stats.watchedDirectories++;
+  }
+  return stats;
+}
+
+void CDirectoryCache::LoadPersistent()
+{
+  if (m_persistentLoaded)
+    return;
+
+  m_persistentLoaded = true;
+
+  CFile file;
+  if (!file.Open(PERSISTENT_CACHE_FILE))
+    return;
+
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    int version = 0;
+    ar >> version;
+    if (version == PERSISTENT_CACHE_VERSION)
+    {
+      int count = 0;
+      ar >> count;
+      for (int i = 0; i < count; i++)
+      {
+        std::string path;
+        CPersistentDir dir;
+        dir.m_items = std::make_shared<CFileItemList>();
+        ar >> path;
+        ar >> dir.m_mtime;
+        ar >> *dir.m_items;
+        dir.m_lastAccess = m_accessCounter++;
+        m_persistent.emplace(path, std::move(dir));
+      }
+    }
+    ar.Close();
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "{} - corrupt archive: {}", __FUNCTION__, PERSISTENT_CACHE_FILE);
+    m_persistent.clear();
+  }
+  file.Close();
+
+  CLog::Log(LOGDEBUG, "{} - loaded {} directories", __FUNCTION__, m_persistent.size());
+}
+
+void CDirectoryCache::ProcessChanges()
+{
+  if (!m_watcher)
+    return;
+
+  std::vector<std::string> changed;
+  if (!m_watcher->GetChanges(changed))
+  {
+    // changes were lost, nothing that relied on them can be trusted
+    auto it = m_persistent.begin();
+    while (it != m_persistent.end())
+    {
+      if (it->second.m_watched)
+        it = DeletePersistent(it);
+      else
+        ++it;
+    }
+  }
+
+  for (const std::string& path : changed)
+    ClearPersistent(path);
+}
+
+void CDirectoryCache::ClearPersistent(const std::string& storedPath)
+{
+  auto it = m_persistent.find(storedPath);
+  if (it != m_persistent.end())
+    DeletePersistent(it);
+}
+
+void CDirectoryCache::CheckIfPersistentFull()
+{
+  if (m_persistent.size() < MAX_PERSISTENT_DIRS)
+    return;
+
+  auto lastAccessed = m_persistent.begin();
+  for (auto it = m_persistent.begin(); it != m_persistent.end(); ++it)
+  {
+    if (it->second.m_lastAccess < lastAccessed->second.m_lastAccess)
+      lastAccessed = it;
+  }
+  DeletePersistent(lastAccessed);
+}
+
+std::map<std::string, CDirectoryCache::CPersistentDir>::iterator CDirectoryCache::DeletePersistent(
+    std::map<std::string, CPersistentDir>::iterator it)
+{
+  if (it->second.m_watched && m_watcher)
+    m_watcher->Unwatch(it->first);
+  m_persistentDirty = true;
+  return m_persistent.erase(it);
+}
+
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
@@ -11,13 +11,19 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
+#include "PlatformDefs.h"
+
 #include <map>
+#include <memory>
 #include <set>
+#include <stdint.h>
 
 class CFileItem;
 
 namespace XFILE
 {
+  class IDirectoryWatcher;
+
   class CDirectoryCache
   {
     class CDir
@@ -36,7 +42,28 @@ namespace XFILE
       CDir& operator=(const CDir&) = delete;
       unsigned int m_lastAccess;
     };
+
+    /*! Listing kept across runs, valid while the directory is unchanged */
+    struct CPersistentDir
+    {
+      std::shared_ptr<CFileItemList> m_items;
+      int64_t m_mtime = 0;
+      bool m_hasFileInfo = false; // only while watched since listing
+      bool m_watched = false;
+      unsigned int m_lastAccess = 0;
+    };
   public:
+    struct Stats
+    {
+      unsigned int hits;
+      unsigned int misses;
+      unsigned int persistentHits;
+      unsigned int persistentMisses;
+      unsigned int directories;
+      unsigned int persistentDirectories;
+      unsigned int watchedDirectories;
+    };
+
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
@@ -47,6 +74,40 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+
+    /*!
+     \brief Stat a file from the cached listing of its directory
+     \return false if the directory isn't cached or its listing didn't carry the times
+     \sa IDirectory::GetItemTimes
+     */
+    bool GetStat(const std::string& strFile, struct __stat64* buffer);
+
+    /*!
+     \brief Get a listing kept across runs if the directory didn't change since
+
+     Watched local directories are trusted until a change is reported, all
+     others are validated against the modification time of the directory.
+     That doesn't change when a file is rewritten in place, so only watched
+     directories keep size and date of their entries. Changes inside
+     subfolders go unnoticed either way, their times aren't kept and their
+     dates are read again.
+     \param needFileInfo the listing must include size and date of the entries
+     \param mtime on a miss, modification time to pass on to SetPersistentDirectory()
+     */
+    bool GetPersistentDirectory(const std::string& strPath,
+                                CFileItemList& items,
+                                bool needFileInfo,
+                                int64_t& mtime);
+    void SetPersistentDirectory(const std::string& strPath,
+                                const CFileItemList& items,
+                                bool hasFileInfo,
+                                int64_t mtime);
+    /*!
+     \brief Write the persistent listings to disk if they changed
+     */
+    void SavePersistent();
+
+    Stats GetStats() const;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -60,14 +121,26 @@ namespace XFILE
     typedef std::map<std::string, CDir*>::const_iterator ciCache;
     void Delete(iCache i);
 
+    void LoadPersistent();
+    void ProcessChanges();
+    void ClearPersistent(const std::string& storedPath);
+    void CheckIfPersistentFull();
+    std::map<std::string, CPersistentDir>::iterator DeletePersistent(
+        std::map<std::string, CPersistentDir>::iterator it);
+
+    std::map<std::string, CPersistentDir> m_persistent;
+    std::unique_ptr<IDirectoryWatcher> m_watcher;
+    bool m_persistentLoaded = false;
+    bool m_persistentDirty = false;
+
     mutable CCriticalSection m_cs;
 
     unsigned int m_accessCounter;
 
-#ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
-#endif
+    unsigned int m_persistentHits = 0;
+    unsigned int m_persistentMisses = 0;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
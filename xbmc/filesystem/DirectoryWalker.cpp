@@ -0,0 +1,257 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryWalker.h"
+
+#include "Directory.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "Util.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+
+CDirectoryWalker::CDirectoryWalker(const std::string& mask,
+                                   int flags,
+                                   const std::vector<std::string>& excludes,
+                                   bool recursive,
+                                   unsigned int workers,
+                                   unsigned int hostConnections,
+                                   unsigned int maxPending /* = 256 */)
+  : m_mask(mask),
+    m_flags(flags),
+    m_excludes(excludes),
+    m_recursive(recursive),
+    m_hostConnections(std::max(1u, hostConnections)),
+    m_maxPending(std::max(1u, maxPending)),
+    m_queues(std::max(1u, workers))
+{
+}
+
+CDirectoryWalker::~CDirectoryWalker()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_stop = true;
+    m_workAvailable.notifyAll();
+  }
+
+  for (auto& worker : m_workers)
+    worker->StopThread();
+}
+
+void CDirectoryWalker::Walk(const std::string& path)
+{
+  CSingleLock lock(m_critSection);
+
+  if (m_workers.empty())
+  {
+    for (size_t i = 0; i < m_queues.size(); i++)
+    {
+      m_workers.emplace_back(new CThread(this, "DirectoryWalker"));
+      m_workers.back()->Create();
+    }
+  }
+
+  m_walked.insert(path);
+  m_queues[0].push_back(path);
+  m_workAvailable.notifyAll();
+}
+
+bool CDirectoryWalker::GetDirectory(const std::string& path, CFileItemList& items)
+{
+  CSingleLock lock(m_critSection);
+
+  while (true)
+  {
+    auto it = m_ready.find(path);
+    if (it != m_ready.end())
+    {
+      items.Copy(*it->second.items, false);
+      items.Append(*it->second.items);
+      const bool result = it->second.result;
+      m_ready.erase(it);
+      m_workAvailable.notifyAll();
+      return result;
+    }
+
+    if (m_listing.find(path) == m_listing.end())
+      break;
+
+    m_listingDone.wait(lock);
+  }
+
+  // not reached yet, the scanner would only wait for it
+  for (auto& queue : m_queues)
+    queue.erase(std::remove(queue.begin(), queue.end(), path), queue.end());
+
+  bool result;
+  {
+    CSingleExit exit(m_critSection);
+    result = CDirectory::GetDirectory(path, items, m_mask, m_flags);
+  }
+
+  // subfolders of folders outside the walked trees may never be scanned
+  if (m_recursive && IsWalked(path))
+  {
+    Queue(0, items);
+    m_workAvailable.notifyAll();
+  }
+  return result;
+}
+
+void CDirectoryWalker::Finished(const std::string& path)
+{
+  CSingleLock lock(m_critSection);
+
+  auto walked = m_walked.begin();
+  while (walked != m_walked.end())
+  {
+    if (URIUtils::PathHasParent(*walked, path))
+      walked = m_walked.erase(walked);
+    else
+      ++walked;
+  }
+
+  auto it = m_ready.begin();
+  while (it != m_ready.end())
+  {
+    if (URIUtils::PathHasParent(it->first, path))
+      it = m_ready.erase(it);
+    else
+      ++it;
+  }
+
+  for (auto& queue : m_queues)
+  {
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+                               [&path](const std::string& queued) {
+                                 return URIUtils::PathHasParent(queued, path);
+                               }),
+                queue.end());
+  }
+
+  for (const std::string& listing : m_listing)
+  {
+    if (URIUtils::PathHasParent(listing, path))
+      m_cancelled.insert(listing);
+  }
+
+  m_workAvailable.notifyAll();
+}
+
+void CDirectoryWalker::Run()
+{
+  const size_t self = m_nextWorker++ % m_queues.size();
+
+  CSingleLock lock(m_critSection);
+  while (!m_stop)
+  {
+    std::string path;
+    if (m_ready.size() + m_listing.size() >= m_maxPending || !Take(self, path))
+    {
+      m_workAvailable.wait(lock);
+      continue;
+    }
+
+    const std::string host = GetHost(path);
+    m_listing.insert(path);
+    m_hostBusy[host]++;
+
+    Listing listing;
+    listing.items.reset(new CFileItemList);
+    {
+      CSingleExit exit(m_critSection);
+      listing.result = CDirectory::GetDirectory(path, *listing.items, m_mask, m_flags);
+    }
+
+    if (--m_hostBusy[host] == 0)
+      m_hostBusy.erase(host);
+    m_listing.erase(path);
+
+    if (m_cancelled.erase(path) == 0)
+    {
+      if (m_recursive)
+        Queue(self, *listing.items);
+      m_ready.emplace(path, std::move(listing));
+    }
+
+    m_listingDone.notifyAll();
+    m_workAvailable.notifyAll();
+  }
+}
+
+/*!
+ Own work is taken depth first from the front, work of others from the back
+ where the folders closest to the root are.
+ */
+bool CDirectoryWalker::Take(size_t worker, std::string& path)
+{
+  std::deque<std::string>& own = m_queues[worker];
+  for (auto it = own.begin(); it != own.end(); ++it)
+  {
+    if (HasFreeConnection(*it))
+    {
+      path = *it;
+      own.erase(it);
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < m_queues.size(); i++)
+  {
+    std::deque<std::string>& other = m_queues[(worker + i) % m_queues.size()];
+    for (auto it = other.rbegin(); it != other.rend(); ++it)
+    {
+      if (HasFreeConnection(*it))
+      {
+        path = *it;
+        other.erase(std::next(it).base());
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void CDirectoryWalker::Queue(size_t worker, const CFileItemList& items)
+{
+  // same folders the scanners recurse into, in the order they do
+  std::deque<std::string>& queue = m_queues[worker];
+  for (int i = items.Size() - 1; i >= 0; --i)
+  {
+    const CFileItemPtr item = items[i];
+    if (item->m_bIsFolder && !item->IsParentFolder() && !item->IsPlayList() &&
+        !CUtil::ExcludeFileOrFolder(item->GetPath(), m_excludes))
+      queue.push_front(item->GetPath());
+  }
+}
+
+bool CDirectoryWalker::IsWalked(const std::string& path) const
+{
+  return std::any_of(m_walked.begin(), m_walked.end(), [&path](const std::string& walked) {
+    return URIUtils::PathHasParent(path, walked);
+  });
+}
+
+bool CDirectoryWalker::HasFreeConnection(const std::string& path) const
+{
+  const auto it = m_hostBusy.find(GetHost(path));
+  return it == m_hostBusy.end() || it->second < m_hostConnections;
+}
+
+std::string CDirectoryWalker::GetHost(const std::string& path)
+{
+  const CURL url(path);
+  return url.GetProtocol() + "://" + url.GetHostName();
+}
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class CFileItemList;
+class CThread;
+
+namespace XFILE
+{
+
+/*!
+ \brief Lists the folders of a tree ahead of a library scanner
+
+ A small pool of workers lists the paths given to Walk() while the scanner is
+ busy with the folders it already got, so the scan no longer waits for one
+ listing round-trip after the other. A recursive walker also lists the tree
+ below them, for scanners that descend into every folder. Each worker walks
+ its own part depth first and takes the shallowest folder queued by another
+ worker once it runs out, which keeps the listings close to the order the
+ scanner asks for them in.
+
+ The walker never runs more than maxPending listings ahead of the scanner and
+ never has more than hostConnections listings running against one host.
+ */
+class CDirectoryWalker : private IRunnable
+{
+public:
+  /*!
+   \param mask file mask passed on to CDirectory::GetDirectory()
+   \param flags directory flags passed on to CDirectory::GetDirectory()
+   \param excludes regular expressions of folders not to descend into
+   \param recursive list the tree below the walked paths as well, otherwise
+   the scanner walks every folder it is going to list itself
+   */
+  CDirectoryWalker(const std::string& mask,
+                   int flags,
+                   const std::vector<std::string>& excludes,
+                   bool recursive,
+                   unsigned int workers,
+                   unsigned int hostConnections,
+                   unsigned int maxPending = 256);
+  ~CDirectoryWalker() override;
+
+  /*!
+   \brief Start listing the path, and the tree below it if recursive
+   */
+  void Walk(const std::string& path);
+
+  /*!
+   \brief Get the listing of a folder
+
+   Waits if the folder is being listed and lists it right away if the walker
+   didn't get to it yet.
+   \return the result of CDirectory::GetDirectory()
+   */
+  bool GetDirectory(const std::string& path, CFileItemList& items);
+
+  /*!
+   \brief The scanner is done with the tree below the path
+
+   Listings of it that weren't asked for, e.g. of skipped folders, are dropped.
+   */
+  void Finished(const std::string& path);
+
+private:
+  struct Listing
+  {
+    bool result;
+    std::unique_ptr<CFileItemList> items;
+  };
+
+  void Run() override;
+  bool Take(size_t worker, std::string& path);
+  void Queue(size_t worker, const CFileItemList& items);
+  bool IsWalked(const std::string& path) const;
+  bool HasFreeConnection(const std::string& path) const;
+  static std::string GetHost(const std::string& path);
+
+  const std::string m_mask;
+  const int m_flags;
+  const std::vector<std::string> m_excludes;
+  const bool m_recursive;
+  const unsigned int m_hostConnections;
+  const unsigned int m_maxPending;
+
+  std::vector<std::deque<std::string>> m_queues; // one per worker
+  std::set<std::string> m_walked; // paths given to Walk() the scanner isn't done with
+  std::map<std::string, Listing> m_ready;
+  std::set<std::string> m_listing;
+  std::set<std::string> m_cancelled;
+  std::map<std::string, unsigned int> m_hostBusy;
+  std::vector<std::unique_ptr<CThread>> m_workers;
+  std::atomic<size_t> m_nextWorker{0};
+  bool m_stop = false;
+  XbmcThreads::ConditionVariable m_workAvailable;
+  XbmcThreads::ConditionVariable m_listingDone;
+  CCriticalSection m_critSection;
+};
+
+} // namespace XFILE
@@ -97,6 +97,16 @@ CURLMcode DllLibCurl::multi_cleanup(CURLM* handle)
   return curl_multi_cleanup(handle);
 }
 
+CURLSH* DllLibCurl::share_init()
+{
+  return curl_share_init();
+}
+
+CURLSHcode DllLibCurl::share_cleanup(CURLSH* share)
+{
+  return curl_share_cleanup(share);
+}
+
 curl_slist* DllLibCurl::slist_append(curl_slist* list, const char* to_append)
 {
   return curl_slist_append(list, to_append);
@@ -118,15 +128,45 @@ DllLibCurlGlobal::DllLibCurlGlobal()
   if (curl_global_init(CURL_GLOBAL_ALL))
   {
     CLog::Log(LOGERROR, "Error initializing libcurl");
+    return;
+  }
+
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, LockShare);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+    share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // the connection cache isn't shared, libcurl doesn't support using a shared one from
+    // multi handles running concurrently in different threads
   }
 }
 
 DllLibCurlGlobal::~DllLibCurlGlobal()
 {
+  // handles still open at exit keep the share in use, it goes away with the process then
+  if (m_share && share_cleanup(m_share) == CURLSHE_OK)
+    m_share = nullptr;
+
   // close libcurl
   curl_global_cleanup();
 }
 
+void DllLibCurlGlobal::LockShare(CURL_HANDLE* handle,
+                                 curl_lock_data data,
+                                 curl_lock_access access,
+                                 void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].lock();
+}
+
+void DllLibCurlGlobal::UnlockShare(CURL_HANDLE* handle, curl_lock_data data, void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].unlock();
+}
+
 void DllLibCurlGlobal::CheckIdle()
 {
   CSingleLock lock(m_critSection);
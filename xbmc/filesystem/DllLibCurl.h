@@ -57,6 +57,13 @@ public:
   CURLMcode multi_timeout(CURLM* multi_handle, long* timeout);
   CURLMsg* multi_info_read(CURLM* multi_handle, int* msgs_in_queue);
   CURLMcode multi_cleanup(CURLM* handle);
+  CURLSH* share_init();
+  template<typename... Args>
+  CURLSHcode share_setopt(CURLSH* share, CURLSHoption option, Args... args)
+  {
+    return curl_share_setopt(share, option, std::forward<Args>(args)...);
+  }
+  CURLSHcode share_cleanup(CURLSH* share);
   curl_slist* slist_append(curl_slist* list, const char* to_append);
   void slist_free_all(curl_slist* list);
   const char* easy_strerror(CURLcode code);
@@ -77,6 +84,14 @@ public:
   CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle) override;
   void CheckIdle();
 
+  /*!
+   \brief Share handle all easy handles should use
+
+   Shares the DNS cache and TLS sessions between all transfers, so concurrent
+   requests to a host skip the lookup and resume the handshake of any of them.
+   */
+  CURLSH* GetShare() const { return m_share; }
+
   /* overloaded load and unload with reference counter */
 
   /* structure holding a session info */
@@ -95,6 +110,13 @@ public:
 
   VEC_CURLSESSIONS m_sessions;
   CCriticalSection m_critSection;
+
+private:
+  static void LockShare(CURL_HANDLE* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+  static void UnlockShare(CURL_HANDLE* handle, curl_lock_data data, void* userptr);
+
+  CURLSH* m_share = nullptr;
+  CCriticalSection m_shareLocks[CURL_LOCK_DATA_LAST];
 };
 } // namespace XCURL
 
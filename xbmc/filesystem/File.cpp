@@ -29,6 +29,9 @@
 
 #include "system.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace XFILE;
 
 //////////////////////////////////////////////////////////////////////
@@ -505,18 +508,23 @@ int CFile::Stat(struct __stat64 *buffer)
   return m_pFile->Stat(buffer);
 }
 
-int CFile::Stat(const std::string& strFileName, struct __stat64* buffer)
+int CFile::Stat(const std::string& strFileName,
+                struct __stat64* buffer,
+                bool bUseCache /* = false */)
 {
   const CURL pathToUrl(strFileName);
-  return Stat(pathToUrl, buffer);
+  return Stat(pathToUrl, buffer, bUseCache);
 }
 
-int CFile::Stat(const CURL& file, struct __stat64* buffer)
+int CFile::Stat(const CURL& file, struct __stat64* buffer, bool bUseCache /* = false */)
 {
   if (!buffer)
     return -1;
 
   CURL url(URIUtils::SubstitutePath(file));
+  if (bUseCache && g_directoryCache.GetStat(url.Get(), buffer))
+    return 0;
+
   CURL authUrl = url;
   if (CPasswordManager::GetInstance().IsURLSupported(authUrl) && authUrl.GetUserName().empty())
     CPasswordManager::GetInstance().AuthenticateURL(authUrl);
@@ -977,6 +985,7 @@ ssize_t CFile::LoadFile(const CURL& file, auto_buffer& outputBuffer)
   static const size_t max_file_size = 0x7FFFFFFF;
   static const size_t min_chunk_size = 64 * 1024U;
   static const size_t max_chunk_size = 2048 * 1024U;
+  static const size_t batch_chunk_size = 256 * 1024U;
 
   outputBuffer.clear();
 
@@ -1009,6 +1018,42 @@ ssize_t CFile::LoadFile(const CURL& file, auto_buffer& outputBuffer)
                                     : static_cast<size_t>(DetermineChunkSize(GetChunkSize(),
                                                                              min_chunk_size));
   size_t total_read = 0;
+
+  // Where supported, files of known size are first read with several requests
+  // in flight, anything missing after that is picked up by the loop below.
+  if (filesize > static_cast<int64_t>(2 * batch_chunk_size))
+  {
+    outputBuffer.resize(chunksize);
+    if (chunksize < max_chunk_size)
+      chunksize *= 2;
+
+    std::vector<SReadRequest> requests;
+    for (int64_t pos = 0; pos < filesize; pos += batch_chunk_size)
+    {
+      const size_t size = static_cast<size_t>(std::min<int64_t>(batch_chunk_size, filesize - pos));
+      requests.push_back({pos, outputBuffer.get() + pos, size, 0});
+    }
+
+    SReadBatch batch = {requests.data(), requests.size()};
+    if (IoControl(IOCTRL_READ_BATCH, &batch) == 0)
+    {
+      for (const auto& request : requests)
+      {
+        if (request.result <= 0)
+          break;
+        total_read += static_cast<size_t>(request.result);
+        if (static_cast<size_t>(request.result) < request.size)
+          break;
+      }
+
+      if (Seek(total_read, SEEK_SET) != static_cast<int64_t>(total_read))
+      {
+        outputBuffer.clear();
+        return -1;
+      }
+    }
+  }
+
   while (true)
   {
     if (total_read == outputBuffer.size())
@@ -12,11 +12,18 @@
 #include "URL.h"
 #include "ServiceBroker.h"
 
+#include "BlockCache.h"
 #include "CircularCache.h"
+#include "ParallelFetchCache.h"
+#include "ReadAheadController.h"
+#include "SparseCache.h"
+#include "cores/DataCacheCore.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/URIUtils.h"
 
 #if !defined(TARGET_WINDOWS)
 #include "platform/posix/ConvUtils.h"
@@ -26,6 +33,7 @@
 #include <cassert>
 #include <chrono>
 #include <inttypes.h>
+#include <map>
 #include <memory>
 
 #ifdef TARGET_POSIX
@@ -79,6 +87,191 @@ private:
   int64_t  m_size;
 };
 
+namespace
+{
+/*!
+ Range readers of all caches per host. Together with its source, a cache
+ keeps within <curlmaxhostconnections> connections to a host, other
+ transfers aren't limited.
+ */
+CCriticalSection hostReadersSection;
+std::map<std::string, unsigned int> hostReaders;
+
+unsigned int ReserveHostReaders(const std::string& host, unsigned int wanted, unsigned int max)
+{
+  CSingleLock lock(hostReadersSection);
+  unsigned int& used = hostReaders[host];
+  const unsigned int readers = std::min(wanted, max > used ? max - used : 0);
+  used += readers;
+  if (used == 0)
+    hostReaders.erase(host);
+  return readers;
+}
+
+void ReleaseHostReaders(const std::string& host, unsigned int readers)
+{
+  CSingleLock lock(hostReadersSection);
+  auto it = hostReaders.find(host);
+  if (it == hostReaders.end())
+    return;
+
+  it->second -= std::min(readers, it->second);
+  if (it->second == 0)
+    hostReaders.erase(it);
+}
+} // namespace
+
+namespace XFILE
+{
+
+/*!
+ \brief Worker fetching segments of the source on its own connection
+
+ Each reader opens the source separately and serves one segment request at a
+ time. Positioning is done per segment, which maps to a ranged request for
+ http(s) and to a positioned read for nfs/smb.
+ */
+class CCacheRangeReader : public CThread
+{
+public:
+  struct Segment
+  {
+    int64_t pos = 0;
+    size_t size = 0;
+    unsigned int generation = 0;
+    std::vector<char> data;
+  };
+
+  CCacheRangeReader(const CURL& url, CEvent& done)
+    : CThread("FileCacheReader"), m_url(url), m_done(done)
+  {
+  }
+
+  ~CCacheRangeReader() override { StopThread(); }
+
+  bool IsIdle()
+  {
+    CSingleLock lock(m_sync);
+    return !m_busy && !m_ready && !m_failed;
+  }
+
+  bool IsFailed() const { return m_failed; }
+
+  unsigned GetRate() const { return m_rate; }
+
+  void Fetch(int64_t pos, size_t size, unsigned int generation)
+  {
+    CSingleLock lock(m_sync);
+    m_segment.pos = pos;
+    m_segment.size = size;
+    m_segment.generation = generation;
+    m_busy = true;
+    m_request.Set();
+  }
+
+  bool TakeResult(Segment& segment)
+  {
+    CSingleLock lock(m_sync);
+    if (!m_ready)
+      return false;
+
+    segment = std::move(m_segment);
+    m_segment = Segment();
+    m_ready = false;
+    return true;
+  }
+
+protected:
+  void Process() override
+  {
+    if (!m_file.Open(m_url, READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED))
+    {
+      CLog::Log(LOGERROR, "CCacheRangeReader::{} - <{}> failed to open", __FUNCTION__,
+                m_url.GetRedacted());
+      m_failed = true;
+      m_done.Set();
+      return;
+    }
+
+    bool retry = false;
+    m_file.IoControl(IOCTRL_SET_RETRY, &retry); // CFileCache refetches failed segments itself
+
+    unsigned int failures = 0;
+    while (!m_bStop)
+    {
+      if (AbortableWait(m_request) != WAIT_SIGNALED)
+        break;
+
+      int64_t pos;
+      size_t size;
+      {
+        CSingleLock lock(m_sync);
+        pos = m_segment.pos;
+        size = m_segment.size;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      std::vector<char> data(size);
+      size_t total = 0;
+      if (m_file.Seek(pos, SEEK_SET) == pos)
+      {
+        while (!m_bStop && total < size)
+        {
+          const ssize_t iRead = m_file.Read(data.data() + total, size - total);
+          if (iRead <= 0)
+            break;
+          total += iRead;
+        }
+      }
+      data.resize(total);
+
+      const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+      if (total > 0)
+      {
+        // smooth over the last few segments, a single segment is too noisy
+        const unsigned rate = static_cast<unsigned>(1000 * total / std::max<int64_t>(elapsed, 1));
+        m_rate = m_rate == 0 ? rate : (m_rate * 3 + rate) / 4;
+        failures = 0;
+      }
+      else if (++failures >= 3)
+      {
+        CLog::Log(LOGWARNING, "CCacheRangeReader::{} - <{}> giving up after {} failed reads",
+                  __FUNCTION__, m_url.GetRedacted(), failures);
+        m_failed = true;
+      }
+
+      {
+        CSingleLock lock(m_sync);
+        m_segment.data = std::move(data);
+        m_busy = false;
+        m_ready = true;
+      }
+      m_done.Set();
+
+      if (m_failed)
+        break;
+    }
+
+    m_file.Close();
+  }
+
+private:
+  const CURL m_url;
+  CEvent& m_done;
+  CFile m_file;
+  CEvent m_request;
+  CCriticalSection m_sync;
+  Segment m_segment;
+  bool m_busy = false;
+  bool m_ready = false;
+  std::atomic<bool> m_failed{false};
+  std::atomic<unsigned> m_rate{0};
+};
+
+} // namespace XFILE
+
 
 CFileCache::CFileCache(const unsigned int flags)
   : CThread("FileCache")
@@ -144,6 +337,46 @@ bool CFileCache::Open(const CURL& url)
 
   m_fileSize = m_source.GetLength();
 
+  const std::shared_ptr<CAdvancedSettings> advancedSettings =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+
+  // Fill from several connections only if the source can serve ranges and is large enough
+  // to keep them all busy
+  unsigned int readers = advancedSettings->m_cacheParallelReaders;
+  if (URIUtils::IsInternetStream(url, true) && advancedSettings->m_curlMaxHostConnections > 0)
+  {
+    // the source keeps one connection, readers of other caches to the host count as well
+    m_readersHost = url.GetHostName();
+    readers = ReserveHostReaders(
+        m_readersHost, readers,
+        static_cast<unsigned int>(advancedSettings->m_curlMaxHostConnections - 1));
+    m_hostReaders = readers;
+  }
+  m_segmentSize = std::max(advancedSettings->m_cacheParallelSegmentSize, m_chunkSize);
+  const bool parallel = readers > 1 && m_seekPossible > 0 &&
+                        m_fileSize > static_cast<int64_t>(readers) * m_segmentSize;
+
+  // Local sources are read with several requests in flight, as far as the cache can take them
+  SReadBatch probe = {nullptr, 0};
+  m_readBatch = 1;
+  if (!parallel && advancedSettings->m_cacheReadQueueDepth > 1 &&
+      m_source.IoControl(IOCTRL_READ_BATCH, &probe) == 0)
+    m_readBatch = advancedSettings->m_cacheReadQueueDepth;
+
+  // Blocks of network sources may be kept on disk for the next time the file is opened
+  m_blockCache.reset();
+  m_bSourceBehind = false;
+  if (advancedSettings->m_cachePersistentSize > 0 && !URIUtils::IsHD(url.Get()))
+  {
+    struct __stat64 st;
+    if (m_source.Stat(&st) == 0 && st.st_mtime != 0)
+      m_blockCache = CBlockCache::GetInstance().Open(url, m_fileSize, st.st_mtime);
+  }
+
+  // A seekable source allows keeping several cached ranges around, which also serves
+  // READ_MULTI_STREAM without double buffering
+  const bool sparse = m_seekPossible > 0 && advancedSettings->m_cacheMemSize != 0;
+
   if (!m_pCache)
   {
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
@@ -170,7 +403,7 @@ bool CFileCache::Open(const CURL& url)
         cacheSize = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize;
 
         // NOTE: READ_MULTI_STREAM is only used with READ_AUDIO_VIDEO
-        if (m_flags & READ_MULTI_STREAM)
+        if ((m_flags & READ_MULTI_STREAM) && !sparse)
         {
           // READ_MULTI_STREAM requires double buffering, so use half the amount of memory for each buffer
           cacheSize /= 2;
@@ -181,7 +414,10 @@ bool CFileCache::Open(const CURL& url)
           cacheSize = m_chunkSize * 2;
       }
 
-      if (m_flags & READ_MULTI_STREAM)
+      if (sparse)
+        CLog::Log(LOGDEBUG, "CFileCache::{} - <{}> using sparse memory cache sized {} bytes",
+                  __FUNCTION__, m_sourcePath, cacheSize);
+      else if (m_flags & READ_MULTI_STREAM)
         CLog::Log(LOGDEBUG, "CFileCache::{} - <{}> using double memory cache each sized {} bytes",
                   __FUNCTION__, m_sourcePath, cacheSize);
       else
@@ -191,15 +427,25 @@ bool CFileCache::Open(const CURL& url)
       const size_t back = cacheSize / 4;
       const size_t front = cacheSize - back;
 
-      m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
+      if (sparse)
+        m_pCache = std::make_unique<CSparseCache>(front, back);
+      else
+        m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    if ((m_flags & READ_MULTI_STREAM) && !sparse)
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = std::unique_ptr<CDoubleCache>(new CDoubleCache(m_pCache.release())); // C++14 - Replace with std::make_unique
     }
+
+    if (parallel)
+    {
+      // Segments from the range readers arrive out of order and need reassembling
+      m_pParallelCache = new CParallelFetchCache(m_pCache.release());
+      m_pCache.reset(m_pParallelCache);
+    }
   }
 
   // open cache strategy
@@ -214,11 +460,43 @@ bool CFileCache::Open(const CURL& url)
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
+
+  m_readAhead.reset();
+  if (advancedSettings->m_cacheAdaptiveReadAhead)
+  {
+    // larger chunks are only used for single reads, batches are as large already
+    unsigned int maxChunkSize = m_readBatch > 1 ? m_chunkSize : m_chunkSize * 8;
+    if (m_forwardCacheSize > 0)
+      maxChunkSize = std::min<int64_t>(maxChunkSize, m_forwardCacheSize / 4);
+    m_readAhead = std::make_unique<CReadAheadController>(
+        m_chunkSize, maxChunkSize, m_forwardCacheSize, advancedSettings->m_cacheReadFactor);
+  }
   m_bFilling = true;
   m_bLowSpeedDetected = false;
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
+  m_bParallel = parallel && m_pParallelCache;
+  if (m_hostReaders > 0 && !m_bParallel)
+  {
+    ReleaseHostReaders(m_readersHost, m_hostReaders);
+    m_hostReaders = 0;
+  }
+
+  if (m_bParallel)
+  {
+    CLog::Log(LOGDEBUG,
+              "CFileCache::{} - <{}> filling cache from {} connections using {} byte segments",
+              __FUNCTION__, m_sourcePath, readers, m_segmentSize);
+
+    CSingleLock lock(m_readersSection);
+    for (unsigned int i = 0; i < readers; i++)
+      m_readers.emplace_back(new CCacheRangeReader(url, m_segmentDone));
+    for (auto& reader : m_readers)
+      reader->Create();
+    RestartFetch(0);
+  }
+
   CThread::Create(false);
 
   return true;
@@ -234,7 +512,10 @@ void CFileCache::Process()
   }
 
   // create our read buffer
-  std::unique_ptr<char[]> buffer(new char[m_chunkSize]);
+  const size_t batchSize = static_cast<size_t>(m_chunkSize) * m_readBatch;
+  const size_t bufferSize =
+      m_readAhead ? std::max<size_t>(batchSize, m_readAhead->GetMaxChunkSize()) : batchSize;
+  std::unique_ptr<char[]> buffer(new char[bufferSize]);
   if (buffer == nullptr)
   {
     CLog::Log(LOGERROR, "CFileCache::{} - <{}> failed to allocate read buffer", __FUNCTION__,
@@ -257,8 +538,16 @@ void CFileCache::Process()
       int64_t cacheMaxPos = m_pCache->CachedDataEndPosIfSeekTo(m_seekPos);
       const bool cacheReachEOF = (cacheMaxPos == m_fileSize);
       bool sourceSeekFailed = false;
-      if (!cacheReachEOF)
+      if (!cacheReachEOF && !m_bParallel && m_blockCache &&
+          m_blockCache->GetCachedSize(cacheMaxPos, 1) > 0)
+      {
+        // continue from the block cache, the source is moved once it's needed again
+        m_nSeekResult = cacheMaxPos;
+        m_bSourceBehind = true;
+      }
+      else if (!cacheReachEOF && !m_bParallel)
       {
+        m_bSourceBehind = false;
         m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
         if (m_nSeekResult != cacheMaxPos)
         {
@@ -272,11 +561,15 @@ void CFileCache::Process()
       {
         const bool bCompleteReset = m_pCache->Reset(m_seekPos, false);
         m_readPos = m_seekPos;
+        if (m_readAhead)
+          m_readAhead->Reset(m_readPos);
         m_writePos = m_pCache->CachedDataEndPos();
         assert(m_writePos == cacheMaxPos);
         average.Reset(m_writePos, bCompleteReset); // Can only recalculate new average from scratch after a full reset (empty cache)
         limiter.Reset(m_writePos);
         m_nSeekResult = m_seekPos;
+        if (m_bParallel)
+          RestartFetch(m_writePos);
         if (bCompleteReset)
         {
           CLog::Log(LOGDEBUG,
@@ -290,15 +583,27 @@ void CFileCache::Process()
       m_seekEnded.Set();
     }
 
-    while (m_writeRate)
+    // Fill at full speed up to the read-ahead, beyond that limit the fill rate
+    int64_t readAhead =
+        m_writeRate *
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheReadFactor;
+    int64_t throttleRate = readAhead;
+    if (m_readAhead)
     {
-      if (m_writePos - m_readPos < m_writeRate * CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheReadFactor)
+      m_readAhead->SetDeclaredRate(m_writeRate);
+      readAhead = m_readAhead->GetReadAhead();
+      throttleRate = m_readAhead->GetThrottleRate();
+    }
+
+    while (m_writeRate && throttleRate > 0)
+    {
+      if (m_writePos - m_readPos < readAhead)
       {
         limiter.Reset(m_writePos);
         break;
       }
 
-      if (limiter.Rate(m_writePos) < m_writeRate * CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheReadFactor)
+      if (limiter.Rate(m_writePos) < throttleRate)
         break;
 
       if (m_seekEvent.WaitMSec(100))
@@ -309,8 +614,42 @@ void CFileCache::Process()
       }
     }
 
-    const int64_t maxWrite = m_pCache->GetMaxWriteSize(m_chunkSize);
-    int64_t maxSourceRead = m_chunkSize;
+    if (m_bParallel)
+    {
+      if (!FetchFromReaders())
+      {
+        CLog::Log(LOGERROR, "CFileCache::{} - <{}> error writing to cache", __FUNCTION__,
+                  m_sourcePath);
+        m_bStop = true;
+        break;
+      }
+
+      if (m_bParallel && m_writePos >= m_fileSize)
+      {
+        CLog::Log(LOGDEBUG, "CFileCache::{} - <{}> range readers hit eof", __FUNCTION__,
+                  m_sourcePath);
+        m_pCache->EndOfInput();
+
+        if (AbortableWait(m_seekEvent) == WAIT_SIGNALED)
+        {
+          m_pCache->ClearEndOfInput();
+          if (!m_bStop)
+            m_seekEvent.Set(); // hack so that later we realize seek is needed
+        }
+        else
+          break; // while (!m_bStop)
+      }
+
+      UpdateFillState(average);
+      continue;
+    }
+
+    size_t readSize = batchSize;
+    if (m_readAhead && m_readBatch == 1)
+      readSize = m_readAhead->GetChunkSize();
+
+    const int64_t maxWrite = m_pCache->GetMaxWriteSize(readSize);
+    int64_t maxSourceRead = readSize;
     // Cap source read size by space available between current write position and EOF
     if (m_fileSize != 0)
       maxSourceRead = std::min(maxSourceRead, m_fileSize - m_writePos);
@@ -318,16 +657,42 @@ void CFileCache::Process()
     /* Only read from source if there's enough write space in the cache
      * else we may keep disposing data and seeking back on (slow) source
      */
-    if (maxWrite < maxSourceRead)
+    if (maxWrite < std::min<int64_t>(maxSourceRead, m_chunkSize))
     {
       // Wait until sufficient cache write space is available
       m_pCache->m_space.WaitMSec(5);
       continue;
     }
+    // batched reads fill as many chunks as there's space for
+    maxSourceRead = std::min(maxSourceRead, maxWrite);
 
     ssize_t iRead = 0;
-    if (maxSourceRead > 0)
-      iRead = m_source.Read(buffer.get(), maxSourceRead);
+    if (maxSourceRead > 0 && m_blockCache)
+      iRead = m_blockCache->Read(m_writePos, buffer.get(), maxSourceRead);
+    if (iRead > 0)
+      m_bSourceBehind = true;
+    else if (maxSourceRead > 0 && m_readBatch > 1)
+    {
+      iRead = ReadSourceBatch(buffer.get(), maxSourceRead);
+      if (iRead > 0 && m_blockCache)
+        m_blockCache->Write(m_writePos, buffer.get(), iRead);
+    }
+    else if (maxSourceRead > 0)
+    {
+      if (m_bSourceBehind && m_source.Seek(m_writePos, SEEK_SET) != m_writePos)
+      {
+        CLog::Log(LOGERROR, "CFileCache::{} - <{}> error {} seeking source to {}", __FUNCTION__,
+                  m_sourcePath, GetLastError(), m_writePos);
+        iRead = -1;
+      }
+      else
+      {
+        m_bSourceBehind = false;
+        iRead = m_source.Read(buffer.get(), maxSourceRead);
+        if (iRead > 0 && m_blockCache)
+          m_blockCache->Write(m_writePos, buffer.get(), iRead);
+      }
+    }
     if (iRead <= 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -399,6 +764,10 @@ void CFileCache::Process()
 
       iTotalWrite += iWrite;
 
+      // the cache may have joined up with data it already holds further ahead
+      if (m_pCache->CachedDataEndPos() != m_writePos + iTotalWrite)
+        break;
+
       // check if seek was asked. otherwise if cache is full we'll freeze.
       if (m_seekEvent.WaitMSec(0))
       {
@@ -410,27 +779,195 @@ void CFileCache::Process()
 
     m_writePos += iTotalWrite;
 
-    // under estimate write rate by a second, to
-    // avoid uncertainty at start of caching
-    m_writeRateActual = average.Rate(m_writePos, 1000);
+    // Continue reading the source after the data cached already
+    const int64_t cacheEndPos = m_pCache->CachedDataEndPos();
+    if (cacheEndPos > m_writePos)
+    {
+      CLog::Log(LOGDEBUG, "CFileCache::{} - <{}> cache joined up to position {}, skipping source",
+                __FUNCTION__, m_sourcePath, cacheEndPos);
+      m_writePos = cacheEndPos;
+      m_bSourceBehind = true;
+      average.Reset(m_writePos, false);
+      limiter.Reset(m_writePos);
+    }
+
+    UpdateFillState(average);
+  }
+}
+
+void CFileCache::UpdateFillState(CWriteRate& average)
+{
+  // under estimate write rate by a second, to
+  // avoid uncertainty at start of caching
+  m_writeRateActual = average.Rate(m_writePos, 1000);
+
+  if (m_readAhead &&
+      m_readAhead->Update(XbmcThreads::SystemClockMillis(), m_readPos, m_writePos,
+                          m_writeRateActual, m_fileSize > 0 && m_writePos >= m_fileSize))
+  {
+    CDataCacheCore::SCacheInfo info;
+    info.readAhead = m_readAhead->GetReadAhead();
+    info.throttleRate = m_readAhead->GetThrottleRate();
+    info.chunkSize = m_readAhead->GetChunkSize();
+    info.consumptionRate = m_readAhead->GetConsumptionRate();
+    info.deliveryRate = m_readAhead->GetDeliveryRate();
+    CServiceBroker::GetDataCacheCore().SetCacheInfo(m_sourcePath, info);
+
+    CLog::Log(LOGDEBUG,
+              "CFileCache::{} - <{}> read-ahead {} bytes, throttle {} B/s, chunk {} bytes, "
+              "consumption {} B/s, delivery {} B/s",
+              __FUNCTION__, m_sourcePath, m_readAhead->GetReadAhead(),
+              m_readAhead->GetThrottleRate(), m_readAhead->GetChunkSize(),
+              m_readAhead->GetConsumptionRate(), m_readAhead->GetDeliveryRate());
+  }
 
-   /* NOTE: We can only reliably test for low speed condition, when the cache is *really*
-    * filling. This is because as soon as it's full the average-
-    * rate will become approximately the current-rate which can flag false
-    * low read-rate conditions.
-    */
-    if (m_bFilling && m_forwardCacheSize != 0)
+  /* NOTE: We can only reliably test for low speed condition, when the cache is *really*
+   * filling. This is because as soon as it's full the average-
+   * rate will become approximately the current-rate which can flag false
+   * low read-rate conditions.
+   */
+  if (m_bFilling && m_forwardCacheSize != 0)
+  {
+    const int64_t forward = m_pCache->WaitForData(0, 0);
+    if (forward + m_chunkSize >= m_forwardCacheSize)
     {
-      const int64_t forward = m_pCache->WaitForData(0, 0);
-      if (forward + m_chunkSize >= m_forwardCacheSize)
-      {
-        if (m_writeRateActual < m_writeRate)
-          m_bLowSpeedDetected = true;
+      if (m_writeRateActual < m_writeRate)
+        m_bLowSpeedDetected = true;
 
-        m_bFilling = false;
-      }
+      m_bFilling = false;
+    }
+  }
+}
+
+void CFileCache::RestartFetch(int64_t iFilePosition)
+{
+  m_fetchPos = iFilePosition;
+  m_fetchGeneration++;
+  m_refetch.clear();
+}
+
+/*!
+ Reads size bytes at m_writePos in chunks that are all requested at once.
+ Returns the number of bytes read contiguously. The source position isn't
+ moved by this.
+ */
+ssize_t CFileCache::ReadSourceBatch(char* buffer, int64_t size)
+{
+  std::vector<SReadRequest> requests;
+  for (int64_t pos = 0; pos < size; pos += m_chunkSize)
+  {
+    const size_t chunk = static_cast<size_t>(std::min<int64_t>(m_chunkSize, size - pos));
+    requests.push_back({m_writePos + pos, buffer + pos, chunk, 0});
+  }
+
+  SReadBatch batch = {requests.data(), requests.size()};
+  if (m_source.IoControl(IOCTRL_READ_BATCH, &batch) != 0)
+    return -1;
+
+  m_bSourceBehind = true;
+
+  ssize_t total = 0;
+  for (const auto& request : requests)
+  {
+    if (request.result < 0)
+      return total > 0 ? total : -1;
+
+    total += request.result;
+    if (static_cast<size_t>(request.result) < request.size)
+      break;
+  }
+  return total;
+}
+
+bool CFileCache::FetchFromReaders()
+{
+  // Queue finished segments for reassembly, segments requested before the last seek are stale
+  CCacheRangeReader::Segment segment;
+  for (auto& reader : m_readers)
+  {
+    if (!reader->TakeResult(segment) || segment.generation != m_fetchGeneration)
+      continue;
+
+    const int64_t end = segment.pos + static_cast<int64_t>(segment.data.size());
+    if (segment.data.size() < segment.size && end < m_fileSize)
+      m_refetch.emplace_back(end, segment.size - segment.data.size());
+
+    if (m_blockCache && !segment.data.empty())
+      m_blockCache->Write(segment.pos, segment.data.data(), segment.data.size());
+
+    m_pParallelCache->AddSegment(segment.pos, std::move(segment.data));
+  }
+
+  if (m_pParallelCache->FlushSegments() < 0)
+    return false;
+
+  // joining up with cached data moves the end ahead of segments that are still to come
+  m_writePos = m_pCache->CachedDataEndPos();
+  m_fetchPos = std::max(m_fetchPos, m_writePos);
+
+  if (std::all_of(m_readers.begin(), m_readers.end(),
+                  [](const std::unique_ptr<CCacheRangeReader>& reader) {
+                    return reader->IsFailed();
+                  }))
+  {
+    CLog::Log(LOGWARNING,
+              "CFileCache::{} - <{}> all range readers failed, continuing on single connection",
+              __FUNCTION__, m_sourcePath);
+    m_bParallel = false;
+    // the single connection seeks to the write position before its next read, a failing seek
+    // ends up in its error handling
+    m_bSourceBehind = true;
+    return true;
+  }
+
+  /* Never fetch further ahead than the cache can take, else segments pile up
+   * in memory waiting for the reader to make space
+   */
+  const int64_t window = std::min<int64_t>(
+      m_pCache->GetMaxWriteSize(m_readers.size() * 2 * m_segmentSize), m_fileSize - m_writePos);
+
+  for (auto& reader : m_readers)
+  {
+    if (!reader->IsIdle())
+      continue;
+
+    int64_t pos = m_fetchPos;
+    size_t size = std::min<int64_t>(m_segmentSize, m_fileSize - m_fetchPos);
+    const bool refetch = !m_refetch.empty();
+    if (refetch)
+    {
+      pos = m_refetch.front().first;
+      size = m_refetch.front().second;
     }
+
+    if (size == 0 || pos + static_cast<int64_t>(size) - m_writePos > window)
+      break;
+
+    reader->Fetch(pos, size, m_fetchGeneration);
+    if (refetch)
+      m_refetch.pop_front();
+    else
+      m_fetchPos += size;
+  }
+
+  // Segments on local disk don't need a connection
+  while (m_blockCache && m_refetch.empty() && m_fetchPos < m_fileSize)
+  {
+    const size_t size = std::min<int64_t>(m_segmentSize, m_fileSize - m_fetchPos);
+    if (m_fetchPos + static_cast<int64_t>(size) - m_writePos > window ||
+        m_blockCache->GetCachedSize(m_fetchPos, size) < static_cast<int64_t>(size))
+      break;
+
+    std::vector<char> data(size);
+    if (m_blockCache->Read(m_fetchPos, data.data(), size) != static_cast<ssize_t>(size))
+      break;
+
+    m_pParallelCache->AddSegment(m_fetchPos, std::move(data));
+    m_fetchPos += size;
   }
+
+  m_segmentDone.WaitMSec(5);
+  return true;
 }
 
 void CFileCache::OnExit()
@@ -567,11 +1104,24 @@ void CFileCache::Close()
 {
   StopThread();
 
+  {
+    CSingleLock lock(m_readersSection);
+    m_readers.clear();
+    if (m_hostReaders > 0)
+      ReleaseHostReaders(m_readersHost, m_hostReaders);
+    m_hostReaders = 0;
+  }
+  m_bParallel = false;
+  m_blockCache.reset();
+
   CSingleLock lock(m_sync);
   if (m_pCache)
     m_pCache->Close();
 
   m_source.Close();
+
+  if (m_readAhead)
+    CServiceBroker::GetDataCacheCore().ClearCacheInfo(m_sourcePath);
 }
 
 int64_t CFileCache::GetPosition()
@@ -610,6 +1160,20 @@ int CFileCache::IoControl(EIoControl request, void* param)
     status->currate = m_writeRateActual;
     status->lowspeed = m_bLowSpeedDetected;
     m_bLowSpeedDetected = false; // Reset flag
+
+    // Close() may drop the readers meanwhile, m_sync is held by a blocking Read()
+    CSingleLock lock(m_readersSection);
+    if (m_readers.empty())
+    {
+      status->connections = 1;
+      status->conrate[0] = m_writeRateActual;
+    }
+    else
+    {
+      status->connections = m_readers.size();
+      for (size_t i = 0; i < m_readers.size(); i++)
+        status->conrate[i] = m_readers[i]->GetRate();
+    }
     return 0;
   }
 
@@ -15,10 +15,19 @@
 #include "threads/Thread.h"
 
 #include <atomic>
+#include <deque>
 #include <memory>
+#include <utility>
+#include <vector>
+
+class CWriteRate;
 
 namespace XFILE
 {
+  class CBlockCacheFile;
+  class CCacheRangeReader;
+  class CParallelFetchCache;
+  class CReadAheadController;
 
   class CFileCache : public IFile, public CThread
   {
@@ -55,7 +64,27 @@ namespace XFILE
     }
 
   private:
+    void UpdateFillState(CWriteRate& average);
+    void RestartFetch(int64_t iFilePosition);
+    bool FetchFromReaders();
+    ssize_t ReadSourceBatch(char* buffer, int64_t size);
+
     std::unique_ptr<CCacheStrategy> m_pCache;
+    CParallelFetchCache* m_pParallelCache = nullptr; /**< m_pCache when filled by range readers */
+    std::vector<std::unique_ptr<CCacheRangeReader>> m_readers;
+    CCriticalSection m_readersSection; /**< guards m_readers against status queries */
+    std::string m_readersHost;
+    unsigned int m_hostReaders = 0; /**< readers reserved for m_readersHost */
+    std::deque<std::pair<int64_t, size_t>> m_refetch; /**< segments to fetch again after short reads */
+    CEvent m_segmentDone;
+    int64_t m_fetchPos = 0; /**< file position of the next segment to hand out */
+    unsigned int m_fetchGeneration = 0; /**< bumped on seek to discard segments in flight */
+    unsigned int m_segmentSize = 0;
+    bool m_bParallel = false;
+    std::shared_ptr<CBlockCacheFile> m_blockCache;
+    bool m_bSourceBehind = false; /**< source needs seeking to m_writePos before reading */
+    unsigned int m_readBatch = 1; /**< chunks read at once from sources supporting IOCTRL_READ_BATCH */
+    std::unique_ptr<CReadAheadController> m_readAhead;
     int m_seekPossible;
     CFile m_source;
     std::string m_sourcePath;
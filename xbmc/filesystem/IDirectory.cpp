@@ -8,6 +8,7 @@
 
 #include "IDirectory.h"
 
+#include "FileItem.h"
 #include "PasswordManager.h"
 #include "URL.h"
 #include "guilib/GUIKeyboardFactory.h"
@@ -175,3 +176,25 @@ void IDirectory::RequireAuthentication(const CURL &url)
   m_requirements["type"] = "authenticate";
   m_requirements["url"] = url.Get();
 }
+
+bool IDirectory::GetItemTimes(const CFileItem& item, int64_t& mtime, int64_t& ctime)
+{
+  if (!item.HasProperty("file:mtime"))
+    return false;
+
+  mtime = item.GetProperty("file:mtime").asInteger();
+  ctime = item.GetProperty("file:ctime").asInteger();
+  return true;
+}
+
+void IDirectory::SetItemTimes(CFileItem& item, int64_t mtime, int64_t ctime)
+{
+  item.SetProperty("file:mtime", mtime);
+  item.SetProperty("file:ctime", ctime);
+}
+
+void IDirectory::ClearItemTimes(CFileItem& item)
+{
+  item.ClearProperty("file:mtime");
+  item.ClearProperty("file:ctime");
+}
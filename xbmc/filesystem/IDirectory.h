@@ -10,8 +10,10 @@
 
 #include "utils/Variant.h"
 
+#include <stdint.h>
 #include <string>
 
+class CFileItem;
 class CFileItemList;
 class CProfileManager;
 class CURL;
@@ -37,7 +39,8 @@ namespace XFILE
     DIR_FLAG_NO_FILE_INFO  = (2 << 2), ///< Don't read additional file info (stat for example)
     DIR_FLAG_GET_HIDDEN    = (2 << 3), ///< Get hidden files
     DIR_FLAG_READ_CACHE    = (2 << 4), ///< Force reading from the directory cache (if available)
-    DIR_FLAG_BYPASS_CACHE  = (2 << 5)  ///< Completely bypass the directory cache (no reading, no writing)
+    DIR_FLAG_BYPASS_CACHE  = (2 << 5), ///< Completely bypass the directory cache (no reading, no writing)
+    DIR_FLAG_PERSISTENT_CACHE = (2 << 6) ///< Use the listing kept across runs if the directory is unchanged
   };
 /*!
  \ingroup filesystem
@@ -133,7 +136,28 @@ public:
    */
   bool ProcessRequirements();
 
+  /*! \brief Get the exact modification and change time of a listed item.
+   Set by implementations that get them with the listing itself, so callers can use them instead
+   of a Stat() per item, which is a round trip each on network filesystems.
+   \param item the listed item.
+   \param mtime [out] modification time in seconds since the epoch.
+   \param ctime [out] change time in seconds since the epoch.
+   \return false if the listing didn't carry them.
+   \sa SetItemTimes
+   */
+  static bool GetItemTimes(const CFileItem& item, int64_t& mtime, int64_t& ctime);
+
+  /*! \brief Forget the times of a listed item, e.g. when they can't be trusted anymore.
+   \sa GetItemTimes
+   */
+  static void ClearItemTimes(CFileItem& item);
+
 protected:
+  /*! \brief Keep the exact modification and change time of a listed item.
+   \sa GetItemTimes
+   */
+  static void SetItemTimes(CFileItem& item, int64_t mtime, int64_t ctime);
+
   /*! \brief Prompt the user for some keyboard input
    Call this method from the GetDirectory method to retrieve additional input from the user.
    If this function returns false then no input has been received, and the GetDirectory call
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+
+/*!
+ \brief Change notification for local directories
+
+ Lets the directory cache trust a listing without touching the filesystem for
+ as long as the directory is watched and no change was reported.
+ */
+class IDirectoryWatcher
+{
+public:
+  virtual ~IDirectoryWatcher() = default;
+
+  /*!
+   \brief Start reporting changes to entries of the directory
+   \return false if the directory can't be watched
+   */
+  virtual bool Watch(const std::string& path) = 0;
+  virtual void Unwatch(const std::string& path) = 0;
+
+  /*!
+   \brief Collect the watched directories that changed since the last call
+   \param changed directories that changed, they are no longer watched
+   \return false if changes were lost, all watched directories need to be treated as changed
+   */
+  virtual bool GetChanges(std::vector<std::string>& changed) = 0;
+};
+
+} // namespace XFILE
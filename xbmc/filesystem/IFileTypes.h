@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace XFILE
@@ -46,12 +47,38 @@ struct SNativeIoControl
   void*               param;
 };
 
+/* maximum number of source connections a cache fills from in parallel */
+static const unsigned int CACHE_MAX_CONNECTIONS = 8;
+
 struct SCacheStatus
 {
   uint64_t forward;  /**< number of bytes cached forward of current position */
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   bool     lowspeed; /**< cache low speed condition detected? */
+  unsigned connections; /**< number of source connections filling the cache */
+  unsigned conrate[CACHE_MAX_CONNECTIONS]; /**< read rate of each source connection in bytes per second */
+};
+
+struct SMappedRange
+{
+  int64_t        offset; /**< file position to map */
+  size_t         size;   /**< bytes requested, set to the number of bytes available at data */
+  const uint8_t* data;   /**< mapped file data, valid until the next IOCTRL_MAP_RANGE or Close() */
+};
+
+struct SReadRequest
+{
+  int64_t offset; /**< file position to read from */
+  void*   buffer;
+  size_t  size;   /**< number of bytes to read */
+  int64_t result; /**< set to the number of bytes read, less than size at eof, -1 on error */
+};
+
+struct SReadBatch
+{
+  SReadRequest* requests;
+  size_t        count;
 };
 
 typedef enum {
@@ -61,6 +88,8 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_MAP_RANGE     = 32, /**< SMappedRange structure, map part of the file into memory */
+  IOCTRL_READ_BATCH    = 64, /**< SReadBatch structure, read all requests concurrently without moving the file position */
 } EIoControl;
 
 enum CURLOPTIONTYPE
@@ -263,6 +263,7 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
       CFileItemPtr pItem(new CFileItem(tmpDirent.name));
       pItem->m_dateTime=localTime;
       pItem->m_dwSize = iSize;
+      SetItemTimes(*pItem, tmpDirent.mtime.tv_sec, tmpDirent.ctime.tv_sec);
 
       if (bIsDir)
       {
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ParallelFetchCache.h"
+
+#include "utils/log.h"
+
+#include <cassert>
+
+using namespace XFILE;
+
+CParallelFetchCache::CParallelFetchCache(CCacheStrategy* impl) : m_pCache(impl)
+{
+  assert(m_pCache);
+}
+
+CParallelFetchCache::~CParallelFetchCache() = default;
+
+int CParallelFetchCache::Open()
+{
+  m_pending.clear();
+  return m_pCache->Open();
+}
+
+void CParallelFetchCache::Close()
+{
+  m_pending.clear();
+  m_pCache->Close();
+}
+
+size_t CParallelFetchCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return m_pCache->GetMaxWriteSize(iRequestSize);
+}
+
+int CParallelFetchCache::WriteToCache(const char* pBuffer, size_t iSize)
+{
+  const int iWrite = m_pCache->WriteToCache(pBuffer, iSize);
+  if (iWrite > 0 && !m_pending.empty())
+  {
+    // queued segments may have become contiguous, or obsolete
+    if (FlushSegments() < 0)
+      return CACHE_RC_ERROR;
+  }
+  return iWrite;
+}
+
+int CParallelFetchCache::ReadFromCache(char* pBuffer, size_t iMaxSize)
+{
+  return m_pCache->ReadFromCache(pBuffer, iMaxSize);
+}
+
+int64_t CParallelFetchCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  return m_pCache->WaitForData(iMinAvail, iMillis);
+}
+
+int64_t CParallelFetchCache::Seek(int64_t iFilePosition)
+{
+  return m_pCache->Seek(iFilePosition);
+}
+
+bool CParallelFetchCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  // the filler restarts fetching from the new cached data end, so segments
+  // queued for the old position would only occupy memory
+  m_pending.clear();
+  return m_pCache->Reset(iSourcePosition, clearAnyway);
+}
+
+void CParallelFetchCache::EndOfInput()
+{
+  m_pCache->EndOfInput();
+}
+
+bool CParallelFetchCache::IsEndOfInput()
+{
+  return m_pCache->IsEndOfInput();
+}
+
+void CParallelFetchCache::ClearEndOfInput()
+{
+  m_pCache->ClearEndOfInput();
+}
+
+int64_t CParallelFetchCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  return m_pCache->CachedDataEndPosIfSeekTo(iFilePosition);
+}
+
+int64_t CParallelFetchCache::CachedDataEndPos()
+{
+  return m_pCache->CachedDataEndPos();
+}
+
+bool CParallelFetchCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return m_pCache->IsCachedPosition(iFilePosition);
+}
+
+CCacheStrategy* CParallelFetchCache::CreateNew()
+{
+  return new CParallelFetchCache(m_pCache->CreateNew());
+}
+
+bool CParallelFetchCache::AddSegment(int64_t iFilePosition, std::vector<char>&& data)
+{
+  if (data.empty() ||
+      iFilePosition + static_cast<int64_t>(data.size()) <= m_pCache->CachedDataEndPos())
+    return false;
+
+  auto it = m_pending.find(iFilePosition);
+  if (it == m_pending.end())
+    m_pending.emplace(iFilePosition, std::move(data));
+  else if (it->second.size() < data.size())
+    it->second = std::move(data); // a retried fetch got further than the previous one
+
+  return true;
+}
+
+int CParallelFetchCache::FlushSegments()
+{
+  int iTotalWrite = 0;
+
+  while (!m_pending.empty())
+  {
+    auto it = m_pending.begin();
+    const int64_t end = m_pCache->CachedDataEndPos();
+    if (it->first > end)
+      break; // still waiting for the data in between
+
+    const std::vector<char>& data = it->second;
+    const size_t skip = static_cast<size_t>(end - it->first);
+    if (skip >= data.size())
+    {
+      m_pending.erase(it);
+      continue;
+    }
+
+    const int iWrite = m_pCache->WriteToCache(data.data() + skip, data.size() - skip);
+    if (iWrite < 0)
+    {
+      CLog::Log(LOGERROR, "CParallelFetchCache::{} - error writing to cache", __FUNCTION__);
+      return CACHE_RC_ERROR;
+    }
+    if (iWrite == 0)
+      break; // no space left, retry later
+
+    iTotalWrite += iWrite;
+  }
+
+  return iTotalWrite;
+}
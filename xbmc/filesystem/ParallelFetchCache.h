@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace XFILE
+{
+
+/*!
+ \brief Cache strategy reassembling segments fetched out of order
+
+ Wraps another cache strategy and accepts segments for arbitrary positions
+ ahead of the cached data end. Segments are held back until all data before
+ them has arrived and are then written in order to the wrapped strategy, so
+ readers always see a contiguous stream.
+
+ All writer side methods must be called from the cache filler thread only.
+ */
+class CParallelFetchCache : public CCacheStrategy
+{
+public:
+  explicit CParallelFetchCache(CCacheStrategy* impl);
+  ~CParallelFetchCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char* pBuffer, size_t iSize) override;
+  int ReadFromCache(char* pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway = true) override;
+  void EndOfInput() override;
+  bool IsEndOfInput() override;
+  void ClearEndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy* CreateNew() override;
+
+  /*!
+   \brief Queue a segment of source data for the given file position
+   \param iFilePosition position in the file of the first byte of data
+   \param data segment data, ownership is taken over
+   \return false if the segment lies completely before the cached data end
+   */
+  bool AddSegment(int64_t iFilePosition, std::vector<char>&& data);
+
+  /*!
+   \brief Write all queued data contiguous with the cached data end to the wrapped cache
+   \return number of bytes written, or CACHE_RC_ERROR
+   */
+  int FlushSegments();
+
+private:
+  std::unique_ptr<CCacheStrategy> m_pCache;
+  std::map<int64_t, std::vector<char>> m_pending; /**< queued segments keyed by file position */
+};
+
+} // namespace XFILE
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ReadAheadController.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr unsigned int SAMPLE_INTERVAL = 1000; // ms
+constexpr double CONSUMPTION_SMOOTHING = 0.3;
+constexpr double LOW_BUFFER_SECONDS = 2.0;
+constexpr unsigned int MAX_BOOST = 4;
+constexpr unsigned int BOOST_DECAY = 30000; // ms
+// a source delivering less than this multiple of the demand is never throttled
+constexpr double MIN_THROTTLE_MARGIN = 1.5;
+// sources with less headroom than this get a proportionally longer read-ahead
+constexpr double FULL_MARGIN = 4.0;
+constexpr unsigned int CHUNKS_PER_SECOND = 8;
+// the smoothed consumption never settles, smaller moves of the decisions aren't reported
+constexpr double REPORT_CHANGE = 0.1;
+
+bool IsNotable(int64_t value, int64_t reported)
+{
+  if ((value == 0) != (reported == 0))
+    return true;
+  return std::abs(value - reported) > reported * REPORT_CHANGE;
+}
+} // namespace
+
+CReadAheadController::CReadAheadController(unsigned int chunkSize,
+                                           unsigned int maxChunkSize,
+                                           int64_t maxReadAhead,
+                                           float readFactor)
+  : m_chunkSize(chunkSize),
+    m_maxChunkSize(std::max(chunkSize, maxChunkSize)),
+    m_maxReadAhead(maxReadAhead > 0 ? maxReadAhead : std::numeric_limits<int64_t>::max()),
+    m_readFactor(readFactor),
+    m_currentChunkSize(chunkSize)
+{
+  Recalculate();
+}
+
+void CReadAheadController::Reset(int64_t readPos)
+{
+  m_sampling = false;
+  m_samplePos = readPos;
+}
+
+void CReadAheadController::SetDeclaredRate(unsigned int rate)
+{
+  if (rate != m_declaredRate)
+  {
+    m_declaredRate = rate;
+    Recalculate();
+  }
+}
+
+bool CReadAheadController::Update(
+    unsigned int now, int64_t readPos, int64_t writePos, unsigned int deliveryRate, bool endOfInput)
+{
+  if (!m_sampling)
+  {
+    m_sampling = true;
+    m_sampleTime = now;
+    m_samplePos = readPos;
+    return false;
+  }
+
+  const unsigned int elapsed = now - m_sampleTime;
+  if (elapsed < SAMPLE_INTERVAL)
+    return false;
+
+  const int64_t consumed = readPos - m_samplePos;
+  if (consumed >= 0)
+  {
+    const double rate = consumed * 1000.0 / elapsed;
+    if (m_consumption > 0.0)
+      m_consumption += (rate - m_consumption) * CONSUMPTION_SMOOTHING;
+    else
+      m_consumption = rate;
+  }
+  m_sampleTime = now;
+  m_samplePos = readPos;
+
+  // running low while the player reads means the read-ahead is too short for this source
+  const double demand = GetDemand();
+  const int64_t forward = writePos - readPos;
+  if (!endOfInput && consumed > 0 && demand > 0.0 && forward < demand * LOW_BUFFER_SECONDS)
+  {
+    if (m_boost < MAX_BOOST)
+      m_boost *= 2;
+    m_boostTime = now;
+  }
+  else if (m_boost > 1 && now - m_boostTime >= BOOST_DECAY)
+  {
+    m_boost /= 2;
+    m_boostTime = now;
+  }
+
+  m_delivery = deliveryRate;
+  Recalculate();
+
+  if (m_currentChunkSize == m_reportedChunkSize &&
+      !IsNotable(m_readAhead, m_reportedReadAhead) &&
+      !IsNotable(m_throttleRate, m_reportedThrottleRate))
+    return false;
+
+  m_reportedReadAhead = m_readAhead;
+  m_reportedThrottleRate = m_throttleRate;
+  m_reportedChunkSize = m_currentChunkSize;
+  return true;
+}
+
+double CReadAheadController::GetDemand() const
+{
+  return std::max(m_consumption, static_cast<double>(m_declaredRate));
+}
+
+void CReadAheadController::Recalculate()
+{
+  const double demand = GetDemand();
+  const double margin =
+      (m_delivery > 0 && demand > 0.0) ? m_delivery / demand : FULL_MARGIN;
+
+  const double seconds =
+      m_readFactor * std::min(std::max(FULL_MARGIN / margin, 1.0), FULL_MARGIN) * m_boost;
+  m_readAhead = static_cast<int64_t>(
+      std::min(demand * seconds, static_cast<double>(m_maxReadAhead)));
+
+  if (margin < MIN_THROTTLE_MARGIN)
+    m_throttleRate = 0;
+  else
+    m_throttleRate = static_cast<unsigned int>(std::min(
+        demand * m_readFactor * m_boost,
+        static_cast<double>(std::numeric_limits<unsigned int>::max())));
+
+  const unsigned int chunks = std::max(1u, m_delivery / CHUNKS_PER_SECOND / m_chunkSize);
+  m_currentChunkSize = std::min(chunks * m_chunkSize, m_maxChunkSize / m_chunkSize * m_chunkSize);
+}
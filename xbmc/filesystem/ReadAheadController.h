@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace XFILE
+{
+
+/*!
+ \brief Adapts how far and how fast CFileCache reads ahead of the player
+
+ Compares the rate the player actually consumes data at with the rate the
+ source delivers it at and the level of the forward buffer:
+ - sources with little headroom get a longer read-ahead and aren't throttled
+ - running low on buffered data while playing doubles the read-ahead for a while
+ - faster sources are read in larger chunks
+
+ Without measurements yet it behaves like the static <readfactor> setting.
+ */
+class CReadAheadController
+{
+public:
+  /*!
+   \param chunkSize base size of source reads, chunk sizes are multiples of it
+   \param maxChunkSize upper limit of source reads
+   \param maxReadAhead size of the forward cache, 0 for no limit
+   \param readFactor read-ahead in seconds of demanded data for fast sources
+   */
+  CReadAheadController(unsigned int chunkSize,
+                       unsigned int maxChunkSize,
+                       int64_t maxReadAhead,
+                       float readFactor);
+
+  /*!
+   \brief Restart measuring the consumption after the read position jumped
+   */
+  void Reset(int64_t readPos);
+
+  /*!
+   \brief Rate the player asked for with IOCTRL_CACHE_SETRATE
+   */
+  void SetDeclaredRate(unsigned int rate);
+
+  /*!
+   \brief Feed current positions and the source rate
+   \param now time in ms
+   \param endOfInput the source has been read to its end
+   \return true if the read-ahead, throttle rate or chunk size changed notably since
+   the last time it returned true
+   */
+  bool Update(unsigned int now,
+              int64_t readPos,
+              int64_t writePos,
+              unsigned int deliveryRate,
+              bool endOfInput);
+
+  int64_t GetReadAhead() const { return m_readAhead; }
+  unsigned int GetThrottleRate() const { return m_throttleRate; }
+  unsigned int GetChunkSize() const { return m_currentChunkSize; }
+  unsigned int GetMaxChunkSize() const { return m_maxChunkSize; }
+  unsigned int GetConsumptionRate() const { return static_cast<unsigned int>(m_consumption); }
+  unsigned int GetDeliveryRate() const { return m_delivery; }
+
+private:
+  double GetDemand() const;
+  void Recalculate();
+
+  const unsigned int m_chunkSize;
+  const unsigned int m_maxChunkSize;
+  const int64_t m_maxReadAhead;
+  const float m_readFactor;
+
+  unsigned int m_declaredRate = 0;
+  double m_consumption = 0.0; /**< smoothed read rate of the player in bytes per second */
+  unsigned int m_delivery = 0;
+  unsigned int m_boost = 1;
+
+  bool m_sampling = false;
+  unsigned int m_sampleTime = 0;
+  int64_t m_samplePos = 0;
+  unsigned int m_boostTime = 0;
+
+  int64_t m_readAhead = 0;
+  unsigned int m_throttleRate = 0;
+  unsigned int m_currentChunkSize;
+
+  int64_t m_reportedReadAhead = 0;
+  unsigned int m_reportedThrottleRate = 0;
+  unsigned int m_reportedChunkSize = 0;
+};
+
+} // namespace XFILE
@@ -0,0 +1,415 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SparseCache.h"
+
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr size_t SPARSE_BLOCK_SIZE = 64 * 1024;
+constexpr size_t SPARSE_MIN_BLOCK_SIZE = 4 * 1024;
+} // namespace
+
+CSparseCache::CSparseCache(size_t front, size_t back)
+  : CCacheStrategy(), m_size(front + back), m_size_back(back)
+{
+  m_blockSize = std::max(std::min(SPARSE_BLOCK_SIZE, m_size / 16), SPARSE_MIN_BLOCK_SIZE);
+  // Ranges starting or ending in the middle of a block may share it, keep a few spare
+  m_blockCount = (m_size + m_blockSize - 1) / m_blockSize + 4;
+}
+
+CSparseCache::~CSparseCache()
+{
+  Close();
+}
+
+int CSparseCache::Open()
+{
+  CSingleLock lock(m_sync);
+  m_buf = new uint8_t[m_blockCount * m_blockSize];
+  if (m_buf == nullptr)
+    return CACHE_RC_ERROR;
+
+  m_freeBlocks.clear();
+  for (size_t i = 0; i < m_blockCount; i++)
+    m_freeBlocks.push_back(m_buf + i * m_blockSize);
+  m_blocks.clear();
+  m_ranges.clear();
+  m_ranges.emplace(0, Range{0, 0});
+  m_beg = 0;
+  m_end = 0;
+  m_cur = 0;
+  return CACHE_RC_OK;
+}
+
+void CSparseCache::Close()
+{
+  CSingleLock lock(m_sync);
+  m_freeBlocks.clear();
+  m_blocks.clear();
+  m_ranges.clear();
+  delete[] m_buf;
+  m_buf = nullptr;
+}
+
+size_t CSparseCache::GetWriteLimit() const
+{
+  const size_t back = std::min(static_cast<size_t>(m_cur - m_beg), m_size_back);
+  const size_t front = static_cast<size_t>(m_end - m_cur);
+  if (back + front >= m_size)
+    return 0;
+
+  // Blocks holding the current range's front and guaranteed back buffer can't be reused,
+  // everything else is either free or can be evicted
+  const int64_t B = m_blockSize;
+  const int64_t protectedBeg = std::max(m_beg, m_cur - static_cast<int64_t>(m_size_back));
+  size_t protectedBlocks = (m_end % B) ? 1 : 0;
+  if (m_end > protectedBeg)
+    protectedBlocks = (m_end + B - 1) / B - protectedBeg / B;
+
+  const size_t budget = (m_size + m_blockSize - 1) / m_blockSize;
+  size_t memory = budget > protectedBlocks ? (budget - protectedBlocks) * m_blockSize : 0;
+  if (m_end % B)
+    memory += m_blockSize - m_end % B; // rest of the partly filled last block
+
+  return std::min(m_size - back - front, memory);
+}
+
+size_t CSparseCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+  return std::min(iRequestSize, GetWriteLimit());
+}
+
+/**
+ * Appends data at the end of the current range. The write stops short
+ * when reaching the beginning of the next range, after which the two
+ * ranges are joined and CachedDataEndPos() moves to the end of the
+ * joined range. Callers need to check for that and continue writing from
+ * there.
+ */
+int CSparseCache::WriteToCache(const char* buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  if (m_buf == nullptr)
+    return 0;
+
+  len = std::min(len, GetWriteLimit());
+
+  auto next = m_ranges.upper_bound(m_beg);
+  if (next != m_ranges.end())
+    len = std::min(len, static_cast<size_t>(next->first - m_end));
+
+  size_t written = 0;
+  while (written < len)
+  {
+    const size_t offset = m_end % m_blockSize;
+    uint8_t* block = GetBlock(m_end / m_blockSize, true);
+    if (block == nullptr)
+      break;
+
+    const size_t size = std::min(m_blockSize - offset, len - written);
+    memcpy(block + offset, buf + written, size);
+    written += size;
+    m_end += size;
+  }
+
+  // blocks may have been evicted meanwhile, which can move the beginning of the current range
+  auto range = m_ranges.find(m_beg);
+  range->second.end = m_end;
+
+  next = std::next(range);
+  if (next != m_ranges.end() && next->first == m_end)
+  {
+    range->second.end = next->second.end;
+    m_end = next->second.end;
+    m_ranges.erase(next);
+  }
+
+  if (written > 0)
+    m_written.Set();
+
+  return static_cast<int>(written);
+}
+
+int CSparseCache::ReadFromCache(char* buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  const size_t avail = static_cast<size_t>(m_end - m_cur);
+  if (avail == 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  len = std::min(len, avail);
+
+  size_t read = 0;
+  while (read < len)
+  {
+    const size_t offset = m_cur % m_blockSize;
+    const uint8_t* block = GetBlock(m_cur / m_blockSize, false);
+    if (block == nullptr)
+      break;
+
+    const size_t size = std::min(m_blockSize - offset, len - read);
+    memcpy(buf + read, block + offset, size);
+    read += size;
+    m_cur += size;
+  }
+
+  m_space.Set();
+
+  return static_cast<int>(read);
+}
+
+int64_t CSparseCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  CSingleLock lock(m_sync);
+  int64_t avail = m_end - m_cur;
+
+  if (millis == 0 || IsEndOfInput())
+    return avail;
+
+  if (minimum > m_size - m_size_back)
+    minimum = m_size - m_size_back;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    avail = m_end - m_cur;
+  }
+
+  return avail;
+}
+
+int64_t CSparseCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (pos >= m_end && pos < m_end + 100000)
+  {
+    m_cur = m_end;
+    lock.Leave();
+    WaitForData((size_t)(pos - m_cur), 5000);
+    lock.Enter();
+  }
+
+  if (pos >= m_beg && pos <= m_end)
+  {
+    m_cur = pos;
+    return pos;
+  }
+
+  // Positions in other ranges fail as well, the source needs to be moved to the end of
+  // that range before Reset() switches over to it
+  return CACHE_RC_ERROR;
+}
+
+bool CSparseCache::Reset(int64_t pos, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (!clearAnyway)
+  {
+    auto range = FindRange(pos);
+    if (range != m_ranges.end())
+    {
+      if (range->first != m_beg)
+        SwitchRange(range);
+      m_cur = pos;
+      return false;
+    }
+
+    SwitchRange(m_ranges.emplace(pos, Range{pos, 0}).first);
+  }
+  else
+  {
+    for (const auto& block : m_blocks)
+      m_freeBlocks.push_back(block.second);
+    m_blocks.clear();
+    m_ranges.clear();
+    m_ranges.emplace(pos, Range{pos, 0});
+    m_beg = pos;
+    m_end = pos;
+  }
+
+  m_cur = pos;
+  return true;
+}
+
+int64_t CSparseCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  auto range = FindRange(iFilePosition);
+  if (range != m_ranges.end())
+    return range->second.end;
+  return iFilePosition;
+}
+
+int64_t CSparseCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_end;
+}
+
+bool CSparseCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return FindRange(iFilePosition) != m_ranges.end();
+}
+
+CCacheStrategy* CSparseCache::CreateNew()
+{
+  return new CSparseCache(m_size - m_size_back, m_size_back);
+}
+
+size_t CSparseCache::GetRangeCount()
+{
+  CSingleLock lock(m_sync);
+  return m_ranges.size();
+}
+
+CSparseCache::RangeMap::iterator CSparseCache::FindRange(int64_t pos)
+{
+  auto range = m_ranges.upper_bound(pos);
+  if (range == m_ranges.begin())
+    return m_ranges.end();
+
+  --range;
+  if (pos > range->second.end)
+    return m_ranges.end();
+
+  return range;
+}
+
+void CSparseCache::SwitchRange(RangeMap::iterator range)
+{
+  auto current = m_ranges.find(m_beg);
+  if (current != range)
+  {
+    if (current->first == current->second.end)
+      m_ranges.erase(current); // nothing was written, don't keep an empty range around
+    else
+      current->second.lastUse = ++m_useCount;
+  }
+
+  m_beg = range->first;
+  m_end = range->second.end;
+}
+
+uint8_t* CSparseCache::GetBlock(int64_t index, bool allocate)
+{
+  auto it = m_blocks.find(index);
+  if (it != m_blocks.end())
+    return it->second;
+
+  if (!allocate)
+    return nullptr;
+
+  while (m_freeBlocks.empty())
+  {
+    if (!EvictData())
+      return nullptr;
+  }
+
+  uint8_t* block = m_freeBlocks.back();
+  m_freeBlocks.pop_back();
+  m_blocks.emplace(index, block);
+  return block;
+}
+
+bool CSparseCache::BlockInUse(int64_t index) const
+{
+  const int64_t blockBeg = index * m_blockSize;
+  const int64_t blockEnd = blockBeg + m_blockSize;
+
+  // ranges don't overlap, so only the last one starting before the block end can use it
+  auto range = m_ranges.lower_bound(blockEnd);
+  if (range == m_ranges.begin())
+    return false;
+
+  --range;
+  if (range->second.end > blockBeg)
+    return true;
+
+  // an empty range will be written to next
+  return range->first == range->second.end && range->first >= blockBeg;
+}
+
+void CSparseCache::ReleaseBlock(int64_t index)
+{
+  if (BlockInUse(index))
+    return;
+
+  auto it = m_blocks.find(index);
+  if (it != m_blocks.end())
+  {
+    m_freeBlocks.push_back(it->second);
+    m_blocks.erase(it);
+  }
+}
+
+/**
+ * Shrinks cached data by up to one block. Returns false if there's
+ * nothing left that may be dropped. Note that the block may still be
+ * shared with another range, in which case it doesn't get freed yet.
+ */
+bool CSparseCache::EvictData()
+{
+  const int64_t B = m_blockSize;
+
+  // back buffer of the current range exceeding the guaranteed size
+  const int64_t first = m_beg / B;
+  const int64_t firstEnd = (first + 1) * B;
+  if (firstEnd <= m_cur - static_cast<int64_t>(m_size_back))
+  {
+    const Range range = m_ranges[m_beg];
+    m_ranges.erase(m_beg);
+    m_ranges.emplace(firstEnd, range);
+    m_beg = firstEnd;
+    ReleaseBlock(first);
+    return true;
+  }
+
+  // tail of the least recently used other range
+  auto lru = m_ranges.end();
+  for (auto it = m_ranges.begin(); it != m_ranges.end(); ++it)
+  {
+    if (it->first != m_beg && (lru == m_ranges.end() || it->second.lastUse < lru->second.lastUse))
+      lru = it;
+  }
+
+  if (lru == m_ranges.end())
+    return false;
+
+  const int64_t last = (lru->second.end - 1) / B;
+  const int64_t end = std::max(lru->first, last * B);
+  if (end == lru->first)
+    m_ranges.erase(lru);
+  else
+    lru->second.end = end;
+  ReleaseBlock(last);
+  return true;
+}
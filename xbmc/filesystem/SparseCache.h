@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <vector>
+
+namespace XFILE
+{
+
+/*!
+ \brief Memory cache keeping several independent ranges of a file
+
+ Where CCircularCache throws away everything on a seek outside its window,
+ this cache keeps the data around as separate ranges. Seeking back into one of
+ them continues from its end, and a range that grows into the next one is
+ joined with it. Memory is handed out in fixed size blocks aligned to the file
+ offset. When it runs out, back buffer exceeding the guaranteed size is
+ dropped first, then the least recently used ranges, starting at their end.
+
+ Reads and writes always go to the same range. Seeking into another range
+ fails, so CFileCache repositions its source and calls Reset(), which switches
+ ranges without dropping any data.
+ */
+class CSparseCache : public CCacheStrategy
+{
+public:
+  CSparseCache(size_t front, size_t back);
+  ~CSparseCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char* buf, size_t len) override;
+  int ReadFromCache(char* buf, size_t len) override;
+  int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t pos) override;
+  bool Reset(int64_t pos, bool clearAnyway = true) override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy* CreateNew() override;
+
+  size_t GetRangeCount();
+
+private:
+  struct Range
+  {
+    int64_t end; /**< index in file of end of valid data */
+    uint64_t lastUse; /**< value of m_useCount when range was last read from */
+  };
+  using RangeMap = std::map<int64_t, Range>;
+
+  RangeMap::iterator FindRange(int64_t pos);
+  void SwitchRange(RangeMap::iterator range);
+  uint8_t* GetBlock(int64_t index, bool allocate);
+  bool BlockInUse(int64_t index) const;
+  void ReleaseBlock(int64_t index);
+  bool EvictData();
+  size_t GetWriteLimit() const;
+
+  size_t m_size; /**< number of bytes that may be cached */
+  size_t m_size_back; /**< guaranteed size of back buffer */
+  size_t m_blockSize;
+  size_t m_blockCount; /**< number of allocated blocks, including some slack for shared blocks */
+  uint8_t* m_buf = nullptr;
+  std::vector<uint8_t*> m_freeBlocks;
+  std::map<int64_t, uint8_t*> m_blocks; /**< blocks in use keyed by file offset / m_blockSize */
+  RangeMap m_ranges; /**< cached ranges keyed by index in file of beginning of valid data */
+  int64_t m_beg = 0; /**< beginning of the range being read and written */
+  int64_t m_end = 0; /**< end of the range being read and written */
+  int64_t m_cur = 0; /**< current reading index in file */
+  uint64_t m_useCount = 0;
+  CCriticalSection m_sync;
+  CEvent m_written;
+};
+
+} // namespace XFILE
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "filesystem/BlockCache.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+class TestBlockCache : public testing::Test
+{
+protected:
+  TestBlockCache()
+  {
+    m_path = CSpecialProtocol::TranslatePath("special://temp/testblockcache");
+    CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cachePersistentSize = 64;
+
+    m_data.resize(SIZE);
+    for (size_t i = 0; i < m_data.size(); i++)
+      m_data[i] = static_cast<char>(i % 251);
+  }
+
+  ~TestBlockCache() override
+  {
+    CFile::Delete(m_path + ".idx");
+    CFile::Delete(m_path + ".data");
+    CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cachePersistentSize = 0;
+  }
+
+  static constexpr int64_t BLOCK = 1024 * 1024;
+  static constexpr int64_t SIZE = 3 * BLOCK + 100;
+
+  std::string m_path;
+  std::vector<char> m_data;
+};
+
+constexpr int64_t TestBlockCache::BLOCK;
+constexpr int64_t TestBlockCache::SIZE;
+
+TEST_F(TestBlockCache, CompleteBlocksOnly)
+{
+  CBlockCacheFile file(CBlockCache::GetInstance(), m_path, SIZE, 64 * BLOCK);
+  ASSERT_TRUE(file.Open());
+
+  file.Write(1000, m_data.data() + 1000, BLOCK);
+  EXPECT_EQ(0, file.GetCachedSize(0, SIZE));
+  char buffer[16];
+  EXPECT_EQ(0, file.Read(0, buffer, sizeof(buffer)));
+
+  file.Write(0, m_data.data(), 1000);
+  EXPECT_EQ(BLOCK, file.GetCachedSize(0, SIZE));
+  EXPECT_EQ(BLOCK - 10, file.GetCachedSize(10, SIZE));
+  EXPECT_EQ(static_cast<uint64_t>(BLOCK), file.GetCachedBytes());
+
+  // the last block is shorter
+  file.Write(3 * BLOCK, m_data.data() + 3 * BLOCK, 100);
+  EXPECT_EQ(100, file.GetCachedSize(3 * BLOCK, SIZE));
+}
+
+TEST_F(TestBlockCache, PersistsBetweenOpens)
+{
+  {
+    CBlockCacheFile file(CBlockCache::GetInstance(), m_path, SIZE, 64 * BLOCK);
+    ASSERT_TRUE(file.Open());
+    file.Write(BLOCK, m_data.data() + BLOCK, 2 * BLOCK);
+  }
+
+  CBlockCacheFile file(CBlockCache::GetInstance(), m_path, SIZE, 64 * BLOCK);
+  ASSERT_TRUE(file.Open());
+  EXPECT_EQ(0, file.GetCachedSize(0, SIZE));
+  EXPECT_EQ(2 * BLOCK, file.GetCachedSize(BLOCK, SIZE));
+
+  std::vector<char> buffer(2 * BLOCK);
+  ASSERT_EQ(2 * BLOCK, file.Read(BLOCK, buffer.data(), buffer.size()));
+  EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), m_data.begin() + BLOCK));
+}
+
+TEST_F(TestBlockCache, StaysWithinBudget)
+{
+  CBlockCacheFile file(CBlockCache::GetInstance(), m_path, SIZE, BLOCK + BLOCK / 2);
+  ASSERT_TRUE(file.Open());
+
+  // a write completing more blocks than fit is dropped as a whole
+  file.Write(0, m_data.data(), 2 * BLOCK);
+  EXPECT_EQ(0u, file.GetCachedBytes());
+
+  file.Write(0, m_data.data(), BLOCK);
+  EXPECT_EQ(static_cast<uint64_t>(BLOCK), file.GetCachedBytes());
+  file.Write(BLOCK, m_data.data() + BLOCK, BLOCK);
+  EXPECT_EQ(static_cast<uint64_t>(BLOCK), file.GetCachedBytes());
+}
+
+TEST_F(TestBlockCache, ReopenWhileReleasing)
+{
+  const CURL url("http://localhost/testblockcache.mkv");
+  // where CBlockCache keeps the source, to clean up
+  const std::string path = CSpecialProtocol::TranslatePath(URIUtils::AddFileToFolder(
+      "special://temp/blockcache",
+      KODI::UTILITY::CDigest::Calculate(KODI::UTILITY::CDigest::Type::MD5,
+                                        StringUtils::Format("{}|{}|{}", url.Get(), SIZE, 0))));
+
+  {
+    std::shared_ptr<CBlockCacheFile> file = CBlockCache::GetInstance().Open(url, SIZE, 0);
+    ASSERT_NE(nullptr, file);
+    file->Write(0, m_data.data(), BLOCK);
+  }
+
+  // the last reference goes on another thread while the source is opened again, the new
+  // file must not be made before the old one has saved its index
+  int lost = 0;
+  for (int i = 0; i < 1000; i++)
+  {
+    std::shared_ptr<CBlockCacheFile> file = CBlockCache::GetInstance().Open(url, SIZE, 0);
+    if (!file)
+    {
+      lost++;
+      continue;
+    }
+
+    std::thread release([&file]() { file.reset(); });
+    std::shared_ptr<CBlockCacheFile> reopened = CBlockCache::GetInstance().Open(url, SIZE, 0);
+    release.join();
+
+    if (!reopened || reopened->GetCachedSize(0, SIZE) != BLOCK)
+      lost++;
+  }
+  EXPECT_EQ(0, lost);
+
+  CFile::Delete(path + ".idx");
+  CFile::Delete(path + ".data");
+}
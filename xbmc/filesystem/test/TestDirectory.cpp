@@ -8,6 +8,8 @@
 
 #include "FileItem.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
+#include "filesystem/File.h"
 #include "filesystem/IDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "test/TestUtils.h"
@@ -15,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#ifdef TARGET_POSIX
+#include <utime.h>
+#endif
+
 TEST(TestDirectory, General)
 {
   std::string tmppath1, tmppath2, tmppath3;
@@ -54,3 +60,87 @@ TEST(TestDirectory, CreateRecursive)
   EXPECT_TRUE(XFILE::CDirectory::Create(path2));
   EXPECT_TRUE(XFILE::CDirectory::RemoveRecursive(path1));
 }
+
+#ifdef TARGET_POSIX
+TEST(TestDirectory, PersistentCache)
+{
+  auto path = URIUtils::AddFileToFolder(
+    CSpecialProtocol::TranslatePath("special://temp/"),
+    "TestDirectoryCache");
+  ASSERT_TRUE(XFILE::CDirectory::Create(path));
+
+  // listings of directories modified just now aren't kept
+  struct utimbuf times = {1000000000, 1000000000};
+  ASSERT_EQ(0, utime(path.c_str(), &times));
+
+  XFILE::CDirectoryCache cache;
+  CFileItemList items;
+  int64_t mtime = 0;
+  EXPECT_FALSE(cache.GetPersistentDirectory(path, items, true, mtime));
+  EXPECT_EQ(1000000000, mtime);
+  CFileItemPtr item(new CFileItem(URIUtils::AddFileToFolder(path, "a.mkv"), false));
+  item->m_dwSize = 1234;
+  items.Add(item);
+  CFileItemPtr folder(new CFileItem(URIUtils::AddFileToFolder(path, "extras/"), true));
+  folder->SetProperty("file:mtime", static_cast<int64_t>(1000000000));
+  items.Add(folder);
+  cache.SetPersistentDirectory(path, items, true, mtime);
+
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetPersistentDirectory(path, cached, false, mtime));
+  ASSERT_EQ(2, cached.Size());
+
+  // changes inside a folder aren't noticed, its times from the listing can't be used
+  int64_t folderMTime, folderCTime;
+  EXPECT_FALSE(XFILE::IDirectory::GetItemTimes(*cached[1], folderMTime, folderCTime));
+
+  // size and date are only kept while the directory is watched
+  const bool watched = cache.GetStats().watchedDirectories == 1;
+  EXPECT_EQ(watched ? 1234 : 0, cached[0]->m_dwSize);
+  cached.Clear();
+  EXPECT_EQ(watched, cache.GetPersistentDirectory(path, cached, true, mtime));
+
+  // adding a file invalidates the listing
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(URIUtils::AddFileToFolder(path, "b.mkv")));
+  file.Close();
+  cached.Clear();
+  EXPECT_FALSE(cache.GetPersistentDirectory(path, cached, true, mtime));
+
+  const XFILE::CDirectoryCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(watched ? 2u : 1u, stats.persistentHits);
+  EXPECT_EQ(watched ? 2u : 3u, stats.persistentMisses);
+
+  EXPECT_TRUE(XFILE::CDirectory::RemoveRecursive(path));
+}
+#endif
+
+TEST(TestDirectory, CachedStat)
+{
+  XFILE::CDirectoryCache cache;
+  CFileItemList items;
+  CFileItemPtr file(new CFileItem("smb://server/share/movies/a.mkv", false));
+  file->m_dwSize = 1234;
+  file->SetProperty("file:mtime", static_cast<int64_t>(1000000000));
+  file->SetProperty("file:ctime", static_cast<int64_t>(900000000));
+  items.Add(file);
+  items.Add(CFileItemPtr(new CFileItem("smb://server/share/movies/b.mkv", false)));
+  items.Add(CFileItemPtr(new CFileItem("smb://server/share/movies/extras/", true)));
+  items.Get("smb://server/share/movies/extras/")->SetProperty("file:mtime",
+                                                              static_cast<int64_t>(1100000000));
+  cache.SetDirectory("smb://server/share/movies/", items, XFILE::DIR_CACHE_ONCE);
+
+  struct __stat64 buffer;
+  ASSERT_TRUE(cache.GetStat("smb://server/share/movies/a.mkv", &buffer));
+  EXPECT_EQ(1234, buffer.st_size);
+  EXPECT_EQ(1000000000, buffer.st_mtime);
+  EXPECT_EQ(900000000, buffer.st_ctime);
+
+  ASSERT_TRUE(cache.GetStat("smb://server/share/movies/extras", &buffer));
+  EXPECT_TRUE(S_ISDIR(buffer.st_mode));
+  EXPECT_EQ(1100000000, buffer.st_mtime);
+
+  // the listing didn't carry the times, the file has to be stat'ed
+  EXPECT_FALSE(cache.GetStat("smb://server/share/movies/b.mkv", &buffer));
+  EXPECT_FALSE(cache.GetStat("smb://server/share/other/a.mkv", &buffer));
+}
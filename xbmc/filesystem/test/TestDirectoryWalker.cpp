@@ -0,0 +1,96 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryWalker.h"
+#include "filesystem/IDirectory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+int CountFolders(const CFileItemList& items)
+{
+  int folders = 0;
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    if (items[i]->m_bIsFolder)
+      folders++;
+  }
+  return folders;
+}
+} // namespace
+
+TEST(TestDirectoryWalker, ListsAheadAndOnDemand)
+{
+  const std::string root =
+      URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "walker/");
+  const std::string a = URIUtils::AddFileToFolder(root, "a/");
+  const std::string b = URIUtils::AddFileToFolder(root, "b/");
+  ASSERT_TRUE(XFILE::CDirectory::Create(URIUtils::AddFileToFolder(a, "a1")));
+  ASSERT_TRUE(XFILE::CDirectory::Create(URIUtils::AddFileToFolder(a, "a2")));
+  ASSERT_TRUE(XFILE::CDirectory::Create(b));
+
+  {
+    XFILE::CDirectoryWalker walker("", XFILE::DIR_FLAG_DEFAULTS, {}, true, 2, 1);
+    walker.Walk(root);
+
+    CFileItemList items;
+    EXPECT_TRUE(walker.GetDirectory(root, items));
+    EXPECT_EQ(2, CountFolders(items));
+
+    items.Clear();
+    EXPECT_TRUE(walker.GetDirectory(a, items));
+    EXPECT_EQ(2, CountFolders(items));
+
+    // listed right away once the walker dropped it
+    walker.Finished(b);
+    items.Clear();
+    EXPECT_TRUE(walker.GetDirectory(b, items));
+    EXPECT_EQ(0, items.Size());
+
+    walker.Finished(root);
+  }
+
+  EXPECT_TRUE(XFILE::CDirectory::RemoveRecursive(root));
+}
+
+TEST(TestDirectoryWalker, ListsOnlyWalkedPaths)
+{
+  const std::string root =
+      URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "walker/");
+  const std::string a = URIUtils::AddFileToFolder(root, "a/");
+  const std::string b = URIUtils::AddFileToFolder(root, "b/");
+  ASSERT_TRUE(XFILE::CDirectory::Create(URIUtils::AddFileToFolder(a, "a1")));
+  ASSERT_TRUE(XFILE::CDirectory::Create(b));
+
+  {
+    XFILE::CDirectoryWalker walker("", XFILE::DIR_FLAG_DEFAULTS, {}, false, 2, 1);
+
+    CFileItemList items;
+    EXPECT_TRUE(walker.GetDirectory(root, items));
+    EXPECT_EQ(2, CountFolders(items));
+
+    // nothing below a folder that wasn't walked is listed ahead
+    walker.Walk(a);
+    items.Clear();
+    EXPECT_TRUE(walker.GetDirectory(a, items));
+    EXPECT_EQ(1, CountFolders(items));
+
+    items.Clear();
+    EXPECT_TRUE(walker.GetDirectory(b, items));
+    EXPECT_EQ(0, items.Size());
+
+    walker.Finished(root);
+  }
+
+  EXPECT_TRUE(XFILE::CDirectory::RemoveRecursive(root));
+}
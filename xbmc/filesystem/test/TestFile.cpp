@@ -11,6 +11,7 @@
 
 #include <errno.h>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -207,3 +208,71 @@ TEST(TestFile, SetHidden)
   EXPECT_TRUE(XFILE::CFile::Exists(XBMC_TEMPFILEPATH(file)));
   EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
 }
+
+#ifdef TARGET_POSIX
+TEST(TestFile, MapRange)
+{
+  XFILE::CFile *file;
+  const char str[] = "TestFile.MapRange test string\n";
+
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  file->Close();
+  ASSERT_TRUE(file->OpenForWrite(XBMC_TEMPFILEPATH(file), true));
+  EXPECT_EQ((int)sizeof(str), file->Write(str, sizeof(str)));
+  XFILE::SMappedRange range = {0, sizeof(str), nullptr};
+  EXPECT_EQ(-1, file->IoControl(XFILE::IOCTRL_MAP_RANGE, &range));
+  file->Close();
+
+  ASSERT_TRUE(file->Open(XBMC_TEMPFILEPATH(file)));
+  range = {4, 100, nullptr};
+  ASSERT_EQ(0, file->IoControl(XFILE::IOCTRL_MAP_RANGE, &range));
+  EXPECT_EQ(sizeof(str) - 4, range.size);
+  EXPECT_EQ(0, memcmp(str + 4, range.data, range.size));
+
+  // end of file
+  range = {sizeof(str), 100, nullptr};
+  ASSERT_EQ(0, file->IoControl(XFILE::IOCTRL_MAP_RANGE, &range));
+  EXPECT_EQ(0u, range.size);
+
+  // mapping doesn't move the file position
+  EXPECT_EQ(0, file->GetPosition());
+  file->Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+#endif
+
+#ifdef TARGET_POSIX
+TEST(TestFile, ReadBatch)
+{
+  XFILE::CFile *file;
+  std::string str;
+  for (int i = 0; i < 1000; i++)
+    str += "TestFile.ReadBatch line " + std::to_string(i) + "\n";
+
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  file->Close();
+  ASSERT_TRUE(file->OpenForWrite(XBMC_TEMPFILEPATH(file), true));
+  EXPECT_EQ(static_cast<ssize_t>(str.size()), file->Write(str.data(), str.size()));
+  file->Close();
+
+  ASSERT_TRUE(file->Open(XBMC_TEMPFILEPATH(file)));
+  std::vector<char> buf(str.size() + 100);
+  XFILE::SReadRequest requests[] = {
+      {1000, buf.data() + 1000, 4000, 0},
+      {0, buf.data(), 1000, 0},
+      {5000, buf.data() + 5000, buf.size() - 5000, 0},
+  };
+  XFILE::SReadBatch batch = {requests, 3};
+  ASSERT_EQ(0, file->IoControl(XFILE::IOCTRL_READ_BATCH, &batch));
+  EXPECT_EQ(4000, requests[0].result);
+  EXPECT_EQ(1000, requests[1].result);
+  // short read at eof
+  EXPECT_EQ(static_cast<int64_t>(str.size() - 5000), requests[2].result);
+  EXPECT_EQ(0, memcmp(str.data(), buf.data(), str.size()));
+
+  // reading doesn't move the file position
+  EXPECT_EQ(0, file->GetPosition());
+  file->Close();
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+#endif
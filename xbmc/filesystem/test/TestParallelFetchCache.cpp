@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CircularCache.h"
+#include "filesystem/ParallelFetchCache.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+std::vector<char> MakeSegment(int64_t pos, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>((pos + i) & 0xff);
+  return data;
+}
+} // namespace
+
+TEST(TestParallelFetchCache, ReassemblesOutOfOrderSegments)
+{
+  CParallelFetchCache cache(new CCircularCache(4096, 1024));
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  EXPECT_TRUE(cache.AddSegment(200, MakeSegment(200, 100)));
+  EXPECT_TRUE(cache.AddSegment(100, MakeSegment(100, 100)));
+  EXPECT_EQ(0, cache.FlushSegments());
+  EXPECT_EQ(0, cache.CachedDataEndPos());
+
+  EXPECT_TRUE(cache.AddSegment(0, MakeSegment(0, 100)));
+  EXPECT_EQ(300, cache.FlushSegments());
+  EXPECT_EQ(300, cache.CachedDataEndPos());
+
+  char buffer[300];
+  ASSERT_EQ(300, cache.ReadFromCache(buffer, sizeof(buffer)));
+  for (int i = 0; i < 300; i++)
+    EXPECT_EQ(static_cast<char>(i & 0xff), buffer[i]);
+}
+
+TEST(TestParallelFetchCache, OverlappingAndStaleSegments)
+{
+  CParallelFetchCache cache(new CCircularCache(4096, 1024));
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  const std::vector<char> head = MakeSegment(0, 150);
+  ASSERT_EQ(150, cache.WriteToCache(head.data(), head.size()));
+
+  // completely before the cached data end
+  EXPECT_FALSE(cache.AddSegment(0, MakeSegment(0, 100)));
+
+  // partially cached already, only the tail is written
+  EXPECT_TRUE(cache.AddSegment(100, MakeSegment(100, 100)));
+  EXPECT_EQ(50, cache.FlushSegments());
+  EXPECT_EQ(200, cache.CachedDataEndPos());
+}
+
+TEST(TestParallelFetchCache, ResetDropsQueuedSegments)
+{
+  CParallelFetchCache cache(new CCircularCache(4096, 1024));
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  EXPECT_TRUE(cache.AddSegment(100, MakeSegment(100, 100)));
+  EXPECT_TRUE(cache.Reset(0));
+
+  const std::vector<char> head = MakeSegment(0, 100);
+  ASSERT_EQ(100, cache.WriteToCache(head.data(), head.size()));
+  EXPECT_EQ(100, cache.CachedDataEndPos());
+}
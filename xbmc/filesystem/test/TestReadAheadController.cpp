@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/ReadAheadController.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr unsigned int CHUNK = 128 * 1024;
+constexpr unsigned int MB = 1024 * 1024;
+
+// Plays for the given number of seconds at rate while the source keeps forward bytes ahead,
+// returns whether any second reported a change
+bool Play(CReadAheadController& controller,
+          unsigned int& now,
+          int64_t& pos,
+          unsigned int seconds,
+          unsigned int rate,
+          unsigned int delivery,
+          int64_t forward)
+{
+  bool changed = false;
+  for (unsigned int i = 0; i < seconds; i++)
+  {
+    now += 1000;
+    pos += rate;
+    if (controller.Update(now, pos, pos + forward, delivery, false))
+      changed = true;
+  }
+  return changed;
+}
+} // namespace
+
+TEST(TestReadAheadController, StaticWithoutMeasurements)
+{
+  CReadAheadController controller(CHUNK, 8 * CHUNK, 64 * MB, 4.0f);
+  controller.SetDeclaredRate(MB);
+
+  EXPECT_EQ(4 * MB, controller.GetReadAhead());
+  EXPECT_EQ(4 * MB, controller.GetThrottleRate());
+  EXPECT_EQ(CHUNK, controller.GetChunkSize());
+}
+
+TEST(TestReadAheadController, AdaptsToSourceHeadroom)
+{
+  CReadAheadController controller(CHUNK, 8 * CHUNK, 256 * MB, 4.0f);
+  controller.SetDeclaredRate(MB);
+  unsigned int now = 0;
+  int64_t pos = 0;
+  controller.Update(now, pos, pos, 0, false);
+
+  // fast source: base read-ahead, larger chunks
+  Play(controller, now, pos, 10, MB, 40 * MB, 64 * MB);
+  EXPECT_EQ(4 * MB, controller.GetReadAhead());
+  EXPECT_EQ(8 * CHUNK, controller.GetChunkSize());
+  EXPECT_GT(controller.GetThrottleRate(), 0u);
+
+  // source barely faster than playback: read further ahead, never throttle
+  Play(controller, now, pos, 10, MB, 2 * MB, 64 * MB);
+  EXPECT_EQ(8 * MB, controller.GetReadAhead());
+  EXPECT_EQ(CHUNK * 2, controller.GetChunkSize());
+  Play(controller, now, pos, 1, MB, MB + MB / 4, 64 * MB);
+  EXPECT_EQ(0u, controller.GetThrottleRate());
+}
+
+TEST(TestReadAheadController, ReportsChangesOnly)
+{
+  CReadAheadController controller(CHUNK, 8 * CHUNK, 256 * MB, 4.0f);
+  controller.SetDeclaredRate(MB);
+  unsigned int now = 0;
+  int64_t pos = 0;
+  controller.Update(now, pos, pos, 0, false);
+
+  // the first sample, then nothing while playback is steady
+  EXPECT_TRUE(Play(controller, now, pos, 1, MB, 40 * MB, 64 * MB));
+  EXPECT_FALSE(Play(controller, now, pos, 10, MB, 40 * MB, 64 * MB));
+
+  // a slow source changes the decisions
+  EXPECT_TRUE(Play(controller, now, pos, 1, MB, 2 * MB, 64 * MB));
+}
+
+TEST(TestReadAheadController, BoostsOnLowBuffer)
+{
+  CReadAheadController controller(CHUNK, 8 * CHUNK, 256 * MB, 4.0f);
+  controller.SetDeclaredRate(MB);
+  unsigned int now = 0;
+  int64_t pos = 0;
+  controller.Update(now, pos, pos, 0, false);
+
+  Play(controller, now, pos, 1, MB, 40 * MB, MB);
+  EXPECT_EQ(8 * MB, controller.GetReadAhead());
+  Play(controller, now, pos, 1, MB, 40 * MB, MB);
+  EXPECT_EQ(16 * MB, controller.GetReadAhead());
+
+  // recovers after a while with enough data buffered
+  Play(controller, now, pos, 70, MB, 40 * MB, 32 * MB);
+  EXPECT_EQ(4 * MB, controller.GetReadAhead());
+}
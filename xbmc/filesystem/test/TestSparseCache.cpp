@@ -0,0 +1,118 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/SparseCache.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr size_t FRONT = 768 * 1024;
+constexpr size_t BACK = 256 * 1024;
+
+// Writes file data for [pos, pos + size) as CFileCache would after seeking the source to pos
+void Fill(CSparseCache& cache, int64_t pos, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>((pos + i) % 251);
+
+  size_t written = 0;
+  while (written < size)
+  {
+    const int ret = cache.WriteToCache(data.data() + written, size - written);
+    ASSERT_GT(ret, 0);
+    written += ret;
+    if (cache.CachedDataEndPos() != pos + static_cast<int64_t>(written))
+      break; // joined up with a range further ahead
+  }
+}
+
+void ExpectData(CSparseCache& cache, int64_t pos, size_t size)
+{
+  std::vector<char> data(size);
+  size_t read = 0;
+  while (read < size)
+  {
+    const int ret = cache.ReadFromCache(data.data() + read, size - read);
+    ASSERT_GT(ret, 0);
+    read += ret;
+  }
+  for (size_t i = 0; i < size; i++)
+    ASSERT_EQ(static_cast<char>((pos + i) % 251), data[i]) << "at " << pos + i;
+}
+} // namespace
+
+TEST(TestSparseCache, KeepsRangesAcrossSeeks)
+{
+  CSparseCache cache(FRONT, BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 100000);
+
+  // seek outside of the cached range starts a new one
+  EXPECT_FALSE(cache.IsCachedPosition(500000));
+  EXPECT_TRUE(cache.Reset(500000, false));
+  Fill(cache, 500000, 100000);
+  EXPECT_EQ(2u, cache.GetRangeCount());
+
+  // seeking into the first range is served without dropping anything
+  EXPECT_TRUE(cache.IsCachedPosition(50000));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(50000));
+  EXPECT_EQ(100000, cache.CachedDataEndPosIfSeekTo(50000));
+  EXPECT_FALSE(cache.Reset(50000, false));
+  EXPECT_EQ(100000, cache.CachedDataEndPos());
+  ExpectData(cache, 50000, 50000);
+
+  EXPECT_TRUE(cache.IsCachedPosition(550000));
+  EXPECT_EQ(600000, cache.CachedDataEndPosIfSeekTo(550000));
+}
+
+TEST(TestSparseCache, JoinsRanges)
+{
+  CSparseCache cache(FRONT, BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  EXPECT_TRUE(cache.Reset(300000, false));
+  Fill(cache, 300000, 100000);
+  EXPECT_TRUE(cache.Reset(200000, false));
+
+  // writing up to the next range joins both and moves the end past it
+  Fill(cache, 200000, 150000);
+  EXPECT_EQ(400000, cache.CachedDataEndPos());
+  EXPECT_EQ(1u, cache.GetRangeCount());
+  ExpectData(cache, 200000, 200000);
+}
+
+TEST(TestSparseCache, EvictsLeastRecentlyUsedRange)
+{
+  CSparseCache cache(FRONT, BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 300000);
+  EXPECT_TRUE(cache.Reset(10000000, false));
+  Fill(cache, 10000000, 300000);
+  EXPECT_TRUE(cache.Reset(20000000, false));
+  EXPECT_EQ(3u, cache.GetRangeCount());
+
+  // filling the front buffer needs the memory of the oldest range
+  Fill(cache, 20000000, 900000);
+  EXPECT_FALSE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(10000000));
+  ExpectData(cache, 20000000, 900000);
+
+  // once read, data beyond the guaranteed back buffer goes before other ranges
+  EXPECT_GT(cache.GetMaxWriteSize(FRONT), 0u);
+  Fill(cache, 20900000, 100000);
+  EXPECT_TRUE(cache.IsCachedPosition(10000000));
+  EXPECT_TRUE(cache.IsCachedPosition(20900000 - BACK));
+}
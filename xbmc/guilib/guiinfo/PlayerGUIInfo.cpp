@@ -32,6 +32,19 @@
 
 using namespace KODI::GUILIB::GUIINFO;
 
+namespace
+{
+std::string FormatQueueInfo(const CDataCacheCore::SQueueInfo& info)
+{
+  if (info.maxDataSize <= 0)
+    return "";
+
+  return StringUtils::Format("{:.1f} MB, {:.1f} s at {} kbit/s",
+                             info.maxDataSize / (1024.0 * 1024.0), info.maxTimeSize,
+                             info.bitrate * 8 / 1000);
+}
+} // namespace
+
 CPlayerGUIInfo::CPlayerGUIInfo()
 : m_playerShowTime(false),
   m_playerShowInfo(false)
@@ -313,6 +326,9 @@ bool CPlayerGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case PLAYER_PROCESS_VIDEODECODER:
       value = CServiceBroker::GetDataCacheCore().GetVideoDecoderName();
       return true;
+    case PLAYER_PROCESS_VIDEODECODERTHREADING:
+      value = CServiceBroker::GetDataCacheCore().GetVideoDecoderThreading();
+      return true;
     case PLAYER_PROCESS_DEINTMETHOD:
       value = CServiceBroker::GetDataCacheCore().GetVideoDeintMethod();
       return true;
@@ -343,6 +359,12 @@ bool CPlayerGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case PLAYER_PROCESS_AUDIOBITSPERSAMPLE:
       value = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetAudioBitsPerSample());
       return true;
+    case PLAYER_PROCESS_VIDEOQUEUE:
+      value = FormatQueueInfo(CServiceBroker::GetDataCacheCore().GetVideoQueueInfo());
+      return true;
+    case PLAYER_PROCESS_AUDIOQUEUE:
+      value = FormatQueueInfo(CServiceBroker::GetDataCacheCore().GetAudioQueueInfo());
+      return true;
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // PLAYLIST_*
@@ -16,6 +16,7 @@
 #include "Util.h"
 #include "VideoLibrary.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
 #include "media/MediaLockState.h"
 #include "settings/AdvancedSettings.h"
@@ -163,6 +164,21 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const std::string &method, ITranspo
   return InvalidParams;
 }
 
+JSONRPC_STATUS CFileOperations::GetDirectoryCacheStats(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  const CDirectoryCache::Stats stats = g_directoryCache.GetStats();
+
+  result["memory"]["hits"] = stats.hits;
+  result["memory"]["misses"] = stats.misses;
+  result["memory"]["directories"] = stats.directories;
+  result["persistent"]["hits"] = stats.persistentHits;
+  result["persistent"]["misses"] = stats.persistentMisses;
+  result["persistent"]["directories"] = stats.persistentDirectories;
+  result["persistent"]["watched"] = stats.watchedDirectories;
+
+  return OK;
+}
+
 JSONRPC_STATUS CFileOperations::GetFileDetails(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   std::string file = parameterObject["file"].asString();
@@ -27,6 +27,7 @@
 #include "events/EventLog.h"
 #include "events/MediaLibraryEvent.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
@@ -121,6 +122,10 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      StartWalker(CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg",
+                  CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps,
+                  true);
+
       bool commit = true;
       for (const auto& it : m_pathsToScan)
       {
@@ -140,7 +145,9 @@ void CMusicInfoScanner::Process()
 
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
+        WalkDirectory(it);
         bool scancomplete = DoScan(it);
+        FinishDirectory(it);
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -187,6 +194,7 @@ void CMusicInfoScanner::Process()
         }
       }
 
+      StopWalker();
       m_fileCountReader.StopThread();
 
       m_musicDatabase.EmptyCache();
@@ -270,6 +278,7 @@ void CMusicInfoScanner::Process()
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
   m_musicDatabase.Close();
+  g_directoryCache.SavePersistent();
   CLog::Log(LOGDEBUG, "{} - Finished scan", __FUNCTION__);
 
   m_bRunning = false;
@@ -489,7 +498,7 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 
   // load subfolder
   CFileItemList items;
-  CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg", DIR_FLAG_DEFAULTS);
+  GetScanDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg");
 
   // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
   // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
@@ -556,6 +565,7 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
       {
         m_bStop = true;
       }
+      FinishDirectory(strPath);
     }
   }
   return !m_bStop;
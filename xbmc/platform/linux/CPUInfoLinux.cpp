@@ -208,6 +208,26 @@ CCPUInfoLinux::CCPUInfoLinux()
 
     if (ecx & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // usable only if the OS saves the AVX registers (XCR0 bits 1 and 2)
+    if ((ecx & CPUID_00000001_ECX_OSXSAVE) && (ecx & CPUID_00000001_ECX_AVX))
+    {
+      unsigned int xcr0;
+      unsigned int xcr0High;
+      __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+
+      if ((xcr0 & 0x6) == 0x6)
+      {
+        m_cpuFeatures |= CPU_FEATURE_AVX;
+
+        if (__get_cpuid_max(0, nullptr) >= CPUID_INFOTYPE_STRUCTURED_EXTENDED)
+        {
+          __cpuid_count(CPUID_INFOTYPE_STRUCTURED_EXTENDED, 0, eax, ebx, ecx, edx);
+          if (ebx & CPUID_00000007_EBX_AVX2)
+            m_cpuFeatures |= CPU_FEATURE_AVX2;
+        }
+      }
+    }
   }
 
   if (__get_cpuid(CPUID_INFOTYPE_EXTENDED_IMPLEMENTED, &eax, &eax, &ecx, &edx))
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "InotifyDirectoryWatcher.h"
+
+#include "utils/log.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+
+namespace
+{
+// anything that changes the listing, including size and date of the entries
+constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY |
+                                IN_ATTRIB | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF |
+                                IN_ONLYDIR;
+
+// inotify only sees changes made through this machine, not those of other clients of a share
+bool IsNetworkFilesystem(const std::string& path)
+{
+  struct statfs st;
+  if (statfs(path.c_str(), &st) != 0)
+    return true;
+
+  switch (static_cast<uint32_t>(st.f_type))
+  {
+    case 0x6969: // nfs
+    case 0x517B: // smb
+    case 0xFF534D42: // cifs
+    case 0xFE534D42: // smb2
+    case 0x65735546: // fuse
+    case 0x01021997: // 9p
+    case 0x00C36400: // ceph
+    case 0x5346414F: // afs
+    case 0x73757245: // coda
+    case 0x564C: // ncp
+      return true;
+    default:
+      return false;
+  }
+}
+} // namespace
+
+CInotifyDirectoryWatcher::CInotifyDirectoryWatcher()
+{
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+    CLog::Log(LOGWARNING, "CInotifyDirectoryWatcher - inotify unavailable: {}", strerror(errno));
+}
+
+CInotifyDirectoryWatcher::~CInotifyDirectoryWatcher()
+{
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+bool CInotifyDirectoryWatcher::Watch(const std::string& path)
+{
+  if (m_fd < 0)
+    return false;
+
+  if (m_paths.find(path) != m_paths.end())
+    return true;
+
+  if (IsNetworkFilesystem(path))
+    return false;
+
+  const int wd = inotify_add_watch(m_fd, path.c_str(), WATCH_MASK);
+  if (wd < 0)
+  {
+    // ENOSPC: out of watches, fs.inotify.max_user_watches is the limit
+    if (errno == ENOSPC)
+      CLog::Log(LOGDEBUG, "CInotifyDirectoryWatcher::{} - watch limit reached", __FUNCTION__);
+    return false;
+  }
+
+  // the same directory under another path shares the watch descriptor, keep the first one
+  if (!m_watches.emplace(wd, path).second)
+    return false;
+
+  m_paths.emplace(path, wd);
+  return true;
+}
+
+void CInotifyDirectoryWatcher::Unwatch(const std::string& path)
+{
+  const auto it = m_paths.find(path);
+  if (it == m_paths.end())
+    return;
+
+  inotify_rm_watch(m_fd, it->second);
+  m_watches.erase(it->second);
+  m_paths.erase(it);
+}
+
+bool CInotifyDirectoryWatcher::GetChanges(std::vector<std::string>& changed)
+{
+  if (m_fd < 0)
+    return true;
+
+  bool overflow = false;
+  alignas(struct inotify_event) char buffer[16 * 1024];
+  while (true)
+  {
+    const ssize_t size = read(m_fd, buffer, sizeof(buffer));
+    if (size < 0 && errno == EINTR)
+      continue;
+    if (size <= 0)
+      break;
+
+    for (ssize_t pos = 0; pos < size;)
+    {
+      const struct inotify_event* event = reinterpret_cast<struct inotify_event*>(buffer + pos);
+      pos += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        overflow = true;
+        continue;
+      }
+
+      const auto it = m_watches.find(event->wd);
+      if (it == m_watches.end())
+        continue; // already reported
+
+      changed.push_back(it->second);
+      if (!(event->mask & IN_IGNORED))
+        inotify_rm_watch(m_fd, it->first);
+      m_paths.erase(it->second);
+      m_watches.erase(it);
+    }
+  }
+
+  if (overflow)
+  {
+    CLog::Log(LOGDEBUG, "CInotifyDirectoryWatcher::{} - event queue overflowed", __FUNCTION__);
+    while (!m_paths.empty())
+      Unwatch(m_paths.begin()->first);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,37 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/IDirectoryWatcher.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Watches local directories with inotify
+
+ Events are queued by the kernel and only read when the changes are asked for,
+ so there's no thread polling the descriptor.
+ */
+class CInotifyDirectoryWatcher : public XFILE::IDirectoryWatcher
+{
+public:
+  CInotifyDirectoryWatcher();
+  ~CInotifyDirectoryWatcher() override;
+
+  bool Watch(const std::string& path) override;
+  void Unwatch(const std::string& path) override;
+  bool GetChanges(std::vector<std::string>& changed) override;
+
+private:
+  int m_fd = -1;
+  std::map<int, std::string> m_watches;
+  std::map<std::string, int> m_paths;
+};
@@ -0,0 +1,275 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PosixAsyncReader.h"
+
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <unistd.h>
+
+#if defined(HAS_IO_URING)
+#include <liburing.h>
+#endif
+
+using namespace XFILE;
+
+namespace
+{
+
+void ReadRequest(int fd, SReadRequest& request)
+{
+  request.result = 0;
+  while (static_cast<size_t>(request.result) < request.size)
+  {
+    char* buffer = static_cast<char*>(request.buffer) + request.result;
+    const size_t size = request.size - static_cast<size_t>(request.result);
+#ifdef TARGET_ANDROID
+    const ssize_t ret = pread64(fd, buffer, size, (off64_t)(request.offset + request.result));
+#else
+    const ssize_t ret = pread(fd, buffer, size, (off_t)(request.offset + request.result));
+#endif
+    if (ret < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      request.result = -1;
+      return;
+    }
+    if (ret == 0)
+      return; // eof
+
+    request.result += ret;
+  }
+}
+
+#if defined(HAS_IO_URING)
+class CIoUring
+{
+public:
+  explicit CIoUring(unsigned int depth) : m_depth(depth)
+  {
+    const int ret = io_uring_queue_init(depth, &m_ring, 0);
+    m_valid = ret == 0;
+    if (!m_valid)
+      CLog::Log(LOGINFO, "CIoUring - io_uring unavailable ({}), using read threads", -ret);
+  }
+
+  ~CIoUring()
+  {
+    if (m_valid)
+      io_uring_queue_exit(&m_ring);
+  }
+
+  bool IsValid() const { return m_valid; }
+
+  bool Read(int fd, SReadRequest* requests, size_t count);
+
+private:
+  bool Prepare(int fd, SReadRequest* request)
+  {
+    io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+    if (!sqe)
+      return false;
+
+    const size_t done = static_cast<size_t>(request->result);
+    io_uring_prep_read(sqe, fd, static_cast<char*>(request->buffer) + done,
+                       static_cast<unsigned>(request->size - done), request->offset + done);
+    io_uring_sqe_set_data(sqe, request);
+    return true;
+  }
+
+  struct io_uring m_ring;
+  const unsigned int m_depth;
+  bool m_valid = false;
+};
+
+/*!
+ Keeps up to m_depth reads in flight, short reads are continued with another
+ request for the rest. If the ring breaks, everything that reached the kernel
+ is still reaped before returning, so the caller can reuse the buffers.
+ */
+bool CIoUring::Read(int fd, SReadRequest* requests, size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+    requests[i].result = 0;
+
+  std::vector<SReadRequest*> retry;
+  size_t next = 0;
+  unsigned int queued = 0; // prepared, not submitted yet
+  unsigned int submitted = 0; // in the kernel
+  bool failed = false;
+
+  while ((!failed && (next < count || !retry.empty() || queued > 0)) || submitted > 0)
+  {
+    while (!failed && queued + submitted < m_depth && (!retry.empty() || next < count))
+    {
+      SReadRequest* request = retry.empty() ? &requests[next] : retry.back();
+      if (!Prepare(fd, request))
+        break;
+
+      if (retry.empty())
+        next++;
+      else
+        retry.pop_back();
+      queued++;
+    }
+
+    if (!failed)
+    {
+      const int ret = io_uring_submit_and_wait(&m_ring, 1);
+      if (ret >= 0)
+      {
+        queued -= std::min(queued, static_cast<unsigned int>(ret));
+        submitted += ret;
+      }
+      else if (ret != -EINTR && ret != -EAGAIN && ret != -EBUSY)
+      {
+        CLog::Log(LOGERROR, "CIoUring::{} - submit failed with error {}", __FUNCTION__, -ret);
+        failed = true;
+      }
+    }
+    else
+    {
+      io_uring_cqe* cqe;
+      const int ret = io_uring_wait_cqe(&m_ring, &cqe);
+      if (ret < 0 && ret != -EINTR)
+      {
+        CLog::Log(LOGFATAL, "CIoUring::{} - lost {} reads with error {}", __FUNCTION__,
+                  submitted, -ret);
+        break;
+      }
+    }
+
+    io_uring_cqe* cqe;
+    while (submitted > 0 && io_uring_peek_cqe(&m_ring, &cqe) == 0)
+    {
+      SReadRequest* request = static_cast<SReadRequest*>(io_uring_cqe_get_data(cqe));
+      const int res = cqe->res;
+      io_uring_cqe_seen(&m_ring, cqe);
+      submitted--;
+
+      if (res == -EINTR || res == -EAGAIN)
+        retry.push_back(request);
+      else if (res < 0)
+        request->result = -1;
+      else if (res > 0)
+      {
+        request->result += res;
+        if (static_cast<size_t>(request->result) < request->size)
+          retry.push_back(request);
+      }
+    }
+  }
+
+  return !failed;
+}
+#endif
+
+} // namespace
+
+CPosixAsyncReader& CPosixAsyncReader::GetInstance()
+{
+  static CPosixAsyncReader reader;
+  return reader;
+}
+
+CPosixAsyncReader::~CPosixAsyncReader()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_stop = true;
+    m_jobAdded.notifyAll();
+  }
+
+  for (auto& worker : m_workers)
+    worker->StopThread();
+}
+
+bool CPosixAsyncReader::Read(int fd, SReadRequest* requests, size_t count)
+{
+  if (count == 0)
+    return true;
+
+#if defined(HAS_IO_URING)
+  const auto& settings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  if (settings->m_cacheReadIoUring && !m_ioUringFailed)
+  {
+    thread_local std::unique_ptr<CIoUring> ring;
+    if (!ring)
+      ring.reset(new CIoUring(settings->m_cacheReadQueueDepth));
+
+    if (ring->IsValid() && ring->Read(fd, requests, count))
+      return true;
+
+    // most likely not allowed for this process, don't try again on other threads
+    m_ioUringFailed = true;
+  }
+#endif
+
+  return ReadThreaded(fd, requests, count);
+}
+
+bool CPosixAsyncReader::ReadThreaded(int fd, SReadRequest* requests, size_t count)
+{
+  CSingleLock lock(m_critSection);
+  if (m_stop)
+    return false;
+
+  if (m_workers.empty())
+  {
+    const unsigned int threads =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheReadThreads;
+    for (unsigned int i = 0; i < threads; i++)
+    {
+      m_workers.emplace_back(new CThread(this, "AsyncReader"));
+      m_workers.back()->Create();
+    }
+  }
+
+  Batch batch = {count};
+  for (size_t i = 0; i < count; i++)
+    m_jobs.push_back(Job{fd, &requests[i], &batch});
+  m_jobAdded.notifyAll();
+
+  // batch is only touched with the lock held, so it can't go away under a worker
+  while (batch.pending > 0)
+    m_jobDone.wait(lock);
+
+  return true;
+}
+
+void CPosixAsyncReader::Run()
+{
+  CSingleLock lock(m_critSection);
+  while (true)
+  {
+    while (!m_stop && m_jobs.empty())
+      m_jobAdded.wait(lock);
+
+    if (m_stop)
+      break;
+
+    const Job job = m_jobs.front();
+    m_jobs.pop_front();
+
+    {
+      CSingleExit exit(m_critSection);
+      ReadRequest(job.fd, *job.request);
+    }
+
+    if (--job.batch->pending == 0)
+      m_jobDone.notifyAll();
+  }
+}
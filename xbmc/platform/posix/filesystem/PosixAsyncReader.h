@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "filesystem/IFileTypes.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class CThread;
+
+namespace XFILE
+{
+
+/*!
+ \brief Reads batches of positioned requests from local files concurrently
+
+ Each calling thread gets its own io_uring when built with liburing and the
+ kernel allows it, which keeps up to <cache><readqueuedepth> reads in flight
+ without any extra thread. Otherwise the requests are spread over a small pool
+ of threads doing pread(), which still keeps several requests queued at the
+ disk.
+ */
+class CPosixAsyncReader : private IRunnable
+{
+public:
+  static CPosixAsyncReader& GetInstance();
+
+  /*!
+   \brief Read all requests, returns once every request completed
+   \return false if the requests couldn't be read
+   */
+  bool Read(int fd, SReadRequest* requests, size_t count);
+
+private:
+  struct Batch
+  {
+    size_t pending;
+  };
+
+  struct Job
+  {
+    int fd;
+    SReadRequest* request;
+    Batch* batch;
+  };
+
+  CPosixAsyncReader() = default;
+  ~CPosixAsyncReader() override;
+
+  bool ReadThreaded(int fd, SReadRequest* requests, size_t count);
+  void Run() override;
+
+  std::deque<Job> m_jobs;
+  std::vector<std::unique_ptr<CThread>> m_workers;
+  bool m_stop = false;
+  std::atomic<bool> m_ioUringFailed{false};
+  XbmcThreads::ConditionVariable m_jobAdded;
+  XbmcThreads::ConditionVariable m_jobDone;
+  CCriticalSection m_critSection;
+};
+
+} // namespace XFILE
@@ -8,6 +8,7 @@
 
 #include "PosixFile.h"
 
+#include "PosixAsyncReader.h"
 #include "URL.h"
 #include "filesystem/File.h"
 #include "utils/AliasShortcutUtils.h"
@@ -21,7 +22,14 @@
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
+#include <sys/mount.h>
+#include <sys/param.h>
+#else
+#include <sys/vfs.h>
+#endif
 
 #if defined(HAVE_STATX) // use statx if available to get file birth date
 #include <sys/sysmacros.h>
@@ -30,8 +38,54 @@
 
 using namespace XFILE;
 
+namespace
+{
+// size of the window mapped by IOCTRL_MAP_RANGE, moved along as the file is read
+constexpr size_t MAP_WINDOW_SIZE = 16 * 1024 * 1024;
+
+/* A mapped page that can't be read raises SIGBUS in the reader instead of
+ * failing a read(), so only files on local disk filesystems are mapped.
+ * Network and fuse mounts can fail or go away at any time.
+ */
+bool IsMappable(int fd)
+{
+#if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
+  struct statfs st;
+  return fstatfs(fd, &st) == 0 && (st.f_flags & MNT_LOCAL);
+#else
+  struct statfs st;
+  if (fstatfs(fd, &st) != 0)
+    return false;
+
+  switch (static_cast<uint32_t>(st.f_type))
+  {
+    case 0xEF53: // ext2/3/4
+    case 0x58465342: // xfs
+    case 0x9123683E: // btrfs
+    case 0xF2F52010: // f2fs
+    case 0x3153464A: // jfs
+    case 0x52654973: // reiserfs
+    case 0x4D44: // vfat
+    case 0x2011BAB0: // exfat
+    case 0x5346544E: // ntfs
+    case 0x7366746E: // ntfs3
+    case 0x482B: // hfsplus
+    case 0x9660: // iso9660
+    case 0x15013346: // udf
+    case 0x73717368: // squashfs
+    case 0x01021994: // tmpfs
+    case 0x794C7630: // overlayfs
+      return true;
+    default:
+      return false;
+  }
+#endif
+}
+} // namespace
+
 CPosixFile::~CPosixFile()
 {
+  Unmap();
   if (m_fd >= 0)
     close(m_fd);
 }
@@ -83,6 +137,7 @@ bool CPosixFile::OpenForWrite(const CURL& url, bool bOverWrite /* = false*/ )
 
 void CPosixFile::Close()
 {
+  Unmap();
   if (m_fd >= 0)
   {
     close(m_fd);
@@ -116,21 +171,7 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
   if (m_filePos >= 0)
   {
     m_filePos += res; // if m_filePos was known - update it
-#if defined(HAVE_POSIX_FADVISE)
-    // Drop the cache between then last drop and 16 MB behind where we
-    // are now, to make sure the file doesn't displace everything else.
-    // However, never throw out the first 16 MB of the file, as it might
-    // be the header etc., and never ask the OS to drop in chunks of
-    // less than 1 MB.
-    const int64_t end_drop = m_filePos - 16 * 1024 * 1024;
-    if (end_drop >= 17 * 1024 * 1024)
-    {
-      const int64_t start_drop = std::max<int64_t>(m_lastDropPos, 16 * 1024 * 1024);
-      if (end_drop - start_drop >= 1 * 1024 * 1024 &&
-          posix_fadvise(m_fd, start_drop, end_drop - start_drop, POSIX_FADV_DONTNEED) == 0)
-        m_lastDropPos = end_drop;
-    }
-#endif
+    DropCacheBehind(m_filePos);
   }
 
   return res;
@@ -235,6 +276,19 @@ int CPosixFile::IoControl(EIoControl request, void* param)
       return -1;
     return ioctl(m_fd, ((SNativeIoControl*)param)->request, ((SNativeIoControl*)param)->param);
   }
+  else if (request == IOCTRL_MAP_RANGE)
+  {
+    if (!param)
+      return -1;
+    return MapRange(static_cast<SMappedRange*>(param));
+  }
+  else if (request == IOCTRL_READ_BATCH)
+  {
+    if (!param)
+      return -1;
+    SReadBatch* batch = static_cast<SReadBatch*>(param);
+    return CPosixAsyncReader::GetInstance().Read(m_fd, batch->requests, batch->count) ? 0 : -1;
+  }
   else if (request == IOCTRL_SEEK_POSSIBLE)
   {
     if (GetPosition() < 0)
@@ -271,6 +325,100 @@ int CPosixFile::IoControl(EIoControl request, void* param)
   return -1;
 }
 
+/*!
+ \brief Map part of a file opened for reading
+
+ A window of the file is mapped around range->offset and kept until a range
+ outside of it is requested, so sequential readers mostly get a pointer
+ without any system call. The size of the file is checked whenever the window
+ moves, which picks up files that are still growing. Only files on local disk
+ filesystems are mapped, see IsMappable(). Note that truncating the file while
+ it's mapped makes accesses beyond the new end fault.
+ */
+int CPosixFile::MapRange(SMappedRange* range)
+{
+  if (m_allowWrite || range->offset < 0)
+    return -1;
+
+  if (!m_mapData || range->offset < m_mapOffset ||
+      range->offset >= m_mapOffset + static_cast<int64_t>(m_mapSize))
+  {
+    struct stat64 st;
+    if (fstat64(m_fd, &st) != 0 || !S_ISREG(st.st_mode) || !IsMappable(m_fd))
+      return -1;
+
+    if (range->offset >= st.st_size)
+    {
+      range->size = 0;
+      range->data = nullptr;
+      return 0;
+    }
+
+    Unmap();
+
+    static const int64_t pageSize = sysconf(_SC_PAGESIZE);
+    const int64_t offset = range->offset - range->offset % pageSize;
+    const size_t size = static_cast<size_t>(
+        std::min<int64_t>(MAP_WINDOW_SIZE, st.st_size - offset));
+
+    const off_t offsetOffT = (off_t) offset;
+    // check for parameter overflow
+    if (sizeof(int64_t) != sizeof(off_t) && offset != offsetOffT)
+      return -1;
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_fd, offsetOffT);
+    if (data == MAP_FAILED)
+    {
+      CLog::LogF(LOGDEBUG, "mmap failed with error {}", errno);
+      return -1;
+    }
+
+    m_mapData = static_cast<uint8_t*>(data);
+    m_mapOffset = offset;
+    m_mapSize = size;
+
+    // pages are read once front to back, let the kernel read ahead aggressively
+    // and drop them early
+    madvise(m_mapData, m_mapSize, MADV_SEQUENTIAL);
+    madvise(m_mapData, m_mapSize, MADV_WILLNEED);
+    DropCacheBehind(offset);
+  }
+
+  const size_t pos = static_cast<size_t>(range->offset - m_mapOffset);
+  range->size = std::min(range->size, m_mapSize - pos);
+  range->data = m_mapData + pos;
+  return 0;
+}
+
+void CPosixFile::Unmap()
+{
+  if (m_mapData)
+  {
+    munmap(m_mapData, m_mapSize);
+    m_mapData = nullptr;
+    m_mapOffset = 0;
+    m_mapSize = 0;
+  }
+}
+
+void CPosixFile::DropCacheBehind(int64_t pos)
+{
+#if defined(HAVE_POSIX_FADVISE)
+  // Drop the cache between then last drop and 16 MB behind where we
+  // are now, to make sure the file doesn't displace everything else.
+  // However, never throw out the first 16 MB of the file, as it might
+  // be the header etc., and never ask the OS to drop in chunks of
+  // less than 1 MB.
+  const int64_t end_drop = pos - 16 * 1024 * 1024;
+  if (end_drop >= 17 * 1024 * 1024)
+  {
+    const int64_t start_drop = std::max<int64_t>(m_lastDropPos, 16 * 1024 * 1024);
+    if (end_drop - start_drop >= 1 * 1024 * 1024 &&
+        posix_fadvise(m_fd, start_drop, end_drop - start_drop, POSIX_FADV_DONTNEED) == 0)
+      m_lastDropPos = end_drop;
+  }
+#endif
+}
 
 bool CPosixFile::Delete(const CURL& url)
 {
@@ -38,10 +38,17 @@ namespace XFILE
     int Stat(struct __stat64* buffer) override;
 
   protected:
+    int MapRange(SMappedRange* range);
+    void Unmap();
+    void DropCacheBehind(int64_t pos);
+
     int     m_fd = -1;
     int64_t m_filePos = -1;
     int64_t m_lastDropPos = -1;
     bool    m_allowWrite = false;
+    uint8_t* m_mapData = nullptr;
+    int64_t  m_mapOffset = 0;
+    size_t   m_mapSize = 0;
   };
 
 }
@@ -38,6 +38,11 @@ struct CachedDirEntry
 {
   unsigned int type;
   std::string name;
+  bool hasInfo = false;
+  bool hidden = false;
+  int64_t size = 0;
+  int64_t mtime = 0;
+  int64_t ctime = 0;
 };
 
 using namespace XFILE;
@@ -84,6 +89,27 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
   lock.Enter();
   if (!smb.IsSmbValid())
     return false;
+#ifdef HAS_SMBC_READDIRPLUS2
+  // inside a share the entries come with their stat info, no round trip per entry
+  if (!url.GetShareName().empty())
+  {
+    struct stat info;
+    const struct libsmb_file_info* fileInfo;
+    while ((fileInfo = smbc_readdirplus2(fd, &info)))
+    {
+      CachedDirEntry aDir;
+      aDir.type = S_ISDIR(info.st_mode) ? SMBC_DIR : SMBC_FILE;
+      aDir.name = fileInfo->name;
+      aDir.hasInfo = true;
+      aDir.hidden = (fileInfo->attrs & SMBC_DOS_MODE_HIDDEN) != 0;
+      aDir.size = info.st_size;
+      aDir.mtime = info.st_mtime;
+      aDir.ctime = info.st_ctime;
+      vecEntries.push_back(aDir);
+    }
+  }
+  else
+#endif
   while ((dirEnt = smbc_readdir(fd)))
   {
     CachedDirEntry aDir;
@@ -108,6 +134,8 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
      int64_t iSize = 0;
       bool bIsDir = true;
       int64_t lTimeDate = 0;
+      int64_t lCreateDate = 0;
+      bool hasInfo = false;
       bool hidden = false;
 
       if(StringUtils::EndsWith(strFile, "$") && aDir.type == SMBC_FILE_SHARE )
@@ -116,8 +144,17 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
       if (StringUtils::StartsWith(strFile, "."))
         hidden = true;
 
+      if (aDir.hasInfo)
+      {
+        bIsDir = (aDir.type == SMBC_DIR);
+        hasInfo = true;
+        hidden |= aDir.hidden;
+        lTimeDate = aDir.mtime;
+        lCreateDate = aDir.ctime;
+        iSize = aDir.size;
+      }
       // only stat files that can give proper responses
-      if ( aDir.type == SMBC_FILE ||
+      else if ( aDir.type == SMBC_FILE ||
            aDir.type == SMBC_DIR )
       {
         // set this here to if the stat should fail
@@ -155,9 +192,9 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
                   CURL::GetRedacted(strFullName), errno, strerror(errno));
 
             bIsDir = S_ISDIR(info.st_mode);
+            hasInfo = true;
             lTimeDate = info.st_mtime;
-            if(lTimeDate == 0) // if modification date is missing, use create date
-              lTimeDate = info.st_ctime;
+            lCreateDate = info.st_ctime;
             iSize = info.st_size;
           }
           else
@@ -169,7 +206,7 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
       }
 
       KODI::TIME::FileTime fileTime, localTime;
-      KODI::TIME::TimeTToFileTime(lTimeDate, &fileTime);
+      KODI::TIME::TimeTToFileTime(lTimeDate ? lTimeDate : lCreateDate, &fileTime);
       KODI::TIME::FileTimeToLocalFileTime(&fileTime, &localTime);
 
       if (bIsDir)
@@ -194,6 +231,8 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         pItem->m_dateTime=localTime;
         if (hidden)
           pItem->SetProperty("file:hidden", true);
+        if (hasInfo)
+          SetItemTimes(*pItem, lTimeDate, lCreateDate);
         items.Add(pItem);
       }
       else
@@ -205,6 +244,8 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         pItem->m_dateTime=localTime;
         if (hidden)
           pItem->SetProperty("file:hidden", true);
+        if (hasInfo)
+          SetItemTimes(*pItem, lTimeDate, lCreateDate);
         items.Add(pItem);
       }
     }
@@ -163,160 +163,3 @@ inline void copy_plane(uint8_t *const src, const int srcStride, int height, int
     }
   }
 }
-
-inline void convert_yuv420_nv12_chrome(uint8_t *const *src, const int *srcStride, int height, int width, uint8_t *const dst, const int dstStride)
-{
-#if defined(HAVE_SSE2)
-  __m128i xmm0, xmm1, xmm2, xmm3, xmm4;
-  _mm_sfence();
-#endif
-
-  const size_t chroma_width = (width + 1) >> 1;
-  const size_t chromaHeight = height >> 1;
-  size_t line, i;
-
-  for (line = 0; line < chromaHeight; ++line)
-  {
-    uint8_t * u = src[0] + line * srcStride[0];
-    uint8_t * v = src[1] + line * srcStride[1];
-    uint8_t * d = dst + line * dstStride;
-
-    // if memory is not aligned use memcpy
-#if defined(HAVE_SSE2)
-    if (((size_t)(u) | (size_t)(v) | (size_t)(d)) & 0xF)
-#endif
-    {
-      for (i = 0; i < chroma_width; ++i)
-      {
-        *d++ = *u++;
-        *d++ = *v++;
-      }
-    }
-#if defined(HAVE_SSE2)
-    else
-    {
-      for (i = 0; i < (chroma_width - 31); i += 32)
-      {
-        xmm0 = _mm_load_si128((__m128i*)(v + i));
-        xmm1 = _mm_load_si128((__m128i*)(u + i));
-        xmm2 = _mm_load_si128((__m128i*)(v + i + 16));
-        xmm3 = _mm_load_si128((__m128i*)(u + i + 16));
-
-        xmm4 = xmm0;
-        xmm0 = _mm_unpacklo_epi8(xmm1, xmm0);
-        xmm4 = _mm_unpackhi_epi8(xmm1, xmm4);
-
-        xmm1 = xmm2;
-        xmm2 = _mm_unpacklo_epi8(xmm3, xmm2);
-        xmm1 = _mm_unpackhi_epi8(xmm3, xmm1);
-
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 0), xmm0);
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 16), xmm4);
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 32), xmm2);
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 48), xmm1);
-      }
-      if (((size_t)chroma_width) & 0xF)
-      {
-        d += (i << 1);
-        u += i; v += i;
-        for (; i < chroma_width; ++i)
-        {
-          *d++ = *u++;
-          *d++ = *v++;
-        }
-      }
-      else if (i < chroma_width)
-      {
-        xmm0 = _mm_load_si128((__m128i*)(v + i));
-        xmm1 = _mm_load_si128((__m128i*)(u + i));
-
-        xmm2 = xmm0;
-        xmm0 = _mm_unpacklo_epi8(xmm1, xmm0);
-        xmm2 = _mm_unpackhi_epi8(xmm1, xmm2);
-
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 0), xmm0);
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 16), xmm2);
-      }
-    }
-#endif
-  }
-}
-
-inline void convert_yuv420_p01x_chrome(uint8_t *const *src, const int *srcStride, int height, int width, uint8_t *const dst, const int dstStride, uint8_t bpp)
-{
-  const uint8_t shift = 16 - bpp;
-#if defined(HAVE_SSE2)
-  __m128i xmm0, xmm1, xmm2, xmm3, xmm4;
-  _mm_sfence();
-#endif
-
-  // Convert to P01x - Chroma
-  const size_t chromaWidth = (width + 1) >> 1;
-  const size_t chromaHeight = height >> 1;
-  size_t line, i;
-
-  for (line = 0; line < chromaHeight; ++line)
-  {
-    uint16_t * u = (uint16_t*)(src[0] + line * srcStride[0]);
-    uint16_t * v = (uint16_t*)(src[1] + line * srcStride[1]);
-    uint16_t * d = (uint16_t*)(dst + line * dstStride);
-
-    // if memory is not aligned use memcpy
-#if defined(HAVE_SSE2)
-    if (((size_t)(u) | (size_t)(v) | (size_t)(d)) & 0xF)
-#endif
-    {
-      for (i = 0; i < chromaWidth; ++i)
-      {
-        *d++ = *u++ << shift;
-        *d++ = *v++ << shift;
-      }
-    }
-#if defined(HAVE_SSE2)
-    else
-    {
-      for (i = 0; i < chromaWidth; i += 16)
-      {
-        xmm0 = _mm_load_si128((__m128i*)(v + i));
-        xmm1 = _mm_load_si128((__m128i*)(u + i));
-        xmm2 = _mm_load_si128((__m128i*)(v + i + 8));
-        xmm3 = _mm_load_si128((__m128i*)(u + i + 8));
-
-        xmm0 = _mm_slli_epi16(xmm0, shift);
-        xmm1 = _mm_slli_epi16(xmm1, shift);
-        xmm2 = _mm_slli_epi16(xmm2, shift);
-        xmm3 = _mm_slli_epi16(xmm3, shift);
-
-        xmm4 = xmm0;
-        xmm0 = _mm_unpacklo_epi16(xmm1, xmm0);
-        xmm4 = _mm_unpackhi_epi16(xmm1, xmm4);
-
-        xmm1 = xmm2;
-        xmm2 = _mm_unpacklo_epi16(xmm3, xmm2);
-        xmm1 = _mm_unpackhi_epi16(xmm3, xmm1);
-
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 0), xmm0);
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 8), xmm4);
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 16), xmm2);
-        _mm_stream_si128((__m128i *)(d + (i << 1) + 24), xmm1);
-      }
-    }
-#endif
-  }
-}
-
-inline void convert_yuv420_nv12(uint8_t *const src[], const int srcStride[], int height, int width, uint8_t *const dst[], const int dstStride[])
-{
-  // Convert to NV12 - Luma
-  copy_plane(src[0], srcStride[0], height, width, dst[0], dstStride[0]);
-  // Convert to NV12 - Chroma
-  convert_yuv420_nv12_chrome(&src[1], &srcStride[1], height, width, dst[1], dstStride[1]);
-}
-
-inline void convert_yuv420_p01x(uint8_t *const src[], const int srcStride[], int height, int width, uint8_t *const dst[], const int dstStride[], uint8_t bpp)
-{
-  // Convert to P01x - Luma
-  copy_plane(src[0], srcStride[0], height, width, dst[0], dstStride[0], bpp);
-  // Convert to P01x - Chroma
-  convert_yuv420_p01x_chrome(&src[1], &srcStride[1], height, width, dst[1], dstStride[1], bpp);
-}
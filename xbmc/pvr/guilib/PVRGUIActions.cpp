@@ -1225,54 +1225,59 @@ namespace PVR
     }
   }
 
-  void CPVRGUIActions::StartPlayback(CFileItem* item,
-                                     bool bFullscreen,
-                                     CPVRStreamProperties* epgProps) const
+  void CPVRGUIActions::FillStreamProperties(CFileItem& item, CPVRStreamProperties* epgProps) const
   {
     // Obtain dynamic playback url and properties from the respective pvr client
-    const std::shared_ptr<CPVRClient> client = CServiceBroker::GetPVRManager().GetClient(*item);
+    const std::shared_ptr<CPVRClient> client = CServiceBroker::GetPVRManager().GetClient(item);
     if (client)
     {
       CPVRStreamProperties props;
 
-      if (item->IsPVRChannel())
+      if (item.IsPVRChannel())
       {
         // If this was an EPG Tag to be played as live then PlayEpgTag() will create a channel
         // fileitem instead and pass the epg tags props so we use those and skip the client call
         if (epgProps)
           props = *epgProps;
         else
-          client->GetChannelStreamProperties(item->GetPVRChannelInfoTag(), props);
+          client->GetChannelStreamProperties(item.GetPVRChannelInfoTag(), props);
       }
-      else if (item->IsPVRRecording())
+      else if (item.IsPVRRecording())
       {
-        client->GetRecordingStreamProperties(item->GetPVRRecordingInfoTag(), props);
+        client->GetRecordingStreamProperties(item.GetPVRRecordingInfoTag(), props);
       }
-      else if (item->IsEPG())
+      else if (item.IsEPG())
       {
         if (epgProps) // we already have props from PlayEpgTag()
           props = *epgProps;
         else
-          client->GetEpgTagStreamProperties(item->GetEPGInfoTag(), props);
+          client->GetEpgTagStreamProperties(item.GetEPGInfoTag(), props);
       }
 
       if (props.size())
       {
         const std::string url = props.GetStreamURL();
         if (!url.empty())
-          item->SetDynPath(url);
+          item.SetDynPath(url);
 
         const std::string mime = props.GetStreamMimeType();
         if (!mime.empty())
         {
-          item->SetMimeType(mime);
-          item->SetContentLookup(false);
+          item.SetMimeType(mime);
+          item.SetContentLookup(false);
         }
 
         for (const auto& prop : props)
-          item->SetProperty(prop.first, prop.second);
+          item.SetProperty(prop.first, prop.second);
       }
     }
+  }
+
+  void CPVRGUIActions::StartPlayback(CFileItem* item,
+                                     bool bFullscreen,
+                                     CPVRStreamProperties* epgProps) const
+  {
+    FillStreamProperties(*item, epgProps);
 
     CApplicationMessenger::GetInstance().PostMsg(TMSG_MEDIA_PLAY, 0, 0, static_cast<void*>(item));
     CheckAndSwitchToFullscreen(bFullscreen);
@@ -429,6 +429,14 @@ namespace PVR
      */
     CPVRGUIChannelNavigator& GetChannelNavigator();
 
+    /*!
+     * @brief Set the dynamic playback url, mime type and stream properties obtained from the
+     * respective pvr client for the given item.
+     * @param item containing a channel, a recording or an epg tag.
+     * @param epgProps propeties to be used instead of calling to the client if supplied.
+     */
+    void FillStreamProperties(CFileItem& item, CPVRStreamProperties* epgProps = nullptr) const;
+
     /*!
      * @brief Inform GUI actions that playback of an item just started.
      * @param item The item that started to play.
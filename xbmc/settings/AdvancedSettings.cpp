@@ -341,6 +341,7 @@ void CAdvancedSettings::Initialize()
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
   m_curlDisableHTTP2 = false;
+  m_curlMaxHostConnections = 4;
 
 #if defined(TARGET_WINDOWS_DESKTOP)
   m_minimizeToTray = false;
@@ -359,6 +360,9 @@ void CAdvancedSettings::Initialize()
   m_GLRectangleHack = false;
   m_iSkipLoopFilter = 0;
   m_bVirtualShares = true;
+  m_bPersistentDirectoryCache = true;
+  m_libraryScanThreads = 4;
+  m_libraryScanHostConnections = 2;
   m_bTry10bitOutput = false;
 
   m_cpuTempCmd = "";
@@ -378,6 +382,7 @@ void CAdvancedSettings::Initialize()
   m_iPVRNumericChannelSwitchTimeout = 2000;
   m_iPVRTimeshiftThreshold = 10;
   m_bPVRTimeshiftSimpleOSD = true;
+  m_iPVRPreloadChannels = 0;
   m_PVRDefaultSortOrder.sortBy = SortByDate;
   m_PVRDefaultSortOrder.sortOrder = SortOrderDescending;
 
@@ -388,6 +393,17 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cacheAdaptiveReadAhead = true;
+
+  // number of connections used to fill the cache, 1 disables parallel fetching
+  m_cacheParallelReaders = 1;
+  m_cacheParallelSegmentSize = 2 * 1024 * 1024; // 2 MiB
+  m_cachePersistentSize = 0; // disabled
+
+  // asynchronous reads of local files, a queue depth of 1 reads chunk by chunk
+  m_cacheReadQueueDepth = 8;
+  m_cacheReadThreads = 4;
+  m_cacheReadIoUring = true;
 
   m_addonPackageFolderSize = 200;
 
@@ -760,6 +776,46 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
       // Get default global display latency
       XMLUtils::GetFloat(pVideoLatency, "delay", m_videoDefaultLatency, -600.0f, 600.0f);
     }
+
+    // software decoder threading, first matching rule wins
+    TiXmlElement* pDecoderThreading = pElement->FirstChildElement("decoderthreading");
+    if (pDecoderThreading)
+    {
+      TiXmlElement* pRule = pDecoderThreading->FirstChildElement("rule");
+      while (pRule)
+      {
+        VideoDecoderThreading rule = {};
+        rule.live = -1;
+
+        XMLUtils::GetString(pRule, "codec", rule.codec);
+        XMLUtils::GetInt(pRule, "minheight", rule.minheight, 0, 8640);
+        XMLUtils::GetInt(pRule, "maxheight", rule.maxheight, 0, 8640);
+        XMLUtils::GetInt(pRule, "threads", rule.threads, 0, 64);
+        XMLUtils::GetBoolean(pRule, "lowdelay", rule.lowdelay);
+
+        bool live;
+        if (XMLUtils::GetBoolean(pRule, "live", live))
+          rule.live = live ? 1 : 0;
+
+        // frame, slice, frame+slice or none
+        std::string type = "frame+slice";
+        XMLUtils::GetString(pRule, "type", type);
+        StringUtils::ToLower(type);
+        rule.frameThreads = type == "frame" || type == "frame+slice";
+        rule.sliceThreads = type == "slice" || type == "frame+slice";
+
+        if ((rule.frameThreads || rule.sliceThreads || type == "none") &&
+            (rule.maxheight == 0 || rule.maxheight >= rule.minheight))
+          m_videoDecoderThreading.push_back(rule);
+        else
+          CLog::Log(LOGWARNING,
+                    "Ignoring malformed decoder threading rule, codec:{} type:{} minheight:{} "
+                    "maxheight:{}",
+                    rule.codec, type, rule.minheight, rule.maxheight);
+
+        pRule = pRule->NextSiblingElement("rule");
+      }
+    }
   }
 
   pElement = pRootElement->FirstChildElement("musiclibrary");
@@ -841,6 +897,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlkeepaliveinterval", m_curlKeepAliveInterval, 0, 300);
     XMLUtils::GetBoolean(pElement, "disableipv6", m_curlDisableIPV6);
     XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
+    XMLUtils::GetInt(pElement, "curlmaxhostconnections", m_curlMaxHostConnections, 0, 32);
     XMLUtils::GetString(pElement, "catrustfile", m_caTrustFile);
   }
 
@@ -851,6 +908,15 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetUInt(pElement, "chunksize", m_cacheChunkSize, 256, 1024 * 1024);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetBoolean(pElement, "adaptivereadahead", m_cacheAdaptiveReadAhead);
+    XMLUtils::GetUInt(pElement, "parallelreaders", m_cacheParallelReaders, 1,
+                      XFILE::CACHE_MAX_CONNECTIONS);
+    XMLUtils::GetUInt(pElement, "parallelsegmentsize", m_cacheParallelSegmentSize, 64 * 1024,
+                      16 * 1024 * 1024);
+    XMLUtils::GetUInt(pElement, "persistentsize", m_cachePersistentSize);
+    XMLUtils::GetUInt(pElement, "readqueuedepth", m_cacheReadQueueDepth, 1, 64);
+    XMLUtils::GetUInt(pElement, "readthreads", m_cacheReadThreads, 1, 16);
+    XMLUtils::GetBoolean(pElement, "iouring", m_cacheReadIoUring);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -922,6 +988,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetInt(pRootElement,"skiploopfilter", m_iSkipLoopFilter, -16, 48);
 
   XMLUtils::GetBoolean(pRootElement,"virtualshares", m_bVirtualShares);
+  XMLUtils::GetBoolean(pRootElement, "persistentdirectorycache", m_bPersistentDirectoryCache);
+  XMLUtils::GetInt(pRootElement, "libraryscanthreads", m_libraryScanThreads, 0, 16);
+  XMLUtils::GetInt(pRootElement, "libraryscanhostconnections", m_libraryScanHostConnections, 1, 16);
   XMLUtils::GetUInt(pRootElement, "packagefoldersize", m_addonPackageFolderSize);
   XMLUtils::GetBoolean(pRootElement, "try10bitoutput", m_bTry10bitOutput);
 
@@ -1117,6 +1186,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pPVR, "numericchannelswitchtimeout", m_iPVRNumericChannelSwitchTimeout, 50, 60000);
     XMLUtils::GetInt(pPVR, "timeshiftthreshold", m_iPVRTimeshiftThreshold, 0, 60);
     XMLUtils::GetBoolean(pPVR, "timeshiftsimpleosd", m_bPVRTimeshiftSimpleOSD);
+    XMLUtils::GetInt(pPVR, "preloadchannels", m_iPVRPreloadChannels, 0, 4);
     TiXmlElement* pSortDecription = pPVR->FirstChildElement("pvrrecordings");
     if (pSortDecription)
     {
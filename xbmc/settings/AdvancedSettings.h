@@ -102,6 +102,19 @@ struct RefreshVideoLatency
   float delay;
 };
 
+struct VideoDecoderThreading
+{
+  std::string codec; // ffmpeg decoder name, empty for all
+  int minheight;
+  int maxheight; // 0 for any height
+  int live; // -1 for all streams, 0 for files, 1 for live streams
+
+  bool frameThreads;
+  bool sliceThreads;
+  int threads; // 0 to derive from the cpu count
+  bool lowdelay;
+};
+
 typedef std::vector<TVShowRegexp> SETTINGS_TVSHOWLIST;
 
 class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
@@ -166,6 +179,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_videoAutoScaleMaxFps;
     std::vector<RefreshOverride> m_videoAdjustRefreshOverrides;
     std::vector<RefreshVideoLatency> m_videoRefreshLatency;
+    std::vector<VideoDecoderThreading> m_videoDecoderThreading;
     float m_videoDefaultLatency;
     int  m_videoCaptureUseOcclusionQuery;
     bool m_DXVACheckCompatibility;
@@ -288,6 +302,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlKeepAliveInterval;    // seconds
     bool m_curlDisableIPV6;
     bool m_curlDisableHTTP2;
+    int m_curlMaxHostConnections;   // cache source and range readers per host, 0 for no limit
 
     std::string m_caTrustFile;
 
@@ -310,6 +325,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_showAllDependencies;
 
     bool m_bVirtualShares;
+    bool m_bPersistentDirectoryCache; // library scans reuse listings of unchanged directories
+    int m_libraryScanThreads;         // folders listed ahead of library scans, 0 to list while scanning
+    int m_libraryScanHostConnections; // concurrent listings per host during library scans
     bool m_bTry10bitOutput;
 
     std::string m_cpuTempCmd;
@@ -323,6 +341,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in msecs after that a channel switch occurs after entering a channel number, if confirmchannelswitch is disabled */
     int m_iPVRTimeshiftThreshold; /*!< @brief time diff between current playing time and timeshift buffer end, in seconds, before a playing stream is displayed as timeshifting. */
     bool m_bPVRTimeshiftSimpleOSD; /*!< @brief use simple timeshift OSD (with progress only for the playing event instead of progress for the whole ts buffer). */
+    int m_iPVRPreloadChannels; /*!< @brief number of channels next to the playing one to keep opened for a fast channel switch. defaults to 0 (disabled). */
     SortDescription m_PVRDefaultSortOrder; /*!< @brief SortDecription used to store default recording sort type and sort order */
 
     DatabaseSettings m_databaseMusic; // advanced music database setup
@@ -341,6 +360,13 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_cacheBufferMode;
     unsigned int m_cacheChunkSize;
     float m_cacheReadFactor;
+    bool m_cacheAdaptiveReadAhead; ///< adapt read-ahead and fill rate to each stream, readfactor is the base
+    unsigned int m_cacheParallelReaders;
+    unsigned int m_cacheParallelSegmentSize;
+    unsigned int m_cachePersistentSize; ///< size limit of the persistent block cache in MiB, 0 disables it
+    unsigned int m_cacheReadQueueDepth; ///< local reads kept in flight by the async read engine
+    unsigned int m_cacheReadThreads; ///< threads of the async read engine without io_uring
+    bool m_cacheReadIoUring;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -359,6 +359,7 @@ constexpr const char* CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT_STEREOUPMIX;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT_MAINTAINORIGINALVOLUME;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT_PROCESSQUALITY;
+constexpr const char* CSettings::SETTING_AUDIOOUTPUT_RESAMPLER;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE;
 constexpr const char* CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE;
@@ -359,6 +359,7 @@ public:
   static constexpr auto SETTING_AUDIOOUTPUT_MAINTAINORIGINALVOLUME =
       "audiooutput.maintainoriginalvolume";
   static constexpr auto SETTING_AUDIOOUTPUT_PROCESSQUALITY = "audiooutput.processquality";
+  static constexpr auto SETTING_AUDIOOUTPUT_RESAMPLER = "audiooutput.resampler";
   static constexpr auto SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD = "audiooutput.atempothreshold";
   static constexpr auto SETTING_AUDIOOUTPUT_STREAMSILENCE = "audiooutput.streamsilence";
   static constexpr auto SETTING_AUDIOOUTPUT_STREAMNOISE = "audiooutput.streamnoise";
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+/*!
+ \brief Bounded ring passing items from one thread to another without locking
+
+ Push() may only be called by one thread at a time and Front()/Pop() by one
+ other thread at a time. Each side only writes its own index, so neither ever
+ waits for the other. Size() and Empty() are snapshots and may be called from
+ anywhere.
+ */
+template<typename T>
+class CSPSCQueue
+{
+public:
+  /*!
+   \param capacity number of items the ring holds, rounded up to a power of two
+   */
+  explicit CSPSCQueue(size_t capacity) : m_items(RoundUp(capacity)), m_mask(m_items.size() - 1)
+  {
+  }
+
+  CSPSCQueue(const CSPSCQueue&) = delete;
+  CSPSCQueue& operator=(const CSPSCQueue&) = delete;
+
+  /*!
+   \brief Producer side, add an item
+   \return false if the ring is full, the item is left untouched then
+   */
+  bool Push(T&& item)
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead > m_mask)
+    {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+      if (tail - m_cachedHead > m_mask)
+        return false;
+    }
+
+    m_items[tail & m_mask] = std::move(item);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   \brief Consumer side, the oldest item
+   \return nullptr if the ring is empty
+   */
+  T* Front()
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail)
+    {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cachedTail)
+        return nullptr;
+    }
+
+    return &m_items[head & m_mask];
+  }
+
+  /*!
+   \brief Consumer side, remove the item returned by Front()
+   */
+  void Pop()
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    m_items[head & m_mask] = T();
+    m_head.store(head + 1, std::memory_order_release);
+  }
+
+  size_t Size() const
+  {
+    return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+  }
+
+  bool Empty() const { return Size() == 0; }
+  size_t Capacity() const { return m_items.size(); }
+
+private:
+  static size_t RoundUp(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+    return size;
+  }
+
+  // keep the indices written by the two threads on separate cache lines
+  static constexpr size_t CACHE_LINE = 64;
+
+  std::vector<T> m_items;
+  const size_t m_mask;
+
+  char m_pad0[CACHE_LINE];
+  std::atomic<size_t> m_head{0};
+  size_t m_cachedTail = 0; // consumer's last look at m_tail
+  char m_pad1[CACHE_LINE];
+  std::atomic<size_t> m_tail{0};
+  size_t m_cachedHead = 0; // producer's last look at m_head
+  char m_pad2[CACHE_LINE];
+};
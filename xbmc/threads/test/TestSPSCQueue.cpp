@@ -0,0 +1,194 @@
+/*
+ *  Copyright (C) 2005-2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/SPSCQueue.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// queue under test for the latency measurement, either the ring or the list it replaces
+class CLockedList
+{
+public:
+  bool Push(Clock::time_point&& item)
+  {
+    CSingleLock lock(m_section);
+    m_items.push_front(item);
+    return true;
+  }
+
+  bool Pop(Clock::time_point& item)
+  {
+    CSingleLock lock(m_section);
+    if (m_items.empty())
+      return false;
+    item = m_items.back();
+    m_items.pop_back();
+    return true;
+  }
+
+private:
+  CCriticalSection m_section;
+  std::list<Clock::time_point> m_items;
+};
+
+class CRing
+{
+public:
+  bool Push(Clock::time_point&& item) { return m_ring.Push(std::move(item)); }
+
+  bool Pop(Clock::time_point& item)
+  {
+    Clock::time_point* front = m_ring.Front();
+    if (!front)
+      return false;
+    item = *front;
+    m_ring.Pop();
+    return true;
+  }
+
+private:
+  CSPSCQueue<Clock::time_point> m_ring{2048};
+};
+
+template<typename Queue>
+void MeasureLatency(const char* name)
+{
+  const int count = 200000;
+  // keep the queue close to empty so both threads work on it all the time, as demuxer and decoder do
+  const int inFlight = 4;
+  Queue queue;
+  std::atomic<int> taken{0};
+  std::vector<int64_t> latencies;
+  latencies.reserve(count);
+
+  std::thread producer([&queue, &taken]() {
+    for (int i = 0; i < count; i++)
+    {
+      while (i - taken >= inFlight)
+        std::this_thread::yield();
+      queue.Push(Clock::now());
+    }
+  });
+
+  while (latencies.size() < static_cast<size_t>(count))
+  {
+    Clock::time_point put;
+    if (queue.Pop(put))
+    {
+      latencies.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - put).count());
+      taken++;
+    }
+    else
+      std::this_thread::yield();
+  }
+  producer.join();
+
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << name << ": put/get latency p50 " << latencies[count / 2] << " ns, p99 "
+            << latencies[count * 99 / 100] << " ns, p99.9 " << latencies[count * 999 / 1000]
+            << " ns, max " << latencies.back() << " ns" << std::endl;
+}
+
+} // namespace
+
+TEST(TestSPSCQueue, Capacity)
+{
+  CSPSCQueue<int> queue(5);
+  EXPECT_EQ(8u, queue.Capacity());
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(nullptr, queue.Front());
+
+  for (int i = 0; i < 8; i++)
+    EXPECT_TRUE(queue.Push(std::move(i)));
+  int last = 8;
+  EXPECT_FALSE(queue.Push(std::move(last)));
+  EXPECT_EQ(8u, queue.Size());
+
+  for (int i = 0; i < 8; i++)
+  {
+    ASSERT_NE(nullptr, queue.Front());
+    EXPECT_EQ(i, *queue.Front());
+    queue.Pop();
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(TestSPSCQueue, ReleasesPopped)
+{
+  CSPSCQueue<std::shared_ptr<int>> queue(4);
+  std::shared_ptr<int> item = std::make_shared<int>(1);
+  std::weak_ptr<int> weak = item;
+
+  EXPECT_TRUE(queue.Push(std::move(item)));
+  queue.Pop();
+  EXPECT_TRUE(weak.expired());
+}
+
+TEST(TestSPSCQueue, TwoThreads)
+{
+  const int count = 100000;
+  CSPSCQueue<int> queue(64);
+
+  std::thread producer([&queue]() {
+    for (int i = 0; i < count; i++)
+    {
+      int item = i;
+      while (!queue.Push(std::move(item)))
+        std::this_thread::yield();
+    }
+  });
+
+  // keep taking items after a mismatch, the producer only finishes once all are taken
+  int expected = 0;
+  int mismatch = -1;
+  int mismatchItem = 0;
+  while (expected < count)
+  {
+    int* item = queue.Front();
+    if (!item)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    if (*item != expected && mismatch < 0)
+    {
+      mismatch = expected;
+      mismatchItem = *item;
+    }
+    queue.Pop();
+    expected++;
+  }
+  producer.join();
+
+  EXPECT_EQ(-1, mismatch) << "got " << mismatchItem;
+  EXPECT_TRUE(queue.Empty());
+}
+
+// benchmark, run with --gtest_also_run_disabled_tests
+TEST(TestSPSCQueue, DISABLED_Latency)
+{
+  MeasureLatency<CLockedList>("locked list");
+  MeasureLatency<CRing>("spsc ring");
+}
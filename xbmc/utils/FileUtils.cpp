@@ -192,7 +192,7 @@ CDateTime CFileUtils::GetModificationDate(const int& code, const std::string& st
 
     // Try to get ctime (creation on Windows, metadata change on Linux) and mtime (modification)
     struct __stat64 buffer;
-    if (CFile::Stat(file, &buffer) == 0 && (buffer.st_mtime != 0 || buffer.st_ctime != 0))
+    if (CFile::Stat(file, &buffer, true) == 0 && (buffer.st_mtime != 0 || buffer.st_ctime != 0))
     {
       time_t now = time(NULL);
       time_t addedTime;
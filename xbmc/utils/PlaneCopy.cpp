@@ -0,0 +1,837 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PlaneCopy.h"
+
+#include "ServiceBroker.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <string.h>
+
+#if defined(HAVE_SSE2) && (defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define HAS_PLANECOPY_SSE2
+// the SSE4.1 and AVX2 kernels are built for the cpus that have them, the rest of kodi isn't
+#if defined(__GNUC__)
+#define HAS_PLANECOPY_SSE4
+#define HAS_PLANECOPY_AVX2
+#define TARGET_SSE4 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER)
+#define HAS_PLANECOPY_SSE4
+#define HAS_PLANECOPY_AVX2
+#define TARGET_SSE4
+#define TARGET_AVX2
+#endif
+#endif
+
+#if (defined(__arm__) && defined(HAS_NEON)) || defined(__aarch64__)
+#include <arm_neon.h>
+#define HAS_PLANECOPY_NEON
+#endif
+
+namespace
+{
+// smaller planes are likely read from the cache again, e.g. by glTexSubImage
+constexpr size_t MIN_STREAMING_SIZE = 1024 * 1024;
+
+// uncached rows are read through a block of this size, it stays in the first level cache
+constexpr size_t UNCACHED_BLOCK_SIZE = 4096;
+
+using InterleaveRow = void (*)(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width);
+using DeinterleaveRow = void (*)(uint8_t* u, uint8_t* v, const uint8_t* src, int width);
+using PackRow = void (*)(uint16_t* dst, const uint16_t* src, int width, int shift);
+using InterleaveRow16 =
+    void (*)(uint16_t* dst, const uint16_t* u, const uint16_t* v, int width, int shift);
+
+void CopyRowsC(
+    uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, size_t width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    memcpy(dst, src, width);
+    dst += dstStride;
+    src += srcStride;
+  }
+}
+
+void InterleaveRowC(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width)
+{
+  for (int x = 0; x < width; x++)
+  {
+    dst[2 * x] = u[x];
+    dst[2 * x + 1] = v[x];
+  }
+}
+
+void DeinterleaveRowC(uint8_t* u, uint8_t* v, const uint8_t* src, int width)
+{
+  for (int x = 0; x < width; x++)
+  {
+    u[x] = src[2 * x];
+    v[x] = src[2 * x + 1];
+  }
+}
+
+void PackRowC(uint16_t* dst, const uint16_t* src, int width, int shift)
+{
+  for (int x = 0; x < width; x++)
+    dst[x] = static_cast<uint16_t>(src[x] << shift);
+}
+
+void InterleaveRow16C(uint16_t* dst, const uint16_t* u, const uint16_t* v, int width, int shift)
+{
+  for (int x = 0; x < width; x++)
+  {
+    dst[2 * x] = static_cast<uint16_t>(u[x] << shift);
+    dst[2 * x + 1] = static_cast<uint16_t>(v[x] << shift);
+  }
+}
+
+#if defined(HAS_PLANECOPY_SSE2)
+void CopyRowSSE2(uint8_t* dst, const uint8_t* src, size_t size)
+{
+  // the stores have to be aligned, the loads don't
+  size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+  if (head > size)
+    head = size;
+  memcpy(dst, src, head);
+  dst += head;
+  src += head;
+  size -= head;
+
+  for (; size >= 64; size -= 64, dst += 64, src += 64)
+  {
+    const __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    const __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+    const __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst), x0);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), x1);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), x2);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), x3);
+  }
+
+  for (; size >= 16; size -= 16, dst += 16, src += 16)
+  {
+    const __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst), x0);
+  }
+
+  memcpy(dst, src, size);
+}
+
+void CopyRowsSSE2(
+    uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, size_t width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    CopyRowSSE2(dst, src, width);
+    dst += dstStride;
+    src += srcStride;
+  }
+
+  // the streaming stores are weakly ordered, have them done before the buffer is handed on
+  _mm_sfence();
+}
+
+void InterleaveRowSSE2(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + x));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * x), _mm_unpacklo_epi8(a, b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * x + 16), _mm_unpackhi_epi8(a, b));
+  }
+  InterleaveRowC(dst + 2 * x, u + x, v + x, width - x);
+}
+
+void DeinterleaveRowSSE2(uint8_t* u, uint8_t* v, const uint8_t* src, int width)
+{
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * x));
+    const __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * x + 16));
+    const __m128i a = _mm_packus_epi16(_mm_and_si128(s0, mask), _mm_and_si128(s1, mask));
+    const __m128i b = _mm_packus_epi16(_mm_srli_epi16(s0, 8), _mm_srli_epi16(s1, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(v + x), b);
+  }
+  DeinterleaveRowC(u + x, v + x, src + 2 * x, width - x);
+}
+
+void PackRowSSE2(uint16_t* dst, const uint16_t* src, int width, int shift)
+{
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x + 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_sll_epi16(a, count));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 8), _mm_sll_epi16(b, count));
+  }
+  PackRowC(dst + x, src + x, width - x, shift);
+}
+
+void InterleaveRow16SSE2(uint16_t* dst, const uint16_t* u, const uint16_t* v, int width, int shift)
+{
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const __m128i a =
+        _mm_sll_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x)), count);
+    const __m128i b =
+        _mm_sll_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(v + x)), count);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * x), _mm_unpacklo_epi16(a, b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * x + 8), _mm_unpackhi_epi16(a, b));
+  }
+  InterleaveRow16C(dst + 2 * x, u + x, v + x, width - x, shift);
+}
+#endif
+
+#if defined(HAS_PLANECOPY_SSE4)
+/*
+ * Copies from write combined memory through a cached block, as described in
+ * https://software.intel.com/en-us/articles/copying-accelerated-video-decode-frame-buffers
+ * The streaming loads read whole aligned 16 byte blocks, which can't cross a page, the
+ * bytes around the row are loaded into the block but not copied.
+ */
+TARGET_SSE4 void CopyUncachedRowsSSE4(
+    uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, size_t width, int height)
+{
+  alignas(64) uint8_t block[UNCACHED_BLOCK_SIZE];
+  const size_t maxChunk = UNCACHED_BLOCK_SIZE - 32;
+
+  for (int y = 0; y < height; y++)
+  {
+    for (size_t x = 0; x < width; x += maxChunk)
+    {
+      const size_t chunk = std::min(maxChunk, width - x);
+      const uint8_t* start = src + x;
+      const size_t offset = reinterpret_cast<uintptr_t>(start) & 15;
+      const __m128i* load = reinterpret_cast<const __m128i*>(start - offset);
+      __m128i* cache = reinterpret_cast<__m128i*>(block);
+      size_t blocks = (offset + chunk + 15) / 16;
+
+      _mm_mfence();
+
+      for (; blocks >= 4; blocks -= 4, load += 4, cache += 4)
+      {
+        const __m128i x0 = _mm_stream_load_si128(const_cast<__m128i*>(load));
+        const __m128i x1 = _mm_stream_load_si128(const_cast<__m128i*>(load + 1));
+        const __m128i x2 = _mm_stream_load_si128(const_cast<__m128i*>(load + 2));
+        const __m128i x3 = _mm_stream_load_si128(const_cast<__m128i*>(load + 3));
+        _mm_store_si128(cache, x0);
+        _mm_store_si128(cache + 1, x1);
+        _mm_store_si128(cache + 2, x2);
+        _mm_store_si128(cache + 3, x3);
+      }
+      for (; blocks > 0; blocks--, load++, cache++)
+        _mm_store_si128(cache, _mm_stream_load_si128(const_cast<__m128i*>(load)));
+
+      memcpy(dst + x, block + offset, chunk);
+    }
+    dst += dstStride;
+    src += srcStride;
+  }
+}
+
+TARGET_SSE4 void DeinterleaveRowSSE4(uint8_t* u, uint8_t* v, const uint8_t* src, int width)
+{
+  // even bytes to the low half, odd bytes to the high half
+  const __m128i shuffle = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i s0 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * x)), shuffle);
+    const __m128i s1 = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * x + 16)), shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x), _mm_unpacklo_epi64(s0, s1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(v + x), _mm_unpackhi_epi64(s0, s1));
+  }
+  DeinterleaveRowC(u + x, v + x, src + 2 * x, width - x);
+}
+#endif
+
+#if defined(HAS_PLANECOPY_AVX2)
+TARGET_AVX2 void CopyRowAVX2(uint8_t* dst, const uint8_t* src, size_t size)
+{
+  size_t head = (32 - (reinterpret_cast<uintptr_t>(dst) & 31)) & 31;
+  if (head > size)
+    head = size;
+  memcpy(dst, src, head);
+  dst += head;
+  src += head;
+  size -= head;
+
+  for (; size >= 128; size -= 128, dst += 128, src += 128)
+  {
+    const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+    const __m256i x2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+    const __m256i x3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), x0);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), x1);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), x2);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), x3);
+  }
+
+  for (; size >= 32; size -= 32, dst += 32, src += 32)
+  {
+    const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), x0);
+  }
+
+  memcpy(dst, src, size);
+}
+
+TARGET_AVX2 void CopyRowsAVX2(
+    uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, size_t width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    CopyRowAVX2(dst, src, width);
+    dst += dstStride;
+    src += srcStride;
+  }
+
+  _mm_sfence();
+}
+
+// the unpacks work within the 128 bit lanes, the permutes put the lanes in order
+TARGET_AVX2 void InterleaveRowAVX2(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width)
+{
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(u + x));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + x));
+    const __m256i lo = _mm256_unpacklo_epi8(a, b);
+    const __m256i hi = _mm256_unpackhi_epi8(a, b);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * x),
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * x + 32),
+                        _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  InterleaveRowSSE2(dst + 2 * x, u + x, v + x, width - x);
+}
+
+TARGET_AVX2 void DeinterleaveRowAVX2(uint8_t* u, uint8_t* v, const uint8_t* src, int width)
+{
+  const __m256i mask = _mm256_set1_epi16(0x00FF);
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    const __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 2 * x));
+    const __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 2 * x + 32));
+    const __m256i a =
+        _mm256_packus_epi16(_mm256_and_si256(s0, mask), _mm256_and_si256(s1, mask));
+    const __m256i b = _mm256_packus_epi16(_mm256_srli_epi16(s0, 8), _mm256_srli_epi16(s1, 8));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(u + x), _mm256_permute4x64_epi64(a, 0xD8));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + x), _mm256_permute4x64_epi64(b, 0xD8));
+  }
+  DeinterleaveRowSSE2(u + x, v + x, src + 2 * x, width - x);
+}
+
+TARGET_AVX2 void PackRowAVX2(uint16_t* dst, const uint16_t* src, int width, int shift)
+{
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x + 16));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_sll_epi16(a, count));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x + 16), _mm256_sll_epi16(b, count));
+  }
+  PackRowSSE2(dst + x, src + x, width - x, shift);
+}
+
+TARGET_AVX2 void InterleaveRow16AVX2(
+    uint16_t* dst, const uint16_t* u, const uint16_t* v, int width, int shift)
+{
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m256i a =
+        _mm256_sll_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(u + x)), count);
+    const __m256i b =
+        _mm256_sll_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + x)), count);
+    const __m256i lo = _mm256_unpacklo_epi16(a, b);
+    const __m256i hi = _mm256_unpackhi_epi16(a, b);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * x),
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * x + 16),
+                        _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  InterleaveRow16SSE2(dst + 2 * x, u + x, v + x, width - x, shift);
+}
+#endif
+
+#if defined(HAS_PLANECOPY_NEON)
+// arm has no streaming stores, this only saves the calls of memcpy for each row
+void CopyRowsNEON(
+    uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, size_t width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    size_t x = 0;
+    for (; x + 64 <= width; x += 64)
+    {
+      const uint8x16_t x0 = vld1q_u8(src + x);
+      const uint8x16_t x1 = vld1q_u8(src + x + 16);
+      const uint8x16_t x2 = vld1q_u8(src + x + 32);
+      const uint8x16_t x3 = vld1q_u8(src + x + 48);
+      vst1q_u8(dst + x, x0);
+      vst1q_u8(dst + x + 16, x1);
+      vst1q_u8(dst + x + 32, x2);
+      vst1q_u8(dst + x + 48, x3);
+    }
+    for (; x + 16 <= width; x += 16)
+      vst1q_u8(dst + x, vld1q_u8(src + x));
+    memcpy(dst + x, src + x, width - x);
+
+    dst += dstStride;
+    src += srcStride;
+  }
+}
+
+void InterleaveRowNEON(uint8_t* dst, const uint8_t* u, const uint8_t* v, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    uint8x16x2_t uv;
+    uv.val[0] = vld1q_u8(u + x);
+    uv.val[1] = vld1q_u8(v + x);
+    vst2q_u8(dst + 2 * x, uv);
+  }
+  InterleaveRowC(dst + 2 * x, u + x, v + x, width - x);
+}
+
+void DeinterleaveRowNEON(uint8_t* u, uint8_t* v, const uint8_t* src, int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const uint8x16x2_t uv = vld2q_u8(src + 2 * x);
+    vst1q_u8(u + x, uv.val[0]);
+    vst1q_u8(v + x, uv.val[1]);
+  }
+  DeinterleaveRowC(u + x, v + x, src + 2 * x, width - x);
+}
+
+void PackRowNEON(uint16_t* dst, const uint16_t* src, int width, int shift)
+{
+  const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(shift));
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    vst1q_u16(dst + x, vshlq_u16(vld1q_u16(src + x), count));
+    vst1q_u16(dst + x + 8, vshlq_u16(vld1q_u16(src + x + 8), count));
+  }
+  PackRowC(dst + x, src + x, width - x, shift);
+}
+
+void InterleaveRow16NEON(uint16_t* dst, const uint16_t* u, const uint16_t* v, int width, int shift)
+{
+  const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(shift));
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    uint16x8x2_t uv;
+    uv.val[0] = vshlq_u16(vld1q_u16(u + x), count);
+    uv.val[1] = vshlq_u16(vld1q_u16(v + x), count);
+    vst2q_u16(dst + 2 * x, uv);
+  }
+  InterleaveRow16C(dst + 2 * x, u + x, v + x, width - x, shift);
+}
+#endif
+
+InterleaveRow GetInterleaveRow(CPlaneCopy::Kernel kernel)
+{
+  switch (kernel)
+  {
+#if defined(HAS_PLANECOPY_AVX2)
+    case CPlaneCopy::Kernel::AVX2:
+      return InterleaveRowAVX2;
+#endif
+#if defined(HAS_PLANECOPY_SSE2)
+    case CPlaneCopy::Kernel::SSE2:
+    case CPlaneCopy::Kernel::SSE4:
+      return InterleaveRowSSE2;
+#endif
+#if defined(HAS_PLANECOPY_NEON)
+    case CPlaneCopy::Kernel::NEON:
+      return InterleaveRowNEON;
+#endif
+    default:
+      return InterleaveRowC;
+  }
+}
+
+DeinterleaveRow GetDeinterleaveRow(CPlaneCopy::Kernel kernel)
+{
+  switch (kernel)
+  {
+#if defined(HAS_PLANECOPY_AVX2)
+    case CPlaneCopy::Kernel::AVX2:
+      return DeinterleaveRowAVX2;
+#endif
+#if defined(HAS_PLANECOPY_SSE4)
+    case CPlaneCopy::Kernel::SSE4:
+      return DeinterleaveRowSSE4;
+#endif
+#if defined(HAS_PLANECOPY_SSE2)
+    case CPlaneCopy::Kernel::SSE2:
+      return DeinterleaveRowSSE2;
+#endif
+#if defined(HAS_PLANECOPY_NEON)
+    case CPlaneCopy::Kernel::NEON:
+      return DeinterleaveRowNEON;
+#endif
+    default:
+      return DeinterleaveRowC;
+  }
+}
+
+PackRow GetPackRow(CPlaneCopy::Kernel kernel)
+{
+  switch (kernel)
+  {
+#if defined(HAS_PLANECOPY_AVX2)
+    case CPlaneCopy::Kernel::AVX2:
+      return PackRowAVX2;
+#endif
+#if defined(HAS_PLANECOPY_SSE2)
+    case CPlaneCopy::Kernel::SSE2:
+    case CPlaneCopy::Kernel::SSE4:
+      return PackRowSSE2;
+#endif
+#if defined(HAS_PLANECOPY_NEON)
+    case CPlaneCopy::Kernel::NEON:
+      return PackRowNEON;
+#endif
+    default:
+      return PackRowC;
+  }
+}
+
+InterleaveRow16 GetInterleaveRow16(CPlaneCopy::Kernel kernel)
+{
+  switch (kernel)
+  {
+#if defined(HAS_PLANECOPY_AVX2)
+    case CPlaneCopy::Kernel::AVX2:
+      return InterleaveRow16AVX2;
+#endif
+#if defined(HAS_PLANECOPY_SSE2)
+    case CPlaneCopy::Kernel::SSE2:
+    case CPlaneCopy::Kernel::SSE4:
+      return InterleaveRow16SSE2;
+#endif
+#if defined(HAS_PLANECOPY_NEON)
+    case CPlaneCopy::Kernel::NEON:
+      return InterleaveRow16NEON;
+#endif
+    default:
+      return InterleaveRow16C;
+  }
+}
+} // namespace
+
+void CPlaneCopy::Copy(
+    uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  Kernel kernel = GetKernel();
+  if (static_cast<size_t>(width) * height < MIN_STREAMING_SIZE)
+    kernel = Kernel::C;
+
+  Copy(kernel, dst, dstStride, src, srcStride, width, height);
+}
+
+void CPlaneCopy::Copy(Kernel kernel,
+                      uint8_t* dst,
+                      int dstStride,
+                      const uint8_t* src,
+                      int srcStride,
+                      int width,
+                      int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  size_t size = width;
+  // planes without padding are copied in one go
+  if (dstStride == width && srcStride == width)
+  {
+    size *= height;
+    height = 1;
+  }
+
+  switch (kernel)
+  {
+#if defined(HAS_PLANECOPY_AVX2)
+    case Kernel::AVX2:
+      CopyRowsAVX2(dst, dstStride, src, srcStride, size, height);
+      break;
+#endif
+#if defined(HAS_PLANECOPY_SSE2)
+    case Kernel::SSE2:
+    case Kernel::SSE4:
+      CopyRowsSSE2(dst, dstStride, src, srcStride, size, height);
+      break;
+#endif
+#if defined(HAS_PLANECOPY_NEON)
+    case Kernel::NEON:
+      CopyRowsNEON(dst, dstStride, src, srcStride, size, height);
+      break;
+#endif
+    default:
+      CopyRowsC(dst, dstStride, src, srcStride, size, height);
+      break;
+  }
+}
+
+void CPlaneCopy::CopyUncached(
+    uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height)
+{
+  CopyUncached(GetKernel(), dst, dstStride, src, srcStride, width, height);
+}
+
+void CPlaneCopy::CopyUncached(Kernel kernel,
+                              uint8_t* dst,
+                              int dstStride,
+                              const uint8_t* src,
+                              int srcStride,
+                              int width,
+                              int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  switch (kernel)
+  {
+#if defined(HAS_PLANECOPY_SSE4)
+    case Kernel::SSE4:
+    case Kernel::AVX2:
+      CopyUncachedRowsSSE4(dst, dstStride, src, srcStride, width, height);
+      break;
+#endif
+    default:
+      Copy(kernel, dst, dstStride, src, srcStride, width, height);
+      break;
+  }
+}
+
+void CPlaneCopy::InterleaveUV(uint8_t* dst,
+                              int dstStride,
+                              const uint8_t* srcU,
+                              int srcStrideU,
+                              const uint8_t* srcV,
+                              int srcStrideV,
+                              int width,
+                              int height)
+{
+  InterleaveUV(GetKernel(), dst, dstStride, srcU, srcStrideU, srcV, srcStrideV, width, height);
+}
+
+void CPlaneCopy::InterleaveUV(Kernel kernel,
+                              uint8_t* dst,
+                              int dstStride,
+                              const uint8_t* srcU,
+                              int srcStrideU,
+                              const uint8_t* srcV,
+                              int srcStrideV,
+                              int width,
+                              int height)
+{
+  const InterleaveRow row = GetInterleaveRow(kernel);
+  for (int y = 0; y < height; y++)
+  {
+    row(dst, srcU, srcV, width);
+    dst += dstStride;
+    srcU += srcStrideU;
+    srcV += srcStrideV;
+  }
+}
+
+void CPlaneCopy::DeinterleaveUV(uint8_t* dstU,
+                                int dstStrideU,
+                                uint8_t* dstV,
+                                int dstStrideV,
+                                const uint8_t* src,
+                                int srcStride,
+                                int width,
+                                int height)
+{
+  DeinterleaveUV(GetKernel(), dstU, dstStrideU, dstV, dstStrideV, src, srcStride, width, height);
+}
+
+void CPlaneCopy::DeinterleaveUV(Kernel kernel,
+                                uint8_t* dstU,
+                                int dstStrideU,
+                                uint8_t* dstV,
+                                int dstStrideV,
+                                const uint8_t* src,
+                                int srcStride,
+                                int width,
+                                int height)
+{
+  const DeinterleaveRow row = GetDeinterleaveRow(kernel);
+  for (int y = 0; y < height; y++)
+  {
+    row(dstU, dstV, src, width);
+    dstU += dstStrideU;
+    dstV += dstStrideV;
+    src += srcStride;
+  }
+}
+
+void CPlaneCopy::PackP010(uint8_t* dst,
+                          int dstStride,
+                          const uint8_t* src,
+                          int srcStride,
+                          int width,
+                          int height,
+                          int bits)
+{
+  PackP010(GetKernel(), dst, dstStride, src, srcStride, width, height, bits);
+}
+
+void CPlaneCopy::PackP010(Kernel kernel,
+                          uint8_t* dst,
+                          int dstStride,
+                          const uint8_t* src,
+                          int srcStride,
+                          int width,
+                          int height,
+                          int bits)
+{
+  const PackRow row = GetPackRow(kernel);
+  for (int y = 0; y < height; y++)
+  {
+    row(reinterpret_cast<uint16_t*>(dst), reinterpret_cast<const uint16_t*>(src), width,
+        16 - bits);
+    dst += dstStride;
+    src += srcStride;
+  }
+}
+
+void CPlaneCopy::InterleaveP010(uint8_t* dst,
+                                int dstStride,
+                                const uint8_t* srcU,
+                                int srcStrideU,
+                                const uint8_t* srcV,
+                                int srcStrideV,
+                                int width,
+                                int height,
+                                int bits)
+{
+  InterleaveP010(GetKernel(), dst, dstStride, srcU, srcStrideU, srcV, srcStrideV, width, height,
+                 bits);
+}
+
+void CPlaneCopy::InterleaveP010(Kernel kernel,
+                                uint8_t* dst,
+                                int dstStride,
+                                const uint8_t* srcU,
+                                int srcStrideU,
+                                const uint8_t* srcV,
+                                int srcStrideV,
+                                int width,
+                                int height,
+                                int bits)
+{
+  const InterleaveRow16 row = GetInterleaveRow16(kernel);
+  for (int y = 0; y < height; y++)
+  {
+    row(reinterpret_cast<uint16_t*>(dst), reinterpret_cast<const uint16_t*>(srcU),
+        reinterpret_cast<const uint16_t*>(srcV), width, 16 - bits);
+    dst += dstStride;
+    srcU += srcStrideU;
+    srcV += srcStrideV;
+  }
+}
+
+bool CPlaneCopy::Supports(Kernel kernel)
+{
+  const auto cpuInfo = CServiceBroker::GetCPUInfo();
+  const unsigned int features = cpuInfo ? cpuInfo->GetCPUFeatures() : 0;
+  (void)features;
+
+  switch (kernel)
+  {
+    case Kernel::C:
+      return true;
+#if defined(HAS_PLANECOPY_SSE2)
+    case Kernel::SSE2:
+      return (features & CPU_FEATURE_SSE2) != 0;
+#endif
+#if defined(HAS_PLANECOPY_SSE4)
+    case Kernel::SSE4:
+      return (features & CPU_FEATURE_SSE4) != 0;
+#endif
+#if defined(HAS_PLANECOPY_AVX2)
+    case Kernel::AVX2:
+      return (features & CPU_FEATURE_AVX2) != 0;
+#endif
+#if defined(HAS_PLANECOPY_NEON)
+    case Kernel::NEON:
+#if defined(__aarch64__)
+      return true;
+#else
+      return (features & CPU_FEATURE_NEON) != 0;
+#endif
+#endif
+    default:
+      return false;
+  }
+}
+
+CPlaneCopy::Kernel CPlaneCopy::GetKernel()
+{
+  static const Kernel kernel = []() {
+    for (Kernel candidate : {Kernel::AVX2, Kernel::SSE4, Kernel::SSE2, Kernel::NEON})
+    {
+      if (Supports(candidate))
+        return candidate;
+    }
+    return Kernel::C;
+  }();
+  return kernel;
+}
+
+const char* CPlaneCopy::GetName(Kernel kernel)
+{
+  switch (kernel)
+  {
+    case Kernel::SSE2:
+      return "sse2";
+    case Kernel::SSE4:
+      return "sse4.1";
+    case Kernel::AVX2:
+      return "avx2";
+    case Kernel::NEON:
+      return "neon";
+    default:
+      return "c";
+  }
+}
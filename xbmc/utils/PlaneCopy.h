@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*!
+ \brief Copies and converts the planes of video frames, e.g. into the upload buffers of the
+ renderer
+
+ Large planes are copied with streaming stores that bypass the cache: the
+ destination usually is a mapped pixel buffer, which is write combined, and a
+ 4K frame doesn't fit the cache anyway. The kernel is picked once for the cpu,
+ planes smaller than the cache are left to memcpy.
+
+ The conversions between planar and semi-planar chroma, and to the msb aligned
+ samples of P010, always run on the kernel of the cpu.
+ */
+class CPlaneCopy
+{
+public:
+  enum class Kernel
+  {
+    C,
+    SSE2,
+    SSE4,
+    AVX2,
+    NEON
+  };
+
+  /*!
+   \brief Copy height rows of width bytes
+   */
+  static void Copy(
+      uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height);
+
+  /*!
+   \brief Copy with the given kernel, regardless of the plane size
+   \note the kernel has to be supported by the cpu
+   */
+  static void Copy(Kernel kernel,
+                   uint8_t* dst,
+                   int dstStride,
+                   const uint8_t* src,
+                   int srcStride,
+                   int width,
+                   int height);
+
+  /*!
+   \brief Copy height rows of width bytes from uncached memory, e.g. a mapped decoder surface
+
+   Reads of write combined memory are only fast with the streaming loads of
+   SSE4.1, the rows are read through a small cached block. Other kernels copy
+   as usual.
+   */
+  static void CopyUncached(
+      uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int width, int height);
+  static void CopyUncached(Kernel kernel,
+                           uint8_t* dst,
+                           int dstStride,
+                           const uint8_t* src,
+                           int srcStride,
+                           int width,
+                           int height);
+
+  /*!
+   \brief Interleave U and V planes into the UV plane of NV12
+   \param width samples per row of each of U and V
+   */
+  static void InterleaveUV(uint8_t* dst,
+                           int dstStride,
+                           const uint8_t* srcU,
+                           int srcStrideU,
+                           const uint8_t* srcV,
+                           int srcStrideV,
+                           int width,
+                           int height);
+  static void InterleaveUV(Kernel kernel,
+                           uint8_t* dst,
+                           int dstStride,
+                           const uint8_t* srcU,
+                           int srcStrideU,
+                           const uint8_t* srcV,
+                           int srcStrideV,
+                           int width,
+                           int height);
+
+  /*!
+   \brief Split the UV plane of NV12 into U and V planes
+   \param width samples per row of each of U and V
+   */
+  static void DeinterleaveUV(uint8_t* dstU,
+                             int dstStrideU,
+                             uint8_t* dstV,
+                             int dstStrideV,
+                             const uint8_t* src,
+                             int srcStride,
+                             int width,
+                             int height);
+  static void DeinterleaveUV(Kernel kernel,
+                             uint8_t* dstU,
+                             int dstStrideU,
+                             uint8_t* dstV,
+                             int dstStrideV,
+                             const uint8_t* src,
+                             int srcStride,
+                             int width,
+                             int height);
+
+  /*!
+   \brief Move 16 bit samples of the given depth from the low bits, as ffmpeg stores them, to
+   the high bits, as in the luma plane of P010
+   \param width samples per row
+   */
+  static void PackP010(uint8_t* dst,
+                       int dstStride,
+                       const uint8_t* src,
+                       int srcStride,
+                       int width,
+                       int height,
+                       int bits);
+  static void PackP010(Kernel kernel,
+                       uint8_t* dst,
+                       int dstStride,
+                       const uint8_t* src,
+                       int srcStride,
+                       int width,
+                       int height,
+                       int bits);
+
+  /*!
+   \brief Interleave 16 bit U and V planes into the UV plane of P010, moving the samples to
+   the high bits like PackP010
+   \param width samples per row of each of U and V
+   */
+  static void InterleaveP010(uint8_t* dst,
+                             int dstStride,
+                             const uint8_t* srcU,
+                             int srcStrideU,
+                             const uint8_t* srcV,
+                             int srcStrideV,
+                             int width,
+                             int height,
+                             int bits);
+  static void InterleaveP010(Kernel kernel,
+                             uint8_t* dst,
+                             int dstStride,
+                             const uint8_t* srcU,
+                             int srcStrideU,
+                             const uint8_t* srcV,
+                             int srcStrideV,
+                             int width,
+                             int height,
+                             int bits);
+
+  static bool Supports(Kernel kernel);
+  static Kernel GetKernel();
+  static const char* GetName(Kernel kernel);
+};
@@ -0,0 +1,272 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "utils/CPUInfo.h"
+#include "utils/PlaneCopy.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+const CPlaneCopy::Kernel KERNELS[] = {CPlaneCopy::Kernel::C, CPlaneCopy::Kernel::SSE2,
+                                      CPlaneCopy::Kernel::SSE4, CPlaneCopy::Kernel::AVX2,
+                                      CPlaneCopy::Kernel::NEON};
+
+// width, height, stride of the sources and of the destination, in samples
+const int SIZES[][4] = {{1, 3, 1, 1}, {63, 5, 64, 80}, {200, 7, 200, 200}, {1921, 4, 1984, 1936}};
+
+struct TestPlaneCopy : public ::testing::Test
+{
+  TestPlaneCopy() { CServiceBroker::RegisterCPUInfo(CCPUInfo::GetCPUInfo()); }
+
+  ~TestPlaneCopy() { CServiceBroker::UnregisterCPUInfo(); }
+};
+
+std::vector<uint8_t> Pattern(size_t size, int seed)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<uint8_t>(i * 7 + i / 251 + seed);
+  return data;
+}
+
+// copies a plane between buffers at odd offsets, checks the padding is left alone
+void CheckCopy(CPlaneCopy::Kernel kernel,
+               bool uncached,
+               int width,
+               int height,
+               int srcStride,
+               int dstStride)
+{
+  const std::vector<uint8_t> src = Pattern(srcStride * height + 3, 0);
+
+  std::vector<uint8_t> dst(dstStride * height + 5, 0xAA);
+  if (uncached)
+    CPlaneCopy::CopyUncached(kernel, dst.data() + 5, dstStride, src.data() + 3, srcStride, width,
+                             height);
+  else
+    CPlaneCopy::Copy(kernel, dst.data() + 5, dstStride, src.data() + 3, srcStride, width, height);
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < dstStride; x++)
+    {
+      const uint8_t expected = x < width ? src[3 + y * srcStride + x] : 0xAA;
+      ASSERT_EQ(expected, dst[5 + y * dstStride + x])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+    }
+  }
+}
+
+void CheckInterleave(CPlaneCopy::Kernel kernel, int width, int height, int srcStride, int dstStride)
+{
+  const std::vector<uint8_t> u = Pattern(srcStride * height, 1);
+  const std::vector<uint8_t> v = Pattern(srcStride * height, 2);
+
+  std::vector<uint8_t> dst(dstStride * 2 * height, 0xAA);
+  CPlaneCopy::InterleaveUV(kernel, dst.data(), dstStride * 2, u.data(), srcStride, v.data(),
+                           srcStride, width, height);
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < dstStride; x++)
+    {
+      const uint8_t* out = &dst[y * dstStride * 2 + x * 2];
+      ASSERT_EQ(x < width ? u[y * srcStride + x] : 0xAA, out[0])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+      ASSERT_EQ(x < width ? v[y * srcStride + x] : 0xAA, out[1])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+    }
+  }
+}
+
+void CheckDeinterleave(
+    CPlaneCopy::Kernel kernel, int width, int height, int srcStride, int dstStride)
+{
+  const std::vector<uint8_t> src = Pattern(srcStride * 2 * height, 3);
+
+  std::vector<uint8_t> u(dstStride * height, 0xAA);
+  std::vector<uint8_t> v(dstStride * height, 0xAA);
+  CPlaneCopy::DeinterleaveUV(kernel, u.data(), dstStride, v.data(), dstStride, src.data(),
+                             srcStride * 2, width, height);
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < dstStride; x++)
+    {
+      const uint8_t* in = &src[y * srcStride * 2 + x * 2];
+      ASSERT_EQ(x < width ? in[0] : 0xAA, u[y * dstStride + x])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+      ASSERT_EQ(x < width ? in[1] : 0xAA, v[y * dstStride + x])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+    }
+  }
+}
+
+std::vector<uint16_t> Pattern16(size_t size, int seed, int bits)
+{
+  std::vector<uint16_t> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<uint16_t>((i * 37 + seed) & ((1 << bits) - 1));
+  return data;
+}
+
+void CheckPackP010(
+    CPlaneCopy::Kernel kernel, int width, int height, int srcStride, int dstStride, int bits)
+{
+  const std::vector<uint16_t> src = Pattern16(srcStride * height, 4, bits);
+
+  std::vector<uint16_t> dst(dstStride * height, 0xAAAA);
+  CPlaneCopy::PackP010(kernel, reinterpret_cast<uint8_t*>(dst.data()), dstStride * 2,
+                       reinterpret_cast<const uint8_t*>(src.data()), srcStride * 2, width, height,
+                       bits);
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < dstStride; x++)
+    {
+      const uint16_t expected =
+          x < width ? static_cast<uint16_t>(src[y * srcStride + x] << (16 - bits)) : 0xAAAA;
+      ASSERT_EQ(expected, dst[y * dstStride + x])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+    }
+  }
+}
+
+void CheckInterleaveP010(
+    CPlaneCopy::Kernel kernel, int width, int height, int srcStride, int dstStride, int bits)
+{
+  const std::vector<uint16_t> u = Pattern16(srcStride * height, 5, bits);
+  const std::vector<uint16_t> v = Pattern16(srcStride * height, 6, bits);
+
+  std::vector<uint16_t> dst(dstStride * 2 * height, 0xAAAA);
+  CPlaneCopy::InterleaveP010(kernel, reinterpret_cast<uint8_t*>(dst.data()), dstStride * 4,
+                             reinterpret_cast<const uint8_t*>(u.data()), srcStride * 2,
+                             reinterpret_cast<const uint8_t*>(v.data()), srcStride * 2, width,
+                             height, bits);
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < dstStride; x++)
+    {
+      const uint16_t* out = &dst[y * dstStride * 2 + x * 2];
+      const int shift = 16 - bits;
+      ASSERT_EQ(x < width ? static_cast<uint16_t>(u[y * srcStride + x] << shift) : 0xAAAA, out[0])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+      ASSERT_EQ(x < width ? static_cast<uint16_t>(v[y * srcStride + x] << shift) : 0xAAAA, out[1])
+          << CPlaneCopy::GetName(kernel) << " row " << y << " column " << x;
+    }
+  }
+}
+
+// runs op for about a second of 4K frames, in GB/s of the source
+void Measure(const char* name,
+             CPlaneCopy::Kernel kernel,
+             size_t bytes,
+             const std::function<void()>& op)
+{
+  const int runs = 50;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++)
+    op();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cout << name << ", " << CPlaneCopy::GetName(kernel) << ": "
+            << elapsed.count() * 1000 / runs << " ms per plane, "
+            << static_cast<double>(bytes) * runs / elapsed.count() / 1e9 << " GB/s" << std::endl;
+}
+
+} // namespace
+
+TEST_F(TestPlaneCopy, Kernels)
+{
+  for (CPlaneCopy::Kernel kernel : KERNELS)
+  {
+    if (!CPlaneCopy::Supports(kernel))
+      continue;
+
+    for (const auto& size : SIZES)
+    {
+      CheckCopy(kernel, false, size[0], size[1], size[2], size[3]);
+      CheckCopy(kernel, true, size[0], size[1], size[2], size[3]);
+    }
+  }
+}
+
+TEST_F(TestPlaneCopy, Conversions)
+{
+  for (CPlaneCopy::Kernel kernel : KERNELS)
+  {
+    if (!CPlaneCopy::Supports(kernel))
+      continue;
+
+    for (const auto& size : SIZES)
+    {
+      CheckInterleave(kernel, size[0], size[1], size[2], size[3]);
+      CheckDeinterleave(kernel, size[0], size[1], size[2], size[3]);
+      CheckPackP010(kernel, size[0], size[1], size[2], size[3], 10);
+      CheckPackP010(kernel, size[0], size[1], size[2], size[3], 12);
+      CheckInterleaveP010(kernel, size[0], size[1], size[2], size[3], 10);
+    }
+  }
+}
+
+TEST_F(TestPlaneCopy, Dispatch)
+{
+  EXPECT_TRUE(CPlaneCopy::Supports(CPlaneCopy::GetKernel()));
+  CheckCopy(CPlaneCopy::GetKernel(), false, 3840, 300, 3840 + 64, 3840);
+}
+
+// benchmark of each kernel on the planes of a 4K frame, run with --gtest_also_run_disabled_tests
+TEST_F(TestPlaneCopy, DISABLED_Throughput)
+{
+  const int width = 3840;
+  const int height = 2160;
+  // 16 bit luma, the padding keeps the rows from being copied in one go
+  const int stride = width * 2 + 64;
+  std::vector<uint8_t> src(stride * height, 1);
+  std::vector<uint8_t> src2(stride * height, 2);
+  std::vector<uint8_t> dst(stride * height * 2, 0);
+  std::vector<uint8_t> dst2(stride * height, 0);
+
+  for (CPlaneCopy::Kernel kernel : KERNELS)
+  {
+    if (!CPlaneCopy::Supports(kernel))
+      continue;
+
+    Measure("copy 16 bit luma", kernel, width * 2 * height, [&]() {
+      CPlaneCopy::Copy(kernel, dst.data(), stride, src.data(), stride, width * 2, height);
+    });
+    // cached memory, only the overhead of the block
+    Measure("copy uncached 16 bit luma", kernel, width * 2 * height, [&]() {
+      CPlaneCopy::CopyUncached(kernel, dst.data(), stride, src.data(), stride, width * 2, height);
+    });
+    Measure("interleave 8 bit chroma", kernel, width * height / 2, [&]() {
+      CPlaneCopy::InterleaveUV(kernel, dst.data(), stride, src.data(), stride / 2, src2.data(),
+                               stride / 2, width / 2, height / 2);
+    });
+    Measure("deinterleave 8 bit chroma", kernel, width * height / 2, [&]() {
+      CPlaneCopy::DeinterleaveUV(kernel, dst.data(), stride / 2, dst2.data(), stride / 2,
+                                 src.data(), stride, width / 2, height / 2);
+    });
+    Measure("pack p010 luma", kernel, width * 2 * height, [&]() {
+      CPlaneCopy::PackP010(kernel, dst.data(), stride, src.data(), stride, width, height, 10);
+    });
+    Measure("interleave p010 chroma", kernel, width * height, [&]() {
+      CPlaneCopy::InterleaveP010(kernel, dst.data(), stride, src.data(), stride / 2, src2.data(),
+                                 stride / 2, width / 2, height / 2, 10);
+    });
+  }
+}
@@ -103,6 +103,10 @@ namespace VIDEO
 
       m_bCanInterrupt = true;
 
+      StartWalker(CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                  CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_moviesExcludeFromScanRegExps,
+                  false);
+
       CLog::Log(LOGINFO, "VideoInfoScanner: Starting scan ..");
       CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary,
                                                          "OnScanStarted");
@@ -137,10 +141,16 @@ namespace VIDEO
                     CURL::GetRedacted(directory), m_bClean ? " and clean" : "");
           m_pathsToScan.erase(m_pathsToScan.begin());
         }
-        else if (!DoScan(directory))
-          bCancelled = true;
+        else
+        {
+          if (!DoScan(directory))
+            bCancelled = true;
+          FinishDirectory(directory);
+        }
       }
 
+      StopWalker();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -155,6 +165,7 @@ namespace VIDEO
 
       CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().ResetLibraryBools();
       m_database.Close();
+      g_directoryCache.SavePersistent();
 
       auto end = std::chrono::steady_clock::now();
       auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -182,6 +193,7 @@ namespace VIDEO
     m_scanAll = scanAll;
     m_pathsToScan.clear();
     m_pathsToClean.clear();
+    m_fastHashes.clear();
 
     m_database.Open();
     if (strDirectory.empty())
@@ -287,7 +299,17 @@ namespace VIDEO
 
       std::string fastHash;
       if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
+      {
+        // WalkChangedFolders() of the parent may have hashed it already
+        const auto walked = m_fastHashes.find(strDirectory);
+        if (walked != m_fastHashes.end())
+        {
+          fastHash = walked->second;
+          m_fastHashes.erase(walked);
+        }
+        else
+          fastHash = GetFastHash(strDirectory, regexps);
+      }
 
       if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
       { // fast hashes match - no need to process anything
@@ -295,8 +317,7 @@ namespace VIDEO
       }
       else
       { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
+        GetScanDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
         items.Stack();
 
         // check whether to re-use previously computed fast hash
@@ -341,7 +362,7 @@ namespace VIDEO
       if (foundDirectly && !settings.parent_name_root)
       {
         CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
+                                 GetDirectoryFlags());
         items.SetPath(strDirectory);
         GetPathHash(items, hash);
         bSkip = true;
@@ -389,6 +410,10 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    // tv shows are listed recursively per show, only walk movie folders ahead
+    if (settings.recurse > 0 && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+      WalkChangedFolders(items, regexps);
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -404,11 +429,42 @@ namespace VIDEO
         {
           m_bStop = true;
         }
+        FinishDirectory(pItem->GetPath());
       }
     }
     return !m_bStop;
   }
 
+  void CVideoInfoScanner::WalkChangedFolders(const CFileItemList& items,
+                                             const std::vector<std::string>& regexps)
+  {
+    if (!IsWalking())
+      return;
+
+    const bool useFastHash =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash;
+    for (const auto& item : items)
+    {
+      // the same folders DoScan() recurses into
+      if (!item->m_bIsFolder || item->IsParentFolder() || item->IsPlayList() ||
+          CUtil::ExcludeFileOrFolder(item->GetPath(), regexps))
+        continue;
+
+      // folders with matching fast hashes are skipped without listing them
+      if (useFastHash && !URIUtils::IsPlugin(item->GetPath()))
+      {
+        std::string dbHash;
+        const std::string fastHash = GetFastHash(item->GetPath(), regexps);
+        m_fastHashes[item->GetPath()] = fastHash;
+        if (!fastHash.empty() && m_database.GetPathHash(item->GetPath(), dbHash) &&
+            StringUtils::EqualsNoCase(fastHash, dbHash))
+          continue;
+      }
+
+      WalkDirectory(item->GetPath());
+    }
+  }
+
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
     if (pDlgProgress)
@@ -884,7 +940,7 @@ namespace VIDEO
       // fast hash cannot be computed or we need to rescan. fetch the listing.
       if (!bSkip)
       {
-        int flags = DIR_FLAG_DEFAULTS;
+        int flags = GetDirectoryFlags();
         if (!hash.empty())
           flags |= DIR_FLAG_NO_FILE_INFO;
 
@@ -2007,7 +2063,9 @@ namespace VIDEO
   {
     CFileItemList items;
     items.Add(CFileItemPtr(new CFileItem(directory, true)));
-    CUtil::GetRecursiveDirsListing(directory, items, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
+    CUtil::GetRecursiveDirsListing(directory, items,
+                                   GetDirectoryFlags() | DIR_FLAG_NO_FILE_DIRS |
+                                       DIR_FLAG_NO_FILE_INFO);
 
     CDigest digest{CDigest::Type::MD5};
 
@@ -2018,11 +2076,16 @@ namespace VIDEO
     for (int i=0; i < items.Size(); ++i)
     {
       int64_t stat_time = 0;
+      int64_t mtime, ctime;
       struct __stat64 buffer;
-      if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
+      if (IDirectory::GetItemTimes(*items[i], mtime, ctime))
+      {
+        // the listing carried the times, no need for a round trip per folder
+        stat_time = mtime ? mtime : ctime;
+        time += stat_time;
+      }
+      else if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer, true) == 0)
       {
-        //! @todo some filesystems may return the mtime/ctime inline, in which case this is
-        //! unnecessarily expensive. Consider supporting Stat() in our directory cache?
         stat_time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
         time += stat_time;
       }
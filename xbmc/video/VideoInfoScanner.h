@@ -12,6 +12,7 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -108,6 +109,14 @@ namespace VIDEO
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
 
+    /*! \brief Start listing the subfolders DoScan() is going to fetch
+     Subfolders whose fast hash matches are skipped without a listing. The hashes
+     are kept for DoScan() of the subfolders.
+     \param items listing of the folder being scanned
+     \param regexps regular expressions of folders that are never scanned
+     */
+    void WalkChangedFolders(const CFileItemList& items, const std::vector<std::string>& regexps);
+
     INFO_RET RetrieveInfoForTvShow(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMovie(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
@@ -234,6 +243,7 @@ namespace VIDEO
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::map<std::string, std::string> m_fastHashes; //!< by WalkChangedFolders(), path -> fast hash
 
   private:
     static void AddLocalItemArtwork(CGUIListItem::ArtMap& itemArt,
@@ -13,6 +13,7 @@
 #include "ServiceBroker.h"
 #include "TextureCache.h"
 #include "Util.h"
+#include "cores/VideoPlayer/DVDThumbContext.h"
 #include "dialogs/GUIDialogContextMenu.h"
 #include "dialogs/GUIDialogKaiToast.h"
 #include "filesystem/File.h"
@@ -51,7 +52,7 @@ using namespace KODI::MESSAGING;
 
 CGUIDialogVideoBookmarks::CGUIDialogVideoBookmarks()
     : CGUIDialog(WINDOW_DIALOG_VIDEO_BOOKMARKS, "VideoOSDBookmarks.xml"),
-    CJobQueue(false, 1, CJob::PRIORITY_NORMAL)
+    CJobQueue(false, CDVDThumbContextPool::GetMaxJobs(), CJob::PRIORITY_NORMAL)
 {
   m_vecItems = new CFileItemList;
   m_loadType = LOAD_EVERY_TIME;
@@ -287,6 +288,7 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     {
       CFileItem item(m_filePath, false);
       CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
+      CSingleLock lock(m_jobsSection);
       AddJob(job);
       m_mapJobsChapter[job] = i;
       m_jobsStarted++;
@@ -467,7 +469,10 @@ void CGUIDialogVideoBookmarks::OnWindowLoaded()
   m_viewControl.SetParentWindow(GetID());
   m_viewControl.AddView(GetControl(CONTROL_THUMBS));
   m_jobsStarted = 0;
-  m_mapJobsChapter.clear();
+  {
+    CSingleLock lock(m_jobsSection);
+    m_mapJobsChapter.clear();
+  }
   m_vecItems->Clear();
 }
 
@@ -475,7 +480,10 @@ void CGUIDialogVideoBookmarks::OnWindowUnload()
 {
   //stop running thumb extraction jobs
   CancelJobs();
-  m_mapJobsChapter.clear();
+  {
+    CSingleLock lock(m_jobsSection);
+    m_mapJobsChapter.clear();
+  }
   m_vecItems->Clear();
   CGUIDialog::OnWindowUnload();
   m_viewControl.Reset();
@@ -565,13 +573,16 @@ void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
 {
   if (success && IsActive())
   {
+    CSingleLock lock(m_jobsSection);
     MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
     if (iter != m_mapJobsChapter.end())
     {
       unsigned int chapterIdx = (*iter).second;
+      m_mapJobsChapter.erase(iter);
+      lock.Leave();
+
       CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
       CApplicationMessenger::GetInstance().SendGUIMessage(m);
-      m_mapJobsChapter.erase(iter);
     }
   }
   CJobQueue::OnJobComplete(jobID, success, job);
@@ -72,5 +72,6 @@ private:
   int m_jobsStarted;
   std::string m_filePath;
   CCriticalSection m_refreshSection;
+  CCriticalSection m_jobsSection; // chapter images are extracted in parallel
   MAPJOBSCHAPS m_mapJobsChapter;
 };